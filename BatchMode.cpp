@@ -0,0 +1,325 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Converters/SMD_Structures.h"
+
+#include "Common/FileSystem.h"
+#include "Common/TaskScheduler.h"
+#include "Common/Trace.h"
+
+#include <algorithm>
+#include <ctype.h>
+
+// File queued for batch conversion
+struct BatchJob {
+  CPath strFile;       // Path to the file as it was found
+  Str_t strCanonical;  // Full path for matching files between each other
+  Str_t strExt;        // Lowercase file extension
+  u64 iSize;           // File size for scheduling bigger files first
+
+  Str_t strError; // Conversion error, if any
+  f64 fTime;      // Time it took to convert the file
+  bool bUpToDate; // Converted files were already up to date
+};
+
+// Batch conversion state shared between threads
+struct BatchState {
+  std::vector<BatchJob> aJobs;
+  Strings_t aArguments; // Converter arguments for every file
+
+  CMutex mxOutput;
+  s32 ctFinished;
+  s32 ctFailed;
+  s32 ctUpToDate;
+};
+
+// Get lowercase extension of the file
+static Str_t GetLowercaseExt(const CPath &strFile) {
+  Str_t strExt = strFile.GetFileExt();
+
+  for (size_t iChar = 0; iChar < strExt.size(); ++iChar) {
+    strExt[iChar] = (c8)tolower((u8)strExt[iChar]);
+  }
+
+  return strExt;
+};
+
+// Check if the file can be converted in batch mode
+static bool IsBatchFormat(const Str_t &strExt) {
+  return strExt == ".smd" || strExt == ".aaf" || strExt == ".asf" || strExt == ".as";
+};
+
+// Check if the converter option is followed by a value
+static bool OptionHasValue(const Str_t &strOption) {
+  return strOption == "-scale" || strOption == "-base" || strOption == "-basecache" || strOption == "-precision" || strOption == "-weld"
+      || strOption == "-reduce" || strOption == "-reducerot" || strOption == "-constbones"
+      || strOption == "-memlimit" || strOption == "-trace" || strOption == "-smdcachedir" || strOption == "-manifest" || strOption == "-memstats";
+};
+
+// Check if the SE1 skeleton has been produced by converting another file
+static bool IsConvertedSkeleton(const BatchJob &job) {
+  const Str_t strBase = job.strFile.RemoveExt();
+  FileInfo info;
+
+  return GetFileInfo(strBase + ".smd", info) || GetFileInfo(strBase + ".asf", info);
+};
+
+// Gather files to convert from the path, the directory or the wildcard pattern
+static void GatherFiles(const Str_t &strInput, Strings_t &aFiles) {
+  // Explicitly specified file
+  if (!HasWildcards(strInput) && !IsDirectory(strInput)) {
+    aFiles.push_back(strInput);
+    return;
+  }
+
+  Strings_t aFound;
+
+  if (HasWildcards(strInput)) {
+    ListWildcardFiles(strInput, aFound);
+  } else {
+    ListFiles(strInput, aFound, true);
+  }
+
+  std::sort(aFound.begin(), aFound.end());
+
+  for (size_t iFile = 0; iFile < aFound.size(); ++iFile) {
+    const CPath strFile = aFound[iFile];
+
+    // Skip configuration files like '!Base.smd'
+    if (strFile.RemoveDir().c_str()[0] == '!') {
+      continue;
+    }
+
+    aFiles.push_back(strFile);
+  }
+};
+
+// Convert one file from the batch
+static void ConvertBatchJob(s32 iJob, void *pData) {
+  BatchState &batch = *(BatchState *)pData;
+  BatchJob &job = batch.aJobs[iJob];
+
+  Strings_t aArguments = batch.aArguments;
+  const f64 fStart = GetTimeSeconds();
+
+  try {
+    job.bUpToDate = !ConvertFile(job.strFile, aArguments);
+
+  } catch (CException &ex) {
+    job.strError = ex.What();
+
+  } catch (std::exception &ex) {
+    job.strError = ex.what();
+  }
+
+  job.fTime = GetTimeSeconds() - fStart;
+
+  // Report progress
+  CMutexLock lock(batch.mxOutput);
+  batch.ctFinished++;
+
+  std::cout << '[' << batch.ctFinished << '/' << batch.aJobs.size() << "] " << job.strFile;
+
+  if (job.strError.empty() && job.bUpToDate) {
+    batch.ctUpToDate++;
+    std::cout << " (up to date)\n";
+
+  } else if (job.strError.empty()) {
+    std::cout << " (" << job.fTime << " s)\n";
+
+  } else {
+    batch.ctFailed++;
+    std::cout << "\n  Error: " << job.strError << '\n';
+  }
+};
+
+// Convert multiple files without any user input
+extern s32 ConvertBatch(const Strings_t &aArguments) {
+  TRACE_SCOPE("ConvertBatch");
+
+  _bBatchMode = true;
+
+  BatchState batch;
+  batch.ctFinished = 0;
+  batch.ctFailed = 0;
+  batch.ctUpToDate = 0;
+
+  s32 ctThreads = GetHardwareThreads();
+  Strings_t aInputs;
+
+  // Separate input files from the options
+  for (size_t iArg = 0; iArg < aArguments.size(); ++iArg) {
+    const Str_t &strArg = aArguments[iArg];
+
+    // Amount of threads for converting files
+    if (strArg == "-threads") {
+      if (++iArg < aArguments.size()) {
+        ctThreads = atoi(aArguments[iArg].c_str());
+
+        if (ctThreads < 1) {
+          ctThreads = 1;
+        }
+      }
+
+    // Converter option
+    } else if (strArg.size() > 1 && strArg[0] == '-') {
+      batch.aArguments.push_back(strArg);
+
+      if (OptionHasValue(strArg) && ++iArg < aArguments.size()) {
+        batch.aArguments.push_back(aArguments[iArg]);
+      }
+
+    // Input file, directory or a wildcard pattern
+    } else {
+      aInputs.push_back(strArg);
+    }
+  }
+
+  if (aInputs.empty()) {
+    std::cout << "Usage: -batch [options] <files, directories or wildcard patterns>\n";
+    return 1;
+  }
+
+  // Gather all files
+  Strings_t aFiles;
+
+  for (size_t iInput = 0; iInput < aInputs.size(); ++iInput) {
+    GatherFiles(aInputs[iInput], aFiles);
+  }
+
+  std::map<Str_t, s32> mapJobs;
+
+  for (size_t iFile = 0; iFile < aFiles.size(); ++iFile) {
+    BatchJob job;
+    job.strFile = aFiles[iFile];
+    job.strExt = GetLowercaseExt(job.strFile);
+    job.iSize = 0;
+    job.fTime = 0.0;
+    job.bUpToDate = false;
+
+    if (!IsBatchFormat(job.strExt)) {
+      continue;
+    }
+
+    // Skip SE1 skeletons that have been converted from other files
+    if (job.strExt == ".as" && IsConvertedSkeleton(job)) {
+      continue;
+    }
+
+    FileInfo info;
+
+    if (GetFileInfo(job.strFile, info)) {
+      job.iSize = info.iSize;
+    }
+
+    // Skip duplicates
+    job.strCanonical = GetCanonicalPath(job.strFile);
+
+    if (mapJobs.find(job.strCanonical) != mapJobs.end()) {
+      continue;
+    }
+
+    mapJobs[job.strCanonical] = (s32)batch.aJobs.size();
+    batch.aJobs.push_back(job);
+  }
+
+  const s32 ctJobs = (s32)batch.aJobs.size();
+
+  if (ctJobs == 0) {
+    std::cout << "No files to convert\n";
+    return 1;
+  }
+
+  // Resolve options for all SMD files in advance
+  CTaskScheduler scheduler;
+  Ints_t aiBaseJobs(ctJobs, -1);
+  Bits_t abBaseModel(ctJobs, false);
+
+  extern bool ReadConverterArguments(const CPath &strFile, Strings_t &aArguments);
+  extern void ParseSmdOptions(const Strings_t &aArguments, SmdOptions &opts);
+  extern Str_t GetBaseSmdPath(const CPath &strFile, const SmdOptions &opts);
+
+  s32 iJob;
+
+  for (iJob = 0; iJob < ctJobs; ++iJob) {
+    const BatchJob &job = batch.aJobs[iJob];
+    scheduler.AddTask(job.iSize);
+
+    if (job.strExt != ".smd") {
+      continue;
+    }
+
+    try {
+      Strings_t aJobArgs = batch.aArguments;
+      ReadConverterArguments(job.strFile, aJobArgs);
+
+      SmdOptions opts;
+      ParseSmdOptions(aJobArgs, opts);
+
+      // Find base model among the converted files
+      std::map<Str_t, s32>::const_iterator itBase = mapJobs.find(GetCanonicalPath(GetBaseSmdPath(job.strFile, opts)));
+
+      if (itBase != mapJobs.end() && itBase->second != iJob) {
+        aiBaseJobs[iJob] = itBase->second;
+        abBaseModel[itBase->second] = true;
+      }
+
+    // Errors will be reported during the conversion
+    } catch (CException &ex) {
+      (void)ex;
+    }
+  }
+
+  // Convert base models before animations that use them
+  for (iJob = 0; iJob < ctJobs; ++iJob) {
+    // Base models never wait for other models to avoid circular dependencies
+    if (aiBaseJobs[iJob] != -1 && !abBaseModel[iJob]) {
+      scheduler.AddDependency(iJob, aiBaseJobs[iJob]);
+    }
+  }
+
+  // Files are already converted in parallel, so only a single file can use all threads for its bone placements and envelopes
+  _ctBatchJobThreads = (ctJobs == 1 ? ctThreads : 1);
+
+  // Print resolved options
+  SmdOptions optsDefault;
+  ParseSmdOptions(batch.aArguments, optsDefault);
+
+  std::cout << "Converting " << ctJobs << " files on " << ctThreads << " threads\n";
+  std::cout << "  Scale: " << (optsDefault.bArgSet[0] ? optsDefault.fScale : 1.0/64.0) << '\n';
+  std::cout << "  Fix facing direction: " << ((optsDefault.bArgSet[1] ? optsDefault.bFixFaceDir : true) ? "yes" : "no") << '\n';
+  std::cout << "  Fix animation direction: " << ((optsDefault.bArgSet[2] ? optsDefault.bFixAnimNorth : true) ? "yes" : "no") << '\n';
+  std::cout << "  Base model: " << (optsDefault.bArgSet[3] ? optsDefault.strBaseSMD : Str_t("!Base.smd near each file")) << "\n\n";
+
+  const f64 fStart = GetTimeSeconds();
+  scheduler.Run(ctThreads, &ConvertBatchJob, &batch);
+
+  std::cout << "\nConverted " << (ctJobs - batch.ctFailed) << '/' << ctJobs << " files in " << (GetTimeSeconds() - fStart) << " s";
+
+  if (batch.ctUpToDate > 0) {
+    std::cout << " (" << batch.ctUpToDate << " already up to date)";
+  }
+
+  std::cout << '\n';
+
+  return (batch.ctFailed > 0 ? 1 : 0);
+};
@@ -0,0 +1,905 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Benchmark.h"
+#include "Converters/SMD_Structures.h"
+#include "Converters/SE1_Binary.h"
+
+#include "Common/FileSystem.h"
+#include "Common/InputFile.h"
+#include "Common/OutputFile.h"
+#include "Common/Platform.h"
+
+// Largest relative difference between numbers in ASCII files and single precision floats in binary files
+#define BINARY_TOLERANCE 1e-5
+
+// Reader of little-endian binary files
+class CBinaryReader {
+  public:
+    const u8 *pCur;
+    const u8 *pEnd;
+    Str_t strFile;
+
+  public:
+    CBinaryReader(const c8 *pchData, size_t iSize, const Str_t &strSetFile) :
+      pCur((const u8 *)pchData), pEnd((const u8 *)pchData + iSize), strFile(strSetFile)
+    {
+    };
+
+    // Make sure there's enough data left
+    inline const u8 *Require(size_t iSize) {
+      if ((size_t)(pEnd - pCur) < iSize) {
+        CMessageException::Throw("Unexpected end of file '%s'", strFile.c_str());
+      }
+
+      const u8 *p = pCur;
+      pCur += iSize;
+      return p;
+    };
+
+    inline u16 ReadShort(void) {
+      const u8 *p = Require(2);
+      return (u16)(p[0] | (p[1] << 8));
+    };
+
+    inline u32 ReadLong(void) {
+      const u8 *p = Require(4);
+      return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+    };
+
+    inline f64 ReadFloat(void) {
+      const u32 iBits = ReadLong();
+      f32 fSingle;
+      memcpy(&fSingle, &iBits, sizeof(fSingle));
+      return fSingle;
+    };
+
+    inline Str_t ReadString(void) {
+      const u32 iLength = ReadLong();
+      return Str_t((const c8 *)Require(iLength), iLength);
+    };
+
+    inline void ReadQuat(QuatD &q) {
+      q._w = ReadFloat();
+      q._x = ReadFloat();
+      q._y = ReadFloat();
+      q._z = ReadFloat();
+    };
+
+    // Check chunk ID and version
+    void ExpectHeader(const c8 *strID, u32 iVersion) {
+      if (memcmp(Require(4), strID, 4) != 0 || ReadLong() != iVersion) {
+        CMessageException::Throw("'%s' isn't a %s file of version %u", strFile.c_str(), strID, iVersion);
+      }
+    };
+
+    inline bool AtEnd(void) const {
+      return pCur == pEnd;
+    };
+};
+
+// Write binary mesh back in SE1 ASCII format
+static void DecodeMesh(CBinaryReader &bin, COutputFile &file) {
+  bin.ExpectHeader(SE1_MESH_ID, SE1_MESH_VERSION);
+
+  if (bin.ReadLong() != 1) {
+    CMessageException::Throw("Expected a single LOD");
+  }
+
+  bin.ReadString(); // Source file
+  bin.ReadFloat(); // Max distance
+  bin.ReadLong(); // Flags
+
+  const u32 ctVertices = bin.ReadLong();
+  file << "SE_MESH 0.1;\n\n";
+
+  // Positions and normals
+  for (s32 iArray = 0; iArray < 2; ++iArray) {
+    file << (iArray == 0 ? "VERTICES " : "}\n\nNORMALS ") << ctVertices << "\n{\n";
+
+    for (u32 iVertex = 0; iVertex < ctVertices; ++iVertex) {
+      const f64 fX = bin.ReadFloat();
+      const f64 fY = bin.ReadFloat();
+      const f64 fZ = bin.ReadFloat();
+      bin.ReadLong(); // Alignment
+
+      file << "  " << fX << ", " << fY << ", " << fZ << ";\n";
+    }
+  }
+
+  file << "}\n\n";
+
+  // UV maps
+  const u32 ctMaps = bin.ReadLong();
+  file << "UVMAPS " << ctMaps << "\n{\n";
+
+  for (u32 iMap = 0; iMap < ctMaps; ++iMap) {
+    file << "  {\n";
+    file << "    NAME \"" << bin.ReadString() << "\";\n";
+    file << "    TEXCOORDS " << ctVertices << "\n    {\n";
+
+    for (u32 iTexCoord = 0; iTexCoord < ctVertices; ++iTexCoord) {
+      const f64 fU = bin.ReadFloat();
+      const f64 fV = bin.ReadFloat();
+      file << "      " << fU << ", " << fV << ";\n";
+    }
+
+    file << "    }\n";
+    file << "  }\n";
+  }
+
+  file << "}\n\n";
+
+  // Surfaces
+  const u32 ctSurfaces = bin.ReadLong();
+  file << "SURFACES " << ctSurfaces << "\n{\n";
+
+  for (u32 iSurface = 0; iSurface < ctSurfaces; ++iSurface) {
+    file << "  {\n";
+    file << "    NAME \"" << bin.ReadString() << "\";\n";
+
+    const u32 iFirstVertex = bin.ReadLong();
+    const u32 ctSurfaceVertices = bin.ReadLong();
+    const u32 ctTriangles = bin.ReadLong();
+
+    file << "    TRIANGLE_SET " << ctTriangles << "\n    {\n";
+
+    for (u32 iTriangle = 0; iTriangle < ctTriangles; ++iTriangle) {
+      u32 aiCorners[3];
+
+      for (s32 iCorner = 0; iCorner < 3; ++iCorner) {
+        aiCorners[iCorner] = bin.ReadLong();
+
+        if (aiCorners[iCorner] < iFirstVertex || aiCorners[iCorner] >= iFirstVertex + ctSurfaceVertices) {
+          CMessageException::Throw("Triangle vertex %u is outside of its surface", aiCorners[iCorner]);
+        }
+      }
+
+      file << "      " << aiCorners[0] << ", " << aiCorners[1] << ", " << aiCorners[2] << ";\n";
+    }
+
+    file << "    }\n";
+    file << "  }\n";
+
+    if (bin.ReadLong() != 0) {
+      CMessageException::Throw("Expected surfaces without shaders");
+    }
+  }
+
+  file << "}\n\n";
+
+  // Vertex weights
+  const u32 ctWeightMaps = bin.ReadLong();
+  file << "WEIGHTS " << ctWeightMaps << "\n{\n";
+
+  for (u32 iWeightMap = 0; iWeightMap < ctWeightMaps; ++iWeightMap) {
+    file << "  {\n";
+    file << "    NAME \"" << bin.ReadString() << "\";\n";
+
+    const u32 ctWeights = bin.ReadLong();
+    file << "    WEIGHT_SET " << ctWeights << '\n';
+    file << "    {\n";
+
+    for (u32 iWeight = 0; iWeight < ctWeights; ++iWeight) {
+      const u32 iVertex = bin.ReadLong();
+      file << "      { " << iVertex << "; " << bin.ReadFloat() << "; }\n";
+    }
+
+    file << "    }\n";
+    file << "  }\n";
+  }
+
+  file << "}\n\n";
+
+  file << "MORPHS " << bin.ReadLong() << "\n{\n}\n\n";
+  file << "SE_MESH_END;";
+};
+
+// Write binary skeleton back in SE1 ASCII format and count bones whose absolute placement doesn't match the relative one
+static s32 DecodeSkeleton(CBinaryReader &bin, COutputFile &file) {
+  bin.ExpectHeader(SE1_SKELETON_ID, SE1_SKELETON_VERSION);
+
+  if (bin.ReadLong() != 1) {
+    CMessageException::Throw("Expected a single LOD");
+  }
+
+  bin.ReadString(); // Source file
+  bin.ReadFloat(); // Max distance
+
+  const u32 ctBones = bin.ReadLong();
+  std::map<Str_t, Mat12D> mapAbsolute;
+  s32 ctMismatches = 0;
+
+  file << "SE_SKELETON 0.1;\n\n";
+  file << "BONES " << ctBones << "\n{\n";
+
+  for (u32 iBone = 0; iBone < ctBones; ++iBone) {
+    const Str_t strName = bin.ReadString();
+    const Str_t strParent = bin.ReadString();
+
+    Mat12D mAbsolute;
+
+    for (s32 i = 0; i < 12; ++i) {
+      mAbsolute(i / 4, i % 4) = bin.ReadFloat();
+    }
+
+    Vec3D vOffset;
+    vOffset[0] = bin.ReadFloat();
+    vOffset[1] = bin.ReadFloat();
+    vOffset[2] = bin.ReadFloat();
+
+    QuatD q;
+    bin.ReadQuat(q);
+
+    bin.ReadFloat(); // Offset length
+    const f64 fLength = bin.ReadFloat();
+
+    Mat12D mRelative;
+    QuatToPlacement(q, vOffset, mRelative);
+
+    // Parents must come before their children
+    Mat12D mExpected = mRelative;
+
+    if (strParent != "") {
+      std::map<Str_t, Mat12D>::const_iterator it = mapAbsolute.find(strParent);
+
+      if (it == mapAbsolute.end()) {
+        CMessageException::Throw("Parent of bone '%s' comes after it", strName.c_str());
+      }
+
+      CombinePlacements(it->second, mRelative, mExpected);
+    }
+
+    for (s32 i = 0; i < 12; ++i) {
+      const f64 fExpected = mExpected(i / 4, i % 4);
+      const f64 fLimit = BINARY_TOLERANCE * (fabs(fExpected) > 1.0 ? fabs(fExpected) : 1.0);
+
+      if (fabs(mAbsolute(i / 4, i % 4) - fExpected) > fLimit) {
+        ++ctMismatches;
+        break;
+      }
+    }
+
+    mapAbsolute[strName] = mAbsolute;
+
+    file << "  NAME \"" << strName << "\";\n";
+    file << "  PARENT \"" << strParent << "\";\n";
+    file << "  LENGTH " << fLength << ";\n";
+    file << "  {\n    ";
+    PrintPlacement(mRelative, file);
+    file << "\n  }\n";
+  }
+
+  file << "}\n\n";
+  file << "SE_SKELETON_END;\n";
+
+  return ctMismatches;
+};
+
+// Write binary animation back in SE1 ASCII format
+static void DecodeAnimation(CBinaryReader &bin, COutputFile &file) {
+  bin.ExpectHeader(SE1_ANIMSET_ID, SE1_ANIMSET_VERSION);
+
+  if (bin.ReadLong() != 1) {
+    CMessageException::Throw("Expected a single animation");
+  }
+
+  bin.ReadString(); // Source file
+  const Str_t strName = bin.ReadString();
+  const f64 fSecPerFrame = bin.ReadFloat();
+  const u32 ctFrames = bin.ReadLong();
+
+  bin.ReadFloat(); // Compression threshold
+
+  if (bin.ReadLong() != 0) {
+    CMessageException::Throw("Expected an uncompressed animation");
+  }
+
+  bin.ReadLong(); // Custom speed
+
+  file << "SE_ANIM 0.1;\n\n";
+  file << "SEC_PER_FRAME " << fSecPerFrame << ";\n";
+  file << "FRAMES " << ctFrames << ";\n";
+  file << "ANIM_ID \"" << strName << "\";\n\n";
+
+  const u32 ctEnvelopes = bin.ReadLong();
+  file << "BONEENVELOPES " << ctEnvelopes << "\n{\n";
+
+  std::vector<Vec3D> avPos;
+
+  for (u32 iEnvelope = 0; iEnvelope < ctEnvelopes; ++iEnvelope) {
+    file << "  NAME \"" << bin.ReadString() << "\"\n";
+
+    Mat12D mDefault;
+
+    for (s32 i = 0; i < 12; ++i) {
+      mDefault(i / 4, i % 4) = bin.ReadFloat();
+    }
+
+    file << "  DEFAULT_POSE { ";
+    PrintPlacement(mDefault, file);
+    file << " }\n";
+
+    // Positions
+    const u32 ctPositions = bin.ReadLong();
+    avPos.resize(ctPositions);
+
+    for (u32 iPos = 0; iPos < ctPositions; ++iPos) {
+      if (bin.ReadShort() != iPos) {
+        CMessageException::Throw("Expected a position in every frame");
+      }
+
+      bin.ReadShort(); // Alignment
+      avPos[iPos][0] = bin.ReadFloat();
+      avPos[iPos][1] = bin.ReadFloat();
+      avPos[iPos][2] = bin.ReadFloat();
+    }
+
+    // Rotations
+    if (bin.ReadLong() != ctPositions) {
+      CMessageException::Throw("Expected the same amount of positions and rotations");
+    }
+
+    file << "  {";
+
+    for (u32 iRot = 0; iRot < ctPositions; ++iRot) {
+      if (bin.ReadShort() != iRot) {
+        CMessageException::Throw("Expected a rotation in every frame");
+      }
+
+      bin.ReadShort(); // Alignment
+
+      QuatD q;
+      bin.ReadQuat(q);
+
+      Mat12D mPlacement;
+      QuatToPlacement(q, avPos[iRot], mPlacement);
+
+      file << "\n    ";
+      PrintPlacement(mPlacement, file);
+    }
+
+    file << "\n  }\n";
+
+    bin.ReadFloat(); // Offset length
+  }
+
+  file << "}\n\n";
+  file << "MORPHENVELOPES " << bin.ReadLong() << "\n{\n}\n\n";
+  file << "SE_ANIM_END;\n";
+};
+
+// Compare two texts with numbers that may differ slightly (returns line of the first difference or 0 if they match)
+static s32 CompareConvertedText(const Str_t &strExpected, const Str_t &strDecoded) {
+  const c8 *pchA = strExpected.c_str();
+  const c8 *pchB = strDecoded.c_str();
+  s32 iLine = 1;
+
+  while (*pchA != '\0' && *pchB != '\0') {
+    const bool bNumberA = (isdigit((u8)*pchA) || (*pchA == '-' && isdigit((u8)pchA[1])));
+    const bool bNumberB = (isdigit((u8)*pchB) || (*pchB == '-' && isdigit((u8)pchB[1])));
+
+    if (bNumberA && bNumberB) {
+      c8 *pchEndA;
+      c8 *pchEndB;
+      const f64 fA = strtod(pchA, &pchEndA);
+      const f64 fB = strtod(pchB, &pchEndB);
+
+      if (fabs(fA - fB) > BINARY_TOLERANCE * (fabs(fA) > 1.0 ? fabs(fA) : 1.0)) {
+        return iLine;
+      }
+
+      pchA = pchEndA;
+      pchB = pchEndB;
+      continue;
+    }
+
+    if (*pchA != *pchB) {
+      return iLine;
+    }
+
+    iLine += (*pchA == '\n');
+    ++pchA;
+    ++pchB;
+  }
+
+  return (*pchA == *pchB ? 0 : iLine);
+};
+
+// Read whole file into a string
+static void ReadFileText(const Str_t &strFile, Str_t &strText) {
+  CInputFile file;
+  file.Open(strFile);
+  strText.assign(file.GetData(), file.GetSize());
+};
+
+// Decode binary file into ASCII text next to it and compare it with the ASCII file
+static bool CheckBinaryFile(const Str_t &strBinary, const Str_t &strAscii) {
+  CInputFile fileIn;
+  fileIn.Open(strBinary);
+
+  CBinaryReader bin(fileIn.GetData(), fileIn.GetSize(), strBinary);
+  const Str_t strDecoded = strBinary + ".txt";
+  s32 ctMismatches = 0;
+
+  COutputFile fileOut;
+  fileOut.Open(strDecoded);
+
+  const Str_t strExt = CPath(strBinary).GetFileExt();
+
+  if (strExt == ".bm") {
+    DecodeMesh(bin, fileOut);
+  } else if (strExt == ".bs") {
+    ctMismatches = DecodeSkeleton(bin, fileOut);
+  } else {
+    DecodeAnimation(bin, fileOut);
+  }
+
+  fileOut.Close();
+
+  if (!bin.AtEnd()) {
+    CMessageException::Throw("Unexpected data at the end of '%s'", strBinary.c_str());
+  }
+
+  Str_t strExpected, strText;
+  ReadFileText(strAscii, strExpected);
+  ReadFileText(strDecoded, strText);
+
+  const s32 iLine = CompareConvertedText(strExpected, strText);
+
+  FileInfo infoAscii, infoBinary;
+  infoAscii.iSize = infoBinary.iSize = 0;
+  GetFileInfo(strAscii, infoAscii);
+  GetFileInfo(strBinary, infoBinary);
+
+  printf("  %-22s %10llu bytes (ASCII %10llu)  ", CPath(strBinary).RemoveDir().c_str(),
+    (unsigned long long)infoBinary.iSize, (unsigned long long)infoAscii.iSize);
+
+  if (iLine != 0) {
+    printf("DIFFERENT from %s at line %d\n", CPath(strAscii).RemoveDir().c_str(), iLine);
+    return false;
+  }
+
+  if (ctMismatches != 0) {
+    printf("%d absolute placements DIFFERENT from relative ones\n", ctMismatches);
+    return false;
+  }
+
+  printf("same as ASCII\n");
+  return true;
+};
+
+// Checker of binary files against their layouts listed field by field
+class CLayoutChecker {
+  public:
+    CBinaryReader bin;
+    const u8 *pStart;
+
+  public:
+    CLayoutChecker(const c8 *pchData, size_t iSize, const Str_t &strFile) :
+      bin(pchData, iSize, strFile), pStart((const u8 *)pchData)
+    {
+    };
+
+    // Offset of the field that has just been read
+    inline u32 FieldOffset(const u8 *pField) const {
+      return (u32)(pField - pStart);
+    };
+
+    void ID(const c8 *strField, const c8 *strExpected) {
+      const u8 *pField = bin.pCur;
+      const Str_t strID((const c8 *)bin.Require(4), 4);
+
+      if (strID != strExpected) {
+        CMessageException::Throw("%s at offset %u is '%s' instead of '%s'", strField, FieldOffset(pField), strID.c_str(), strExpected);
+      }
+    };
+
+    void Long(const c8 *strField, u32 iExpected) {
+      const u8 *pField = bin.pCur;
+      const u32 iValue = bin.ReadLong();
+
+      if (iValue != iExpected) {
+        CMessageException::Throw("%s at offset %u is %u instead of %u", strField, FieldOffset(pField), iValue, iExpected);
+      }
+    };
+
+    void Short(const c8 *strField, u16 iExpected) {
+      const u8 *pField = bin.pCur;
+      const u16 iValue = bin.ReadShort();
+
+      if (iValue != iExpected) {
+        CMessageException::Throw("%s at offset %u is %u instead of %u", strField, FieldOffset(pField), (u32)iValue, (u32)iExpected);
+      }
+    };
+
+    void Float(const c8 *strField, f64 fExpected) {
+      const u8 *pField = bin.pCur;
+      const f64 fValue = bin.ReadFloat();
+      const f64 fScale = (fabs(fExpected) > 1.0 ? fabs(fExpected) : 1.0);
+
+      if (fabs(fValue - fExpected) > BINARY_TOLERANCE * fScale) {
+        CMessageException::Throw("%s at offset %u is %g instead of %g", strField, FieldOffset(pField), fValue, fExpected);
+      }
+    };
+
+    void String(const c8 *strField, const Str_t &strExpected) {
+      const u8 *pField = bin.pCur;
+      const Str_t strValue = bin.ReadString();
+
+      if (strValue != strExpected) {
+        CMessageException::Throw("%s at offset %u is \"%s\" instead of \"%s\"", strField, FieldOffset(pField), strValue.c_str(), strExpected.c_str());
+      }
+    };
+
+    void Vector(const c8 *strField, f64 fX, f64 fY, f64 fZ) {
+      Float(strField, fX);
+      Float(strField, fY);
+      Float(strField, fZ);
+    };
+
+    // Placement as a 3x4 matrix
+    void Placement(const c8 *strField, const f64 *afExpected) {
+      for (s32 i = 0; i < 12; ++i) {
+        Float(strField, afExpected[i]);
+      }
+    };
+
+    // Vector with an alignment value after it
+    void AlignedVector(const c8 *strField, f64 fX, f64 fY, f64 fZ) {
+      Vector(strField, fX, fY, fZ);
+      Long(strField, 0);
+    };
+
+    // Rotation quaternion in the (W, X, Y, Z) order
+    void Quat(const c8 *strField, f64 fW, f64 fX, f64 fY, f64 fZ) {
+      Float(strField, fW);
+      Float(strField, fX);
+      Float(strField, fY);
+      Float(strField, fZ);
+    };
+
+    void End(void) {
+      if (!bin.AtEnd()) {
+        CMessageException::Throw("Unexpected data at offset %u", (u32)(bin.pCur - pStart));
+      }
+    };
+};
+
+// Reference model for checking binary layouts with values that are easy to verify by hand
+// (second bone is rotated by 90 degrees around X in the default pose and moves in two animation frames)
+static const c8 *_strLayoutSmd =
+  "version 1\n"
+  "nodes\n"
+  "0 \"Root\" -1\n"
+  "1 \"Tip\" 0\n"
+  "end\n"
+  "skeleton\n"
+  "time 0\n"
+  "0 0 0 0 0 0 0\n"
+  "1 1 2 3 1.5707963267948966 0 0\n"
+  "time 1\n"
+  "0 0 0 0 0 0 0\n"
+  "1 2 4 6 0 0 0\n"
+  "time 2\n"
+  "0 0 0 0 0 0 0\n"
+  "1 3 6 9 0 0 0\n"
+  "end\n"
+  "triangles\n"
+  "Skin\n"
+  "0 0 0 0 0 0 1 0 0 1 1 1\n"
+  "1 1 0 0 0 0 1 1 0 1 1 1\n"
+  "1 0 1 0 0 0 1 0 1 2 0 0.5 1 0.5\n"
+  "end\n";
+
+// Expected placements of the reference model
+static const f64 _afLayoutIdentity[12] = { 1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0 };
+static const f64 _afLayoutTipPose[12] = { 1, 0, 0, 1,  0, 0, -1, 2,  0, 1, 0, 3 };
+static const f64 _fLayoutSqrtHalf = 0.70710678118654752;
+
+// Mesh layout in the order of SE1 CMesh::Read_t()
+static void CheckMeshLayout(CLayoutChecker &check) {
+  check.ID("Mesh ID", "MESH");
+  check.Long("Mesh version", 16);
+  check.Long("LOD count", 1);
+
+  check.String("LOD source file", "Layout.am");
+  check.Float("LOD max distance", -1.0);
+  check.Long("LOD flags", 0);
+
+  check.Long("Vertex count", 3);
+  check.AlignedVector("Vertex 0", 0, 0, 0);
+  check.AlignedVector("Vertex 1", 1, 0, 0);
+  check.AlignedVector("Vertex 2", 0, 1, 0);
+
+  check.AlignedVector("Normal 0", 0, 0, 1);
+  check.AlignedVector("Normal 1", 0, 0, 1);
+  check.AlignedVector("Normal 2", 0, 0, 1);
+
+  // Texture coordinates are mirrored vertically
+  check.Long("UV map count", 1);
+  check.String("UV map name", "Layout");
+  check.Float("UV 0", 0);
+  check.Float("UV 0", 1);
+  check.Float("UV 1", 1);
+  check.Float("UV 1", 1);
+  check.Float("UV 2", 0);
+  check.Float("UV 2", 0);
+
+  check.Long("Surface count", 1);
+  check.String("Surface name", "Skin");
+  check.Long("Surface first vertex", 0);
+  check.Long("Surface vertex count", 3);
+  check.Long("Surface triangle count", 1);
+  check.Long("Triangle", 0);
+  check.Long("Triangle", 1);
+  check.Long("Triangle", 2);
+  check.Long("Surface shader", 0);
+
+  check.Long("Weight map count", 2);
+  check.String("Weight map name", "Root");
+  check.Long("Weight count", 1);
+  check.Long("Weight vertex", 2);
+  check.Float("Weight", 0.5);
+
+  check.String("Weight map name", "Tip");
+  check.Long("Weight count", 3);
+  check.Long("Weight vertex", 0);
+  check.Float("Weight", 1.0);
+  check.Long("Weight vertex", 1);
+  check.Float("Weight", 1.0);
+  check.Long("Weight vertex", 2);
+  check.Float("Weight", 0.5);
+
+  check.Long("Morph map count", 0);
+  check.End();
+};
+
+// Skeleton layout in the order of SE1 CSkeleton::Read_t()
+static void CheckSkeletonLayout(CLayoutChecker &check) {
+  check.ID("Skeleton ID", "SKEL");
+  check.Long("Skeleton version", 6);
+  check.Long("LOD count", 1);
+
+  check.String("LOD source file", "Layout.as");
+  check.Float("LOD max distance", -1.0);
+  check.Long("Bone count", 2);
+
+  check.String("Bone name", "Root");
+  check.String("Bone parent", "");
+  check.Placement("Bone absolute placement", _afLayoutIdentity);
+  check.Vector("Bone offset", 0, 0, 0);
+  check.Quat("Bone rotation", 1, 0, 0, 0);
+  check.Float("Bone offset length", 0);
+  check.Float("Bone length", 8);
+
+  check.String("Bone name", "Tip");
+  check.String("Bone parent", "Root");
+  check.Placement("Bone absolute placement", _afLayoutTipPose);
+  check.Vector("Bone offset", 1, 2, 3);
+  check.Quat("Bone rotation", _fLayoutSqrtHalf, _fLayoutSqrtHalf, 0, 0);
+  check.Float("Bone offset length", sqrt(14.0));
+  check.Float("Bone length", 8);
+
+  check.End();
+};
+
+// Animation set layout in the order of SE1 CAnimSet::Read_t()
+static void CheckAnimationLayout(CLayoutChecker &check) {
+  check.ID("Animation set ID", "ANIM");
+  check.Long("Animation set version", 14);
+  check.Long("Animation count", 1);
+
+  check.String("Animation source file", "Layout.aa");
+  check.String("Animation ID", "Default");
+  check.Float("Seconds per frame", 1.0 / 24.0);
+  check.Long("Frame count", 2);
+  check.Float("Compression threshold", 0);
+  check.Long("Compressed", 0);
+  check.Long("Custom speed", 0);
+  check.Long("Bone envelope count", 2);
+
+  // Positions and rotations of the first bone stay the same
+  check.String("Envelope name", "Root");
+  check.Placement("Envelope default pose", _afLayoutIdentity);
+  check.Long("Position count", 2);
+
+  for (u16 iFrame = 0; iFrame < 2; ++iFrame) {
+    check.Short("Position frame", iFrame);
+    check.Short("Position padding", 0);
+    check.Vector("Position", 0, 0, 0);
+  }
+
+  check.Long("Rotation count", 2);
+
+  for (u16 iFrame = 0; iFrame < 2; ++iFrame) {
+    check.Short("Rotation frame", iFrame);
+    check.Short("Rotation padding", 0);
+    check.Quat("Rotation", 1, 0, 0, 0);
+  }
+
+  check.Float("Envelope offset length", 0);
+
+  // Second bone moves without a rotation
+  check.String("Envelope name", "Tip");
+  check.Placement("Envelope default pose", _afLayoutTipPose);
+  check.Long("Position count", 2);
+
+  for (u16 iFrame = 0; iFrame < 2; ++iFrame) {
+    const f64 fStep = iFrame + 2.0;
+    check.Short("Position frame", iFrame);
+    check.Short("Position padding", 0);
+    check.Vector("Position", fStep, fStep * 2.0, fStep * 3.0);
+  }
+
+  check.Long("Rotation count", 2);
+
+  for (u16 iFrame = 0; iFrame < 2; ++iFrame) {
+    check.Short("Rotation frame", iFrame);
+    check.Short("Rotation padding", 0);
+    check.Quat("Rotation", 1, 0, 0, 0);
+  }
+
+  check.Float("Envelope offset length", sqrt(14.0));
+
+  check.Long("Morph envelope count", 0);
+  check.End();
+};
+
+// Convert the reference model into binary files and check them against the layouts expected by SE1
+static bool CheckBinaryLayouts(const Str_t &strDir) {
+  if (!MakeDirectory(strDir)) {
+    CMessageException::Throw("Cannot create directory '%s'", strDir.c_str());
+  }
+
+  const Str_t strBase = strDir + "/Layout";
+
+  COutputFile fileSmd;
+  fileSmd.Open(strBase + ".smd");
+  fileSmd << _strLayoutSmd;
+  fileSmd.Close();
+
+  // Keep the model as it is
+  Strings_t aArgs;
+  aArgs.push_back("-scale");
+  aArgs.push_back("1");
+  aArgs.push_back("-keepdir");
+  aArgs.push_back("-keepanim");
+  aArgs.push_back("-noweld");
+  aArgs.push_back("-binaryonly");
+
+  ConvertFile(strBase + ".smd", aArgs);
+
+  const c8 *astrExt[3] = { ".bm", ".bs", ".ba" };
+  void (*apCheck[3])(CLayoutChecker &) = { &CheckMeshLayout, &CheckSkeletonLayout, &CheckAnimationLayout };
+  bool bSame = true;
+
+  for (s32 iFile = 0; iFile < 3; ++iFile) {
+    const Str_t strFile = strBase + astrExt[iFile];
+    printf("  %-22s ", CPath(strFile).RemoveDir().c_str());
+
+    CInputFile file;
+    file.Open(strFile);
+
+    try {
+      CLayoutChecker check(file.GetData(), file.GetSize(), strFile);
+      apCheck[iFile](check);
+
+    } catch (CException &ex) {
+      printf("DIFFERENT from the SE1 layout: %s\n", ex.What());
+      bSame = false;
+      continue;
+    }
+
+    printf("same as the SE1 layout\n");
+  }
+
+  return bSame;
+};
+
+// Convert SMD file into the chosen formats and return the fastest time
+static f64 MeasureFormat(const Str_t &strFile, const Strings_t &aArguments) {
+  f64 fBest = -1.0;
+
+  for (s32 iRepeat = 0; iRepeat < 3; ++iRepeat) {
+    Strings_t aFileArgs = aArguments;
+    const f64 fStart = GetTimeSeconds();
+
+    ConvertFile(strFile, aFileArgs);
+
+    const f64 fTime = GetTimeSeconds() - fStart;
+    fBest = (fBest < 0.0 || fTime < fBest ? fTime : fBest);
+  }
+
+  return fBest;
+};
+
+// Compare speed of writing SE1 ASCII and binary files and check that binary files decode into the same ASCII files
+extern s32 RunBinaryBenchmark(s32 ctFrames) {
+  BenchCorpus corpus;
+  corpus.ctFrames = ctFrames;
+
+  const Str_t strDir = "BenchBinary";
+  const Str_t strMesh = strDir + "/" + BENCH_MESH_SMD;
+  const Str_t strAnim = strDir + "/" + BENCH_ANIM_SMD;
+
+  // Mute converter messages and prompts
+  _bBatchMode = true;
+  bool bSame = true;
+
+  try {
+    GenerateBenchCorpus(strDir, corpus);
+
+    printf("Checking binary layouts of a reference model\n");
+    bSame &= CheckBinaryLayouts(strDir);
+
+    Strings_t aArgs;
+    aArgs.push_back("-base");
+    aArgs.push_back(strMesh);
+
+    Strings_t aBinaryArgs = aArgs;
+    aBinaryArgs.push_back("-binaryonly");
+
+    printf("Converting %d bones, %d frames and %d triangles\n", corpus.ctBones, corpus.ctFrames, corpus.ctTriangles);
+
+    const c8 *astrFiles[2] = { BENCH_MESH_SMD, BENCH_ANIM_SMD };
+
+    for (s32 iFile = 0; iFile < 2; ++iFile) {
+      const Str_t strFile = strDir + "/" + astrFiles[iFile];
+      const f64 fAscii = MeasureFormat(strFile, aArgs);
+      const f64 fBinary = MeasureFormat(strFile, aBinaryArgs);
+
+      printf("  %-22s ASCII %8.2f ms  binary %8.2f ms\n", astrFiles[iFile], fAscii * 1000.0, fBinary * 1000.0);
+    }
+
+    const Str_t strMeshBase = CPath(strMesh).RemoveExt();
+    const Str_t strAnimBase = CPath(strAnim).RemoveExt();
+
+    bSame &= CheckBinaryFile(strMeshBase + ".bm", strMeshBase + ".am");
+    bSame &= CheckBinaryFile(strMeshBase + ".bs", strMeshBase + ".as");
+    bSame &= CheckBinaryFile(strMeshBase + ".ba", strMeshBase + ".aa");
+    bSame &= CheckBinaryFile(strAnimBase + ".ba", strAnimBase + ".aa");
+
+  } catch (CException &ex) {
+    std::cout << "Error: " << ex.What() << '\n';
+    return 1;
+  }
+
+  return !bSame;
+};
+
+// Check binary files of the reference model against the layouts expected by SE1 without measuring anything
+extern s32 RunBinaryLayoutCheck(void) {
+  // Mute converter messages and prompts
+  _bBatchMode = true;
+  bool bSame;
+
+  try {
+    bSame = CheckBinaryLayouts("BenchBinary");
+
+  } catch (CException &ex) {
+    std::cout << "Error: " << ex.What() << '\n';
+    return 1;
+  }
+
+  return !bSame;
+};
@@ -0,0 +1,596 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Benchmark.h"
+
+#include "Common/FileSystem.h"
+#include "Common/OutputFile.h"
+#include "Common/Platform.h"
+
+// Measure peak memory from the current usage onwards (if the system supports it)
+static void ResetPeakMemory(void) {
+#ifndef _WIN32
+  // Resets VmHWM to the current usage on Linux
+  FILE *file = fopen("/proc/self/clear_refs", "w");
+
+  if (file != nullptr) {
+    fputs("5", file);
+    fclose(file);
+  }
+#endif
+};
+
+// Default placement of a generated bone
+struct BenchBone {
+  s32 iParent;
+  Vec3D vPos;
+  Vec3D vRot;
+};
+
+// Write a number with fixed precision like in SMD files
+static void WriteFixed(COutputFile &file, f64 fValue) {
+  c8 strNumber[64];
+  file.Write(strNumber, sprintf(strNumber, "%.6f", fValue));
+};
+
+// Write a number with 6 significant digits like in converted files
+static void WriteDigits(COutputFile &file, f64 fValue) {
+  c8 strNumber[FLOAT_TEXT_LENGTH];
+  file.Write(strNumber, FormatDouble(strNumber, fValue, 6));
+};
+
+// Generate bone hierarchy with default placements (parents always come before their children)
+static void GenerateBones(CBenchRandom &rnd, s32 ctBones, std::vector<BenchBone> &aBones) {
+  aBones.resize(ctBones);
+
+  for (s32 iBone = 0; iBone < ctBones; ++iBone) {
+    BenchBone &bone = aBones[iBone];
+    bone.iParent = (iBone == 0 ? -1 : (s32)(rnd.Next() % iBone));
+
+    for (s32 i = 0; i < 3; ++i) {
+      bone.vPos[i] = (rnd.Unit() - 0.5) * 20.0;
+      bone.vRot[i] = (rnd.Unit() - 0.5) * 2.0 * 3.14159265358979323846;
+    }
+  }
+};
+
+// Write skeleton block of an SMD file
+static void WriteSmdNodes(COutputFile &file, const std::vector<BenchBone> &aBones) {
+  file << "version 1\nnodes\n";
+
+  for (size_t iBone = 0; iBone < aBones.size(); ++iBone) {
+    file << (u32)iBone << " \"Bone" << (u32)iBone << "\" " << aBones[iBone].iParent << '\n';
+  }
+
+  file << "end\nskeleton\n";
+};
+
+// Write one XYZHPB placement of an SMD bone
+static void WriteSmdPlacement(COutputFile &file, s32 iBone, const Vec3D &vPos, const Vec3D &vRot) {
+  file << "  " << iBone;
+
+  for (s32 i = 0; i < 3; ++i) {
+    file << ' ';
+    WriteFixed(file, vPos[i]);
+  }
+
+  for (s32 i = 0; i < 3; ++i) {
+    file << ' ';
+    WriteFixed(file, vRot[i]);
+  }
+
+  file << '\n';
+};
+
+// Placement of the animated bone in a certain frame
+static void GetAnimatedPlacement(const BenchBone &bone, s32 iBone, s32 iFrame, Vec3D &vPos, Vec3D &vRot) {
+  const f64 fPhase = (f64)iFrame * 0.05 + (f64)iBone * 0.7;
+
+  for (s32 i = 0; i < 3; ++i) {
+    vPos[i] = bone.vPos[i] + sin(fPhase + i) * 2.0;
+    vRot[i] = bone.vRot[i] + sin(fPhase * 0.5 + i) * 0.5;
+  }
+};
+
+// Generate SMD mesh with a triangle strip split between several materials
+static void GenerateMeshSMD(const Str_t &strFile, const BenchCorpus &corpus, const std::vector<BenchBone> &aBones) {
+  CBenchRandom rnd(corpus.iSeed ^ U64_C(0x3E5A));
+
+  COutputFile file;
+  file.Open(strFile);
+
+  WriteSmdNodes(file, aBones);
+
+  // Default pose
+  file << "time 0\n";
+
+  for (s32 iBone = 0; iBone < corpus.ctBones; ++iBone) {
+    WriteSmdPlacement(file, iBone, aBones[iBone].vPos, aBones[iBone].vRot);
+  }
+
+  file << "end\ntriangles\n";
+
+  // Vertices of the strip that are shared between neighbouring triangles
+  const s32 ctVertices = corpus.ctTriangles + 2;
+  const s32 ctWeights = (corpus.ctWeights < 1 ? 1 : corpus.ctWeights);
+
+  std::vector<Str_t> aVertices(ctVertices);
+
+  for (s32 iVtx = 0; iVtx < ctVertices; ++iVtx) {
+    c8 strVertex[128];
+    Str_t &strLine = aVertices[iVtx];
+
+    const f64 fX = (f64)(iVtx / 2) * 0.5;
+    const f64 fZ = (f64)(iVtx % 2) * 0.5;
+
+    sprintf(strVertex, "%d %.6f %.6f %.6f 0.000000 1.000000 0.000000 %.6f %.6f %d",
+      (s32)(rnd.Next() % corpus.ctBones), fX, (rnd.Unit() - 0.5) * 0.1, fZ, fX * 0.01, fZ, ctWeights);
+    strLine = strVertex;
+
+    // Weights that add up to 1
+    f64 fLeft = 1.0;
+
+    for (s32 iWeight = 0; iWeight < ctWeights; ++iWeight) {
+      const f64 fWeight = (iWeight == ctWeights - 1 ? fLeft : fLeft * (0.5 + rnd.Unit() * 0.4));
+      fLeft -= fWeight;
+
+      sprintf(strVertex, " %d %.6f", (s32)(rnd.Next() % corpus.ctBones), fWeight);
+      strLine += strVertex;
+    }
+
+    strLine += '\n';
+  }
+
+  const s32 ctMaterials = 4;
+
+  for (s32 iTri = 0; iTri < corpus.ctTriangles; ++iTri) {
+    file << "material" << (s32)((s64)iTri * ctMaterials / corpus.ctTriangles) << ".tga\n";
+
+    // Keep the same winding for every triangle
+    const s32 iSwap = (iTri % 2);
+
+    file << aVertices[iTri];
+    file << aVertices[iTri + 1 + iSwap];
+    file << aVertices[iTri + 2 - iSwap];
+  }
+
+  file << "end\n";
+  file.Close();
+};
+
+// Generate SMD animation with some bones missing after the first frame
+static void GenerateAnimSMD(const Str_t &strFile, const BenchCorpus &corpus, const std::vector<BenchBone> &aBones) {
+  CBenchRandom rnd(corpus.iSeed ^ U64_C(0xA1A1));
+
+  COutputFile file;
+  file.Open(strFile);
+
+  WriteSmdNodes(file, aBones);
+
+  for (s32 iFrame = 0; iFrame < corpus.ctFrames; ++iFrame) {
+    file << "time " << iFrame << '\n';
+
+    for (s32 iBone = 0; iBone < corpus.ctBones; ++iBone) {
+      // First frame must have every bone
+      if (iFrame != 0 && rnd.Unit() >= corpus.fKeyed) {
+        continue;
+      }
+
+      Vec3D vPos, vRot;
+      GetAnimatedPlacement(aBones[iBone], iBone, iFrame, vPos, vRot);
+      WriteSmdPlacement(file, iBone, vPos, vRot);
+    }
+  }
+
+  file << "end\n";
+  file.Close();
+};
+
+// Generate SE2 animation with bones that aren't keyed only having default values
+static void GenerateAnimSE2(const Str_t &strFile, const BenchCorpus &corpus, const std::vector<BenchBone> &aBones) {
+  CBenchRandom rnd(corpus.iSeed ^ U64_C(0xE2E2));
+
+  COutputFile file;
+  file.Open(strFile);
+
+  file << "SE_ANIM 1.0;\n\n";
+  file << "ANIMATION_NAME \"Bench\";\n";
+  file << "SEC_PER_FRAME 0.04;\n";
+  file << "FIRST_FRAME 0;\n";
+  file << "LAST_FRAME " << (corpus.ctFrames - 1) << ";\n\n";
+
+  static const c8 *astrChannels[6] = { "POS_X", "POS_Y", "POS_Z", "ROT_H", "ROT_P", "ROT_B" };
+  std::vector<Vec3D> avPos(corpus.ctFrames), avRot(corpus.ctFrames);
+
+  for (s32 iBone = 0; iBone < corpus.ctBones; ++iBone) {
+    const BenchBone &bone = aBones[iBone];
+    const bool bKeyed = (iBone == 0 || rnd.Unit() < corpus.fKeyed);
+
+    for (s32 iFrame = 0; iFrame < corpus.ctFrames && bKeyed; ++iFrame) {
+      GetAnimatedPlacement(bone, iBone, iFrame, avPos[iFrame], avRot[iFrame]);
+    }
+
+    file << "ENVELOPE \"Bone" << iBone << "\" OFFSET 0;\n{\n";
+
+    for (s32 iChannel = 0; iChannel < 6; ++iChannel) {
+      file << "  CHANNEL \"" << astrChannels[iChannel] << "\" {\n    DEFAULT: ";
+      WriteFixed(file, (iChannel < 3 ? bone.vPos[iChannel] : bone.vRot[iChannel - 3]));
+
+      const s32 ctKeys = (bKeyed ? corpus.ctFrames : 0);
+      file << ";\n    FRAMES " << ctKeys << ";\n";
+
+      for (s32 iFrame = 0; iFrame < ctKeys; ++iFrame) {
+        file << "    " << iFrame << ": ";
+        WriteFixed(file, (iChannel < 3 ? avPos[iFrame][iChannel] : avRot[iFrame][iChannel - 3]));
+        file << ";\n";
+      }
+
+      file << "  }\n";
+    }
+
+    file << "}\n\n";
+  }
+
+  file.Close();
+};
+
+// Generate the same skeleton in SE2 and SE1 formats
+static void GenerateSkeletons(const Str_t &strFileSE2, const Str_t &strFileSE1, const BenchCorpus &corpus) {
+  CBenchRandom rnd(corpus.iSeed ^ U64_C(0x5E5E));
+
+  std::vector<BenchBone> aBones;
+  GenerateBones(rnd, corpus.ctSkelBones, aBones);
+
+  for (s32 iFormat = 0; iFormat < 2; ++iFormat) {
+    const bool bSE2 = (iFormat == 0);
+    const c8 *strEnd = (bSE2 ? "\n" : ";\n");
+
+    COutputFile file;
+    file.Open(bSE2 ? strFileSE2 : strFileSE1);
+
+    file << (bSE2 ? "SE_SKELETON 1.01\n\n" : "SE_SKELETON 0.1;\n\n");
+    file << "BONES " << corpus.ctSkelBones << "\n{\n";
+
+    for (s32 iBone = 0; iBone < corpus.ctSkelBones; ++iBone) {
+      const BenchBone &bone = aBones[iBone];
+
+      file << "  NAME \"Bone" << iBone << '"' << strEnd;
+
+      if (bone.iParent != -1) {
+        file << "  PARENT \"Bone" << bone.iParent << '"' << strEnd;
+      } else {
+        file << "  PARENT \"\"" << strEnd;
+      }
+
+      file << "  LENGTH 0.125" << strEnd;
+
+      // Generic limits and the pose keyword that SE1 skeletons don't have
+      if (bSE2) {
+        file << "  LIMITS {\n"
+          "   { 0: -3.14159, 3.14159; }\n"
+          "   { 0: -3.14159, 3.14159; }\n"
+          "   { 0: -3.14159, 3.14159; }\n"
+          "  }\n"
+          "  DEFAULT_POSE {\n    ";
+
+      } else {
+        file << "  {\n    ";
+      }
+
+      QuatVecD qv;
+      Mat12D m12;
+
+      qv._pos = bone.vPos;
+      qv._rot.FromEuler(bone.vRot);
+      qv.ToMatrix12(m12);
+
+      for (s32 i = 0; i < 12; ++i) {
+        WriteDigits(file, m12(i / 4, i % 4));
+        file << (i == 11 ? ";" : ", ");
+      }
+
+      file << "\n  }\n";
+    }
+
+    file << "}\n";
+
+    if (!bSE2) {
+      file << "\nSE_SKELETON_END;\n";
+    }
+
+    file.Close();
+  }
+};
+
+// Write all files of the corpus into a directory (throws an exception if it can't be created)
+void GenerateBenchCorpus(const Str_t &strDir, const BenchCorpus &corpus) {
+  if (!MakeDirectory(strDir)) {
+    CMessageException::Throw("Cannot create directory '%s'", strDir.c_str());
+  }
+
+  const Str_t strPrefix = strDir + "/";
+
+  // Mesh and both animations share the same skeleton
+  CBenchRandom rnd(corpus.iSeed);
+
+  std::vector<BenchBone> aBones;
+  GenerateBones(rnd, corpus.ctBones, aBones);
+
+  GenerateMeshSMD(strPrefix + BENCH_MESH_SMD, corpus, aBones);
+  GenerateAnimSMD(strPrefix + BENCH_ANIM_SMD, corpus, aBones);
+  GenerateAnimSE2(strPrefix + BENCH_ANIM_SE2, corpus, aBones);
+  GenerateSkeletons(strPrefix + BENCH_SKEL_SE2, strPrefix + BENCH_SKEL_SE1, corpus);
+};
+
+// Measurement of one converter
+struct BenchResult {
+  f64 fTime;  // Fastest conversion time
+  u64 iPeak;  // Largest peak memory
+  u64 iBytes; // Size of the input file
+};
+
+// Convert one file of the corpus a few times
+static bool MeasureConversion(const Str_t &strFile, const Strings_t &aArguments, s32 ctRepeats, BenchResult &result) {
+  FileInfo info;
+  result.iBytes = (GetFileInfo(strFile, info) ? info.iSize : 0);
+  result.fTime = -1.0;
+  result.iPeak = 0;
+
+  for (s32 iRepeat = 0; iRepeat < ctRepeats; ++iRepeat) {
+    Strings_t aFileArgs = aArguments;
+    ResetPeakMemory();
+
+    const f64 fStart = GetTimeSeconds();
+
+    try {
+      ConvertFile(strFile, aFileArgs);
+
+    } catch (CException &ex) {
+      std::cout << "# Error: " << strFile << ": " << ex.What() << '\n';
+      return false;
+    }
+
+    const f64 fTime = GetTimeSeconds() - fStart;
+    const u64 iPeak = GetPeakMemory();
+
+    if (result.fTime < 0.0 || fTime < result.fTime) {
+      result.fTime = fTime;
+    }
+
+    if (iPeak > result.iPeak) {
+      result.iPeak = iPeak;
+    }
+  }
+
+  return true;
+};
+
+// Read a comma-separated list of positive numbers
+static void ReadNumberList(const Str_t &strList, Ints_t &aiNumbers) {
+  aiNumbers.clear();
+
+  Strings_t aValues;
+  CharSplit<Str_t>(strList, ',', aValues);
+
+  for (size_t iValue = 0; iValue < aValues.size(); ++iValue) {
+    const s32 iNumber = atoi(aValues[iValue].c_str());
+
+    if (iNumber > 0) {
+      aiNumbers.push_back(iNumber);
+    }
+  }
+};
+
+// Set corpus size and suite options from arguments (returns false on unknown arguments)
+static bool ReadCorpusOptions(const Strings_t &aArguments, size_t iFirst, BenchCorpus &corpus,
+  Str_t &strDir, Ints_t &aiSizes, Ints_t &aiThreads, s32 &ctRepeats)
+{
+  for (size_t iArg = iFirst; iArg < aArguments.size(); ++iArg) {
+    const Str_t &strArg = aArguments[iArg];
+
+    // Every option has a value
+    if (iArg + 1 >= aArguments.size()) {
+      std::cout << "Expected a value after '" << strArg << "'\n";
+      return false;
+    }
+
+    const Str_t &strValue = aArguments[++iArg];
+
+    if (strArg == "-dir") {
+      strDir = strValue;
+
+    } else if (strArg == "-bones") {
+      corpus.ctBones = atoi(strValue.c_str());
+
+    } else if (strArg == "-frames") {
+      corpus.ctFrames = atoi(strValue.c_str());
+
+    } else if (strArg == "-triangles") {
+      corpus.ctTriangles = atoi(strValue.c_str());
+
+    } else if (strArg == "-weights") {
+      corpus.ctWeights = atoi(strValue.c_str());
+
+    } else if (strArg == "-keyed") {
+      corpus.fKeyed = atof(strValue.c_str());
+
+    } else if (strArg == "-skelbones") {
+      corpus.ctSkelBones = atoi(strValue.c_str());
+
+    } else if (strArg == "-seed") {
+      corpus.iSeed = (u64)strtoul(strValue.c_str(), nullptr, 10) | 1;
+
+    } else if (strArg == "-sizes") {
+      ReadNumberList(strValue, aiSizes);
+
+    } else if (strArg == "-threads") {
+      ReadNumberList(strValue, aiThreads);
+
+    } else if (strArg == "-repeat") {
+      ctRepeats = atoi(strValue.c_str());
+
+    } else {
+      std::cout << "Unknown benchmark option '" << strArg << "'\n";
+      return false;
+    }
+  }
+
+  // Keep the sizes valid
+  if (corpus.ctBones < 1) corpus.ctBones = 1;
+  if (corpus.ctFrames < 1) corpus.ctFrames = 1;
+  if (corpus.ctTriangles < 1) corpus.ctTriangles = 1;
+  if (corpus.ctWeights < 1) corpus.ctWeights = 1;
+  if (corpus.ctSkelBones < 1) corpus.ctSkelBones = 1;
+  if (ctRepeats < 1) ctRepeats = 1;
+
+  return true;
+};
+
+// Write corpus files without measuring anything
+extern s32 GenerateCorpusBenchmark(const Strings_t &aArguments) {
+  BenchCorpus corpus;
+  Str_t strDir = "BenchCorpus";
+  Ints_t aiSizes, aiThreads;
+  s32 ctRepeats = 1;
+
+  if (!ReadCorpusOptions(aArguments, 1, corpus, strDir, aiSizes, aiThreads, ctRepeats)) {
+    return 1;
+  }
+
+  try {
+    GenerateBenchCorpus(strDir, corpus);
+
+  } catch (CException &ex) {
+    std::cout << "Error: " << ex.What() << '\n';
+    return 1;
+  }
+
+  std::cout << "Generated benchmark files in " << strDir << '\n';
+  return 0;
+};
+
+// Convert generated files of different sizes with each converter and print results as CSV
+extern s32 RunCorpusBenchmark(const Strings_t &aArguments) {
+  BenchCorpus corpusBase;
+  Str_t strDir = "BenchCorpus";
+  Ints_t aiSizes, aiThreads;
+  s32 ctRepeats = 3;
+
+  if (!ReadCorpusOptions(aArguments, 1, corpusBase, strDir, aiSizes, aiThreads, ctRepeats)) {
+    return 1;
+  }
+
+  // Size multipliers
+  if (aiSizes.empty()) {
+    aiSizes.push_back(1);
+    aiSizes.push_back(4);
+    aiSizes.push_back(16);
+  }
+
+  // One thread and all CPU cores
+  if (aiThreads.empty()) {
+    aiThreads.push_back(1);
+
+    if (GetHardwareThreads() > 1) {
+      aiThreads.push_back(GetHardwareThreads());
+    }
+  }
+
+  // Mute converter messages and prompts
+  _bBatchMode = true;
+
+  std::cout << "converter,size,bones,frames,triangles,threads,input_bytes,seconds,mb_per_s,frames_per_s,peak_rss_mb\n";
+  s32 iResult = 0;
+
+  for (size_t iSize = 0; iSize < aiSizes.size(); ++iSize) {
+    const s32 iMul = aiSizes[iSize];
+
+    // Bigger animations, meshes and skeletons with the same amount of animated bones
+    BenchCorpus corpus = corpusBase;
+    corpus.ctFrames *= iMul;
+    corpus.ctTriangles *= iMul;
+    corpus.ctSkelBones *= iMul;
+
+    c8 strSizeDir[32];
+    sprintf(strSizeDir, "/x%d", iMul);
+    const Str_t strSizePrefix = strDir + strSizeDir;
+
+    try {
+      GenerateBenchCorpus(strSizePrefix, corpus);
+
+    } catch (CException &ex) {
+      std::cout << "# Error: " << ex.What() << '\n';
+      return 1;
+    }
+
+    // Converter paths with their input files and the amount of frames and bones in them
+    struct BenchPath {
+      const c8 *strName;
+      const c8 *strFile;
+      s32 ctFrames;
+      s32 ctBones;
+    };
+
+    const BenchPath aPaths[5] = {
+      { "ConvertSourceMesh(mesh)", BENCH_MESH_SMD, 1,               corpus.ctBones },
+      { "ConvertSourceMesh(anim)", BENCH_ANIM_SMD, corpus.ctFrames, corpus.ctBones },
+      { "ConvertAnimationSE2",     BENCH_ANIM_SE2, corpus.ctFrames, corpus.ctBones },
+      { "ConvertSkeletonSE2",      BENCH_SKEL_SE2, 0,               corpus.ctSkelBones },
+      { "ConvertSkeletonSE1",      BENCH_SKEL_SE1, 0,               corpus.ctSkelBones },
+    };
+
+    for (size_t iThreads = 0; iThreads < aiThreads.size(); ++iThreads) {
+      c8 strThreads[16];
+      sprintf(strThreads, "%d", aiThreads[iThreads]);
+
+      Strings_t aArguments;
+      aArguments.push_back("-fixscale");
+      aArguments.push_back("-fixdir");
+      aArguments.push_back("-fixanim");
+      aArguments.push_back("-base");
+      aArguments.push_back(strSizePrefix + "/" + BENCH_MESH_SMD);
+      aArguments.push_back("-threads");
+      aArguments.push_back(strThreads);
+
+      for (s32 iPath = 0; iPath < 5; ++iPath) {
+        const BenchPath &path = aPaths[iPath];
+        BenchResult result;
+
+        if (!MeasureConversion(strSizePrefix + "/" + path.strFile, aArguments, ctRepeats, result)) {
+          iResult = 1;
+          continue;
+        }
+
+        const f64 fTime = (result.fTime > 0.0 ? result.fTime : 1e-9);
+
+        printf("%s,%d,%d,%d,%d,%d,%llu,%.6f,%.2f,%.1f,%.1f\n", path.strName, iMul, path.ctBones, path.ctFrames,
+          (iPath == 0 ? corpus.ctTriangles : 0), aiThreads[iThreads], (unsigned long long)result.iBytes, result.fTime,
+          (f64)result.iBytes / (1024.0 * 1024.0) / fTime, (f64)path.ctFrames / fTime,
+          (f64)result.iPeak / (1024.0 * 1024.0));
+      }
+
+      fflush(stdout);
+    }
+  }
+
+  return iResult;
+};
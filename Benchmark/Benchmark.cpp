@@ -0,0 +1,544 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Benchmark.h"
+#include "Converters/SMD_Structures.h"
+
+#include "Common/InputFile.h"
+#include "Common/NumberFormat.h"
+#include "Common/NumberParser.h"
+#include "Common/Platform.h"
+#include "Common/TextScanner.h"
+
+// Generate numbers the way they are written in SMD and SE2 files
+static void GenerateNumberText(Str_t &strText, s32 ctNumbers) {
+  CBenchRandom rnd(U64_C(0x5EED5EED5EED));
+  c8 strNumber[64];
+
+  strText.reserve(ctNumbers * 12);
+
+  for (s32 iNumber = 0; iNumber < ctNumbers; ++iNumber) {
+    const f64 fValue = (rnd.Unit() - 0.5) * 200.0;
+
+    switch (rnd.Next() % 4) {
+      // Fixed precision (positions and rotations in SMD files)
+      case 0: case 1: sprintf(strNumber, "%.6f", fValue); break;
+
+      // Full precision
+      case 2: sprintf(strNumber, "%.17g", fValue); break;
+
+      // Scientific notation
+      default: sprintf(strNumber, "%.8e", fValue * 1e-5); break;
+    }
+
+    strText += strNumber;
+    strText += ((iNumber % 9) == 8 ? '\n' : ' ');
+  }
+};
+
+// Print one measurement
+static void PrintNumberResult(const c8 *strMethod, f64 fTime, size_t iBytes, s32 ctNumbers) {
+  printf("  %-24s %9.2f ms %9.2f MB/s %8.2f ns/number\n", strMethod, fTime * 1000.0,
+    (f64)iBytes / (1024.0 * 1024.0) / fTime, fTime * 1e9 / ctNumbers);
+};
+
+// Compare number parsing of the tokenizer, the C library and the text scanner
+static s32 BenchmarkNumbers(s32 ctNumbers) {
+  Str_t strText;
+  GenerateNumberText(strText, ctNumbers);
+
+  printf("Parsing %d numbers (%u bytes)\n", ctNumbers, (u32)strText.size());
+
+  std::vector<f64> afLibrary(ctNumbers);
+  std::vector<f64> afScanner(ctNumbers);
+  f64 fSum = 0.0;
+
+  // Previous path: tokenize the whole text and convert number tokens
+  {
+    const f64 fStart = GetTimeSeconds();
+
+    CTokenList aTokens;
+    TokenizeString(aTokens, strText);
+
+    bool bNegative = false;
+    CTokenList::const_iterator it;
+
+    for (it = aTokens.begin(); it != aTokens.end(); ++it) {
+      if (it->GetType() == CParserToken::TKN_SUB) {
+        bNegative = true;
+        continue;
+      }
+
+      fSum += GetNumber<f64>(it->GetValue()) * (bNegative ? -1 : 1);
+      bNegative = false;
+    }
+
+    PrintNumberResult("Tokenizer", GetTimeSeconds() - fStart, strText.size(), ctNumbers);
+  }
+
+  // C library
+  {
+    const f64 fStart = GetTimeSeconds();
+    const c8 *pch = strText.c_str();
+
+    for (s32 iNumber = 0; iNumber < ctNumbers; ++iNumber) {
+      c8 *pchNext;
+      afLibrary[iNumber] = strtod(pch, &pchNext);
+      pch = pchNext;
+    }
+
+    PrintNumberResult("strtod()", GetTimeSeconds() - fStart, strText.size(), ctNumbers);
+  }
+
+  // Text scanner
+  {
+    const f64 fStart = GetTimeSeconds();
+    CTextScanner scan(strText.c_str(), strText.size());
+
+    for (s32 iNumber = 0; iNumber < ctNumbers; ++iNumber) {
+      afScanner[iNumber] = scan.ReadFloat();
+    }
+
+    PrintNumberResult("CTextScanner::ReadFloat()", GetTimeSeconds() - fStart, strText.size(), ctNumbers);
+  }
+
+  // Results must be exactly the same as from the C library
+  s32 ctMismatches = 0;
+
+  for (s32 iNumber = 0; iNumber < ctNumbers; ++iNumber) {
+    ctMismatches += (memcmp(&afLibrary[iNumber], &afScanner[iNumber], sizeof(f64)) != 0);
+  }
+
+  printf("Mismatching numbers: %d (checksum %g)\n", ctMismatches, fSum);
+  return (ctMismatches != 0);
+};
+
+// Compare number formatting of the C library and the converter's own formatter
+static s32 BenchmarkFormat(s32 ctNumbers) {
+  CBenchRandom rnd(U64_C(0xF0F0F0F0F0F0));
+  std::vector<f64> afNumbers(ctNumbers);
+
+  // Matrix values, positions, numbers with no fraction and subnormal numbers
+  for (s32 iNumber = 0; iNumber < ctNumbers; ++iNumber) {
+    switch (iNumber % 4) {
+      case 0: afNumbers[iNumber] = rnd.Unit() * 2.0 - 1.0; break;
+      case 1: afNumbers[iNumber] = (rnd.Unit() - 0.5) * 200.0; break;
+      case 2: afNumbers[iNumber] = (f64)(s32)(rnd.Next() % 2000) - 1000.0; break;
+
+      default: {
+        // Random mantissa with a zero exponent
+        const u64 iBits = rnd.Next() & ((U64_C(1) << 52) - 1);
+        memcpy(&afNumbers[iNumber], &iBits, sizeof(iBits));
+      } break;
+    }
+  }
+
+  printf("Formatting %d numbers\n", ctNumbers);
+
+  c8 strLibrary[64];
+  c8 strFormatted[FLOAT_TEXT_LENGTH];
+  size_t iBytes = 0;
+
+  // C library with the default stream precision
+  f64 fStart = GetTimeSeconds();
+
+  for (s32 iNumber = 0; iNumber < ctNumbers; ++iNumber) {
+    iBytes += sprintf(strLibrary, "%g", afNumbers[iNumber]);
+  }
+
+  PrintNumberResult("sprintf(\"%g\")", GetTimeSeconds() - fStart, iBytes, ctNumbers);
+
+  // C library with enough digits to read back the same number
+  fStart = GetTimeSeconds();
+  iBytes = 0;
+
+  for (s32 iNumber = 0; iNumber < ctNumbers; ++iNumber) {
+    iBytes += sprintf(strLibrary, "%.17g", afNumbers[iNumber]);
+  }
+
+  PrintNumberResult("sprintf(\"%.17g\")", GetTimeSeconds() - fStart, iBytes, ctNumbers);
+
+  // Formatter with 6 significant digits
+  fStart = GetTimeSeconds();
+  iBytes = 0;
+
+  for (s32 iNumber = 0; iNumber < ctNumbers; ++iNumber) {
+    iBytes += FormatDouble(strFormatted, afNumbers[iNumber], 6);
+  }
+
+  PrintNumberResult("FormatDouble(6 digits)", GetTimeSeconds() - fStart, iBytes, ctNumbers);
+
+  // Formatter with the shortest representation
+  fStart = GetTimeSeconds();
+  iBytes = 0;
+
+  for (s32 iNumber = 0; iNumber < ctNumbers; ++iNumber) {
+    iBytes += FormatDouble(strFormatted, afNumbers[iNumber], FLOAT_DIGITS_SHORTEST);
+  }
+
+  PrintNumberResult("FormatDouble(shortest)", GetTimeSeconds() - fStart, iBytes, ctNumbers);
+
+  // Fixed precision must match the C library and the shortest representation must read back the same
+  s32 ctMismatches = 0;
+  s32 ctNotRoundTrip = 0;
+
+  for (s32 iNumber = 0; iNumber < ctNumbers; ++iNumber) {
+    const f64 fValue = afNumbers[iNumber];
+
+    sprintf(strLibrary, "%g", fValue);
+    FormatDouble(strFormatted, fValue, 6);
+    ctMismatches += (strcmp(strLibrary, strFormatted) != 0);
+
+    sprintf(strLibrary, "%.17g", fValue);
+    FormatDouble(strFormatted, fValue, 17);
+    ctMismatches += (strcmp(strLibrary, strFormatted) != 0);
+
+    const size_t iLength = FormatDouble(strFormatted, fValue, FLOAT_DIGITS_SHORTEST);
+    f64 fRead = 0.0;
+    ParseDouble(strFormatted, strFormatted + iLength, fRead);
+    ctNotRoundTrip += (fRead != fValue);
+  }
+
+  printf("Different from sprintf(\"%%g\") and sprintf(\"%%.17g\"): %d, shortest not read back: %d\n", ctMismatches, ctNotRoundTrip);
+  return (ctMismatches != 0 || ctNotRoundTrip != 0);
+};
+
+// Compare batched bone pose conversion against the step by step one
+static s32 BenchmarkPose(s32 ctFrames) {
+  const s32 ctBones = 64;
+  CBenchRandom rnd(U64_C(0xB0E5B0E5B0E5));
+
+  // Random placements with every fourth bone being a root bone and some frames without keys
+  CAnimTracks tracksSource;
+  tracksSource.Reset(ctBones, ctFrames, (size_t)ctBones * ctFrames);
+
+  for (s32 iBone = 0; iBone < ctBones; ++iBone) {
+    for (s32 iFrame = 0; iFrame < ctFrames; ++iFrame) {
+      Vec3D vPos;
+      Ang3D vRot;
+
+      for (s32 i = 0; i < 3; ++i) {
+        vPos[i] = (rnd.Unit() - 0.5) * 200.0;
+        vRot[i] = (rnd.Unit() - 0.5) * 4.0 * 3.14159265358979323846;
+      }
+
+      if (iFrame == 0 || rnd.Next() % 8 != 0) {
+        tracksSource.AddKey(iFrame, vPos, vRot);
+      }
+    }
+
+    tracksSource.EndBone();
+  }
+
+  printf("Converting %d bones in %d frames (tolerance %g)\n", ctBones, ctFrames, POSE_TOLERANCE);
+
+  extern void ConvertBoneTrack(const SmdOptions &opts, bool bAnimFile, bool bRoot, CAnimTracks &tracks, s32 iBone);
+  extern void ConvertBoneTrackScalar(const SmdOptions &opts, bool bAnimFile, bool bRoot, CAnimTracks &tracks, s32 iBone);
+
+  f64 fMaxError = 0.0;
+
+  // Go through every combination of facing options
+  for (s32 iOptions = 0; iOptions < 6; ++iOptions) {
+    SmdOptions opts;
+    opts.fScale = 1.0 / 64.0;
+    opts.bFixFaceDir = (iOptions & 1) != 0;
+    opts.bFixAnimNorth = (iOptions & 2) != 0;
+    const bool bAnimFile = (iOptions < 4);
+
+    CAnimTracks tracksScalar = tracksSource;
+    CAnimTracks tracksBatch = tracksSource;
+
+    f64 fStart = GetTimeSeconds();
+
+    for (s32 iBone = 0; iBone < ctBones; ++iBone) {
+      ConvertBoneTrackScalar(opts, bAnimFile, (iBone % 4) == 0, tracksScalar, iBone);
+    }
+
+    const f64 fScalar = GetTimeSeconds() - fStart;
+    fStart = GetTimeSeconds();
+
+    for (s32 iBone = 0; iBone < ctBones; ++iBone) {
+      ConvertBoneTrack(opts, bAnimFile, (iBone % 4) == 0, tracksBatch, iBone);
+    }
+
+    const f64 fBatch = GetTimeSeconds() - fStart;
+
+    // Largest difference between matrix elements
+    f64 fError = 0.0;
+
+    for (size_t iKey = 0; iKey < tracksSource.aiFrames.size(); ++iKey) {
+      for (s32 i = 0; i < 12; ++i) {
+        const f64 fDiff = fabs(tracksScalar.amConverted[iKey](i / 4, i % 4) - tracksBatch.amConverted[iKey](i / 4, i % 4));
+        fError = (fDiff > fError ? fDiff : fError);
+      }
+    }
+
+    fMaxError = (fError > fMaxError ? fError : fMaxError);
+
+    printf("  %-4s fixdir=%d fixanim=%d  step by step %8.2f ms  batched %8.2f ms  max difference %g\n",
+      (bAnimFile ? "anim" : "mesh"), opts.bFixFaceDir, opts.bFixAnimNorth, fScalar * 1000.0, fBatch * 1000.0, fError);
+  }
+
+  printf("Largest difference: %g\n", fMaxError);
+
+  // Conversion on multiple threads must give exactly the same results
+  SmdStructure smdSerial, smdThreaded;
+
+  for (s32 iBone = 0; iBone < ctBones; ++iBone) {
+    smdSerial.aSkeleton.push_back(CBoneInfo(iBone, (iBone % 4) == 0 ? -1 : iBone - 1, "bone"));
+  }
+
+  smdSerial.iBones = ctBones;
+  smdSerial.iFrames = ctFrames;
+  smdSerial.aTracks = tracksSource;
+
+  smdThreaded.aSkeleton = smdSerial.aSkeleton;
+  smdThreaded.iBones = ctBones;
+  smdThreaded.iFrames = ctFrames;
+  smdThreaded.aTracks = tracksSource;
+
+  SmdOptions optsThreads;
+  optsThreads.bFixFaceDir = optsThreads.bFixAnimNorth = true;
+
+  extern void ConvertPoses(const SmdOptions &opts, SmdStructure &smd);
+
+  optsThreads.ctThreads = 1;
+  f64 fStart = GetTimeSeconds();
+  ConvertPoses(optsThreads, smdSerial);
+  const f64 fSerial = GetTimeSeconds() - fStart;
+
+  optsThreads.ctThreads = GetHardwareThreads() > 4 ? GetHardwareThreads() : 4;
+  fStart = GetTimeSeconds();
+  ConvertPoses(optsThreads, smdThreaded);
+  const f64 fThreaded = GetTimeSeconds() - fStart;
+
+  const bool bSame = memcmp(&smdSerial.aTracks.amConverted[0], &smdThreaded.aTracks.amConverted[0],
+    sizeof(Mat12D) * smdSerial.aTracks.amConverted.size()) == 0;
+
+  printf("  1 thread %8.2f ms  %d threads %8.2f ms  results %s\n", fSerial * 1000.0,
+    optsThreads.ctThreads, fThreaded * 1000.0, (bSame ? "identical" : "DIFFERENT"));
+
+  return (fMaxError > POSE_TOLERANCE || !bSame);
+};
+
+// Read converted file into a string
+static bool ReadWholeFile(const Str_t &strFile, Str_t &strText) {
+  CInputFile file;
+
+  if (!file.TryOpen(strFile)) {
+    return false;
+  }
+
+  strText.assign(file.GetData(), file.GetSize());
+  return true;
+};
+
+// Compare batched SE2+ envelope conversion against the step by step one
+static s32 BenchmarkEnvelope(s32 ctFrames) {
+  const s32 ctEnvelopes = 64;
+  const s32 ctPlacements = ctEnvelopes * (ctFrames + 1);
+  CBenchRandom rnd(U64_C(0xE2E2E2E2E2E2));
+
+  // Random placements in XYZHPB
+  std::vector<f64> afPlacements((size_t)ctPlacements * 6);
+
+  for (s32 iPlacement = 0; iPlacement < ctPlacements; ++iPlacement) {
+    for (s32 i = 0; i < 3; ++i) {
+      afPlacements[iPlacement * 6 + i] = (rnd.Unit() - 0.5) * 200.0;
+      afPlacements[iPlacement * 6 + 3 + i] = (rnd.Unit() - 0.5) * 4.0 * 3.14159265358979323846;
+    }
+  }
+
+  printf("Converting %d envelopes with %d frames (tolerance %g)\n", ctEnvelopes, ctFrames, POSE_TOLERANCE);
+
+  extern void ConvertPlacementsSE2Scalar(const f64 *afPlacements, s32 ctPlacements, f64 *afMatrices);
+  extern void ConvertPlacementsSE2Batch(const f64 *afPlacements, s32 ctPlacements, f64 *afMatrices);
+
+  std::vector<f64> afScalar((size_t)ctPlacements * 12);
+  std::vector<f64> afBatch((size_t)ctPlacements * 12);
+
+  f64 fStart = GetTimeSeconds();
+  ConvertPlacementsSE2Scalar(&afPlacements[0], ctPlacements, &afScalar[0]);
+  const f64 fScalar = GetTimeSeconds() - fStart;
+
+  fStart = GetTimeSeconds();
+  ConvertPlacementsSE2Batch(&afPlacements[0], ctPlacements, &afBatch[0]);
+  const f64 fBatch = GetTimeSeconds() - fStart;
+
+  // Largest difference between matrix elements and numbers that are written differently
+  f64 fMaxError = 0.0;
+  s32 ctDifferent = 0;
+
+  c8 strScalar[FLOAT_TEXT_LENGTH];
+  c8 strBatch[FLOAT_TEXT_LENGTH];
+
+  for (size_t i = 0; i < afScalar.size(); ++i) {
+    const f64 fDiff = fabs(afScalar[i] - afBatch[i]);
+    fMaxError = (fDiff > fMaxError ? fDiff : fMaxError);
+
+    strScalar[FormatDouble(strScalar, afScalar[i], _iFloatDigits)] = '\0';
+    strBatch[FormatDouble(strBatch, afBatch[i], _iFloatDigits)] = '\0';
+
+    if (strcmp(strScalar, strBatch) != 0) {
+      ++ctDifferent;
+    }
+  }
+
+  printf("  step by step %8.2f ms  batched %8.2f ms  max difference %g  numbers written differently: %d\n",
+    fScalar * 1000.0, fBatch * 1000.0, fMaxError, ctDifferent);
+
+  // Batched conversion on one and multiple threads must write exactly the same file as the conversion by the utilities
+  BenchCorpus corpus;
+  corpus.ctBones = ctEnvelopes;
+  corpus.ctFrames = (ctFrames < 1000 ? ctFrames : 1000);
+  corpus.ctTriangles = 1;
+  corpus.ctSkelBones = 1;
+
+  const Str_t strDir = "BenchEnvelope";
+  const Str_t strFile = strDir + "/" + BENCH_ANIM_SE2;
+  const Str_t strConverted = strDir + "/" + CPath(BENCH_ANIM_SE2).RemoveExt() + ".aa";
+
+  Str_t strScalarFile, strSerial, strThreaded;
+  const s32 ctThreads = (GetHardwareThreads() > 4 ? GetHardwareThreads() : 4);
+
+  extern void ConvertAnimationSE2(const c8 *pchData, size_t iSize, const CPath &strFile, s32 ctThreads, bool bBatch);
+  _bBatchMode = true;
+
+  try {
+    GenerateBenchCorpus(strDir, corpus);
+
+    CInputFile file;
+    file.Open(strFile);
+
+    ConvertAnimationSE2(file.GetData(), file.GetSize(), strFile, 1, false);
+    ReadWholeFile(strConverted, strScalarFile);
+
+    fStart = GetTimeSeconds();
+    ConvertAnimationSE2(file.GetData(), file.GetSize(), strFile, 1, true);
+    const f64 fSerial = GetTimeSeconds() - fStart;
+
+    ReadWholeFile(strConverted, strSerial);
+
+    fStart = GetTimeSeconds();
+    ConvertAnimationSE2(file.GetData(), file.GetSize(), strFile, ctThreads, true);
+    const f64 fThreaded = GetTimeSeconds() - fStart;
+
+    ReadWholeFile(strConverted, strThreaded);
+
+    printf("  1 thread %8.2f ms  %d threads %8.2f ms  files %s\n", fSerial * 1000.0, ctThreads, fThreaded * 1000.0,
+      (strScalarFile == strSerial && strSerial == strThreaded ? "identical" : "DIFFERENT"));
+
+  } catch (CException &ex) {
+    std::cout << "Error: " << ex.What() << '\n';
+    return 1;
+  }
+
+  return (fMaxError > POSE_TOLERANCE || ctDifferent != 0 || strScalarFile != strSerial || strSerial != strThreaded);
+};
+
+// Run performance measurements
+static s32 RunBenchmark(const Strings_t &aArguments) {
+  const Str_t strTest = (aArguments.empty() ? "numbers" : aArguments[0]);
+
+  if (strTest == "numbers") {
+    s32 ctNumbers = 1000000;
+
+    if (aArguments.size() > 1) {
+      ctNumbers = atoi(aArguments[1].c_str());
+    }
+
+    return BenchmarkNumbers(ctNumbers < 1 ? 1 : ctNumbers);
+  }
+
+  if (strTest == "format") {
+    s32 ctNumbers = 1000000;
+
+    if (aArguments.size() > 1) {
+      ctNumbers = atoi(aArguments[1].c_str());
+    }
+
+    return BenchmarkFormat(ctNumbers < 1 ? 1 : ctNumbers);
+  }
+
+  if (strTest == "pose") {
+    s32 ctFrames = 10000;
+
+    if (aArguments.size() > 1) {
+      ctFrames = atoi(aArguments[1].c_str());
+    }
+
+    return BenchmarkPose(ctFrames < 1 ? 1 : ctFrames);
+  }
+
+  if (strTest == "envelope") {
+    s32 ctFrames = 10000;
+
+    if (aArguments.size() > 1) {
+      ctFrames = atoi(aArguments[1].c_str());
+    }
+
+    return BenchmarkEnvelope(ctFrames < 1 ? 1 : ctFrames);
+  }
+
+  if (strTest == "binary") {
+    s32 ctFrames = 1000;
+
+    if (aArguments.size() > 1) {
+      ctFrames = atoi(aArguments[1].c_str());
+    }
+
+    extern s32 RunBinaryBenchmark(s32 ctFrames);
+    return RunBinaryBenchmark(ctFrames < 1 ? 1 : ctFrames);
+  }
+
+  // Check binary layouts of a reference model
+  if (strTest == "layout") {
+    extern s32 RunBinaryLayoutCheck(void);
+    return RunBinaryLayoutCheck();
+  }
+
+  // Write generated SMD and SE2 files
+  if (strTest == "generate") {
+    extern s32 GenerateCorpusBenchmark(const Strings_t &aArguments);
+    return GenerateCorpusBenchmark(aArguments);
+  }
+
+  // Convert generated files with every converter
+  if (strTest == "corpus") {
+    extern s32 RunCorpusBenchmark(const Strings_t &aArguments);
+    return RunCorpusBenchmark(aArguments);
+  }
+
+  std::cout << "Unknown benchmark '" << strTest << "'\n";
+  return 1;
+};
+
+// Entry point
+int main(int iArgs, c8 *astrArgs[]) {
+  Strings_t aArguments;
+
+  for (s32 iArg = 1; iArg < iArgs; ++iArg) {
+    aArguments.push_back(astrArgs[iArg]);
+  }
+
+  return RunBenchmark(aArguments);
+};
@@ -0,0 +1,78 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include "Common/Platform.h"
+
+// Deterministic pseudo-random numbers for generating test data
+class CBenchRandom {
+  public:
+    u64 iState;
+
+    CBenchRandom(u64 iSeed) : iState(iSeed) {};
+
+    inline u64 Next(void) {
+      iState ^= iState << 13;
+      iState ^= iState >> 7;
+      iState ^= iState << 17;
+      return iState;
+    };
+
+    // Number in the [0, 1) range
+    inline f64 Unit(void) {
+      return (f64)(Next() >> 11) / (f64)((u64)1 << 53);
+    };
+};
+
+// Size of generated benchmark files
+struct BenchCorpus {
+  s32 ctBones;     // Bones in SMD and SE2 animation files
+  s32 ctFrames;    // Animation frames
+  s32 ctTriangles; // Mesh triangles
+  s32 ctWeights;   // Bone weights per mesh vertex
+  f64 fKeyed;      // Fraction of bones that are set in each frame after the first one
+  s32 ctSkelBones; // Bones in SE1 and SE2 skeleton files
+  u64 iSeed;       // Seed for the random numbers
+
+  BenchCorpus(void) {
+    ctBones = 64;
+    ctFrames = 1000;
+    ctTriangles = 20000;
+    ctWeights = 3;
+    fKeyed = 1.0;
+    ctSkelBones = 1000;
+    iSeed = U64_C(0xC0C0C0C0C0C0);
+  };
+};
+
+// Names of generated files in the corpus directory
+#define BENCH_MESH_SMD   "BenchMesh.smd"
+#define BENCH_ANIM_SMD   "BenchAnim.smd"
+#define BENCH_ANIM_SE2   "BenchAnim.aaf"
+#define BENCH_SKEL_SE2   "BenchSkeleton.asf"
+#define BENCH_SKEL_SE1   "BenchSkeletonSE1.as"
+
+// Write all files of the corpus into a directory (throws an exception if it can't be created)
+void GenerateBenchCorpus(const Str_t &strDir, const BenchCorpus &corpus);
+
+#endif
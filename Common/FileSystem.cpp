@@ -0,0 +1,274 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Common/FileSystem.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+  #include <direct.h>
+#else
+  #include <dirent.h>
+  #include <glob.h>
+  #include <limits.h>
+  #include <stdlib.h>
+#endif
+
+// Retrieve info about a file or a directory (returns false if it doesn't exist)
+bool GetFileInfo(const Str_t &strPath, FileInfo &info) {
+#ifdef _WIN32
+  struct _stati64 st;
+
+  if (_stati64(strPath.c_str(), &st) != 0) {
+    return false;
+  }
+
+  info.bDir = ((st.st_mode & _S_IFDIR) != 0);
+
+#else
+  struct stat st;
+
+  if (stat(strPath.c_str(), &st) != 0) {
+    return false;
+  }
+
+  info.bDir = S_ISDIR(st.st_mode);
+#endif
+
+  info.iSize = (u64)st.st_size;
+  info.iModified = (u64)st.st_mtime;
+  return true;
+};
+
+// Check if the path points to an existing directory
+bool IsDirectory(const Str_t &strPath) {
+  FileInfo info;
+  return GetFileInfo(strPath, info) && info.bDir;
+};
+
+// Check if the path starts from the filesystem root
+bool IsAbsolutePath(const Str_t &strPath) {
+  if (strPath.empty()) {
+    return false;
+  }
+
+  // Starts from the root or from a network share
+  if (strPath[0] == '/' || strPath[0] == '\\') {
+    return true;
+  }
+
+  // Starts from a drive letter
+  return (strPath.size() > 1 && strPath[1] == ':');
+};
+
+// Get directory of the file with a trailing slash (empty if none)
+Str_t GetFileDir(const Str_t &strFile) {
+  size_t iSlash = strFile.find_last_of("/\\");
+
+  if (iSlash == Str_t::npos) {
+    return "";
+  }
+
+  return strFile.substr(0, iSlash + 1);
+};
+
+// Get path to another file in the same directory as the file
+Str_t GetNearbyFile(const Str_t &strFile, const Str_t &strOther) {
+  if (IsAbsolutePath(strOther)) {
+    return strOther;
+  }
+
+  return GetFileDir(strFile) + strOther;
+};
+
+// Get full absolute path to an existing file (returns the path itself on failure)
+Str_t GetCanonicalPath(const Str_t &strPath) {
+#ifdef _WIN32
+  c8 strFull[MAX_PATH];
+
+  if (GetFullPathNameA(strPath.c_str(), MAX_PATH, strFull, nullptr) == 0) {
+    return strPath;
+  }
+
+  // Case-insensitive filesystem
+  Str_t strResult = strFull;
+
+  for (size_t i = 0; i < strResult.size(); ++i) {
+    strResult[i] = (c8)tolower((u8)strResult[i]);
+  }
+
+  return strResult;
+
+#else
+  c8 strFull[PATH_MAX];
+
+  if (realpath(strPath.c_str(), strFull) == nullptr) {
+    return strPath;
+  }
+
+  return strFull;
+#endif
+};
+
+// Create a directory with all of its parents (returns false if it doesn't exist afterwards)
+bool MakeDirectory(const Str_t &strDir) {
+  if (strDir.empty() || IsDirectory(strDir)) {
+    return true;
+  }
+
+  // Create parent directories first
+  Str_t strParent = strDir;
+
+  while (!strParent.empty() && (strParent[strParent.size() - 1] == '/' || strParent[strParent.size() - 1] == '\\')) {
+    strParent.erase(strParent.size() - 1);
+  }
+
+  const Str_t strThis = strParent;
+  strParent = GetFileDir(strParent);
+
+  if (!strParent.empty() && strParent != strThis) {
+    MakeDirectory(strParent);
+  }
+
+#ifdef _WIN32
+  _mkdir(strThis.c_str());
+#else
+  mkdir(strThis.c_str(), 0755);
+#endif
+
+  return IsDirectory(strThis);
+};
+
+// List files in a directory
+void ListFiles(const Str_t &strDir, Strings_t &aFiles, bool bRecursive) {
+  Str_t strPrefix = strDir;
+
+  // Add trailing slash
+  if (!strPrefix.empty() && strPrefix[strPrefix.size() - 1] != '/' && strPrefix[strPrefix.size() - 1] != '\\') {
+    strPrefix += '/';
+  }
+
+  Strings_t aSubdirs;
+
+#ifdef _WIN32
+  WIN32_FIND_DATAA fd;
+  HANDLE hFind = FindFirstFileA((strPrefix + "*").c_str(), &fd);
+
+  if (hFind == INVALID_HANDLE_VALUE) {
+    return;
+  }
+
+  do {
+    const Str_t strName = fd.cFileName;
+
+    if (strName == "." || strName == "..") {
+      continue;
+    }
+
+    if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+      aSubdirs.push_back(strPrefix + strName);
+    } else {
+      aFiles.push_back(strPrefix + strName);
+    }
+  } while (FindNextFileA(hFind, &fd));
+
+  FindClose(hFind);
+
+#else
+  DIR *pDir = opendir(strPrefix.empty() ? "." : strPrefix.c_str());
+
+  if (pDir == nullptr) {
+    return;
+  }
+
+  dirent *pEntry;
+
+  while ((pEntry = readdir(pDir)) != nullptr) {
+    const Str_t strName = pEntry->d_name;
+
+    if (strName == "." || strName == "..") {
+      continue;
+    }
+
+    const Str_t strPath = strPrefix + strName;
+
+    if (IsDirectory(strPath)) {
+      aSubdirs.push_back(strPath);
+    } else {
+      aFiles.push_back(strPath);
+    }
+  }
+
+  closedir(pDir);
+#endif
+
+  // Go through subdirectories in a consistent order
+  if (bRecursive) {
+    std::sort(aSubdirs.begin(), aSubdirs.end());
+
+    for (size_t iDir = 0; iDir < aSubdirs.size(); ++iDir) {
+      ListFiles(aSubdirs[iDir], aFiles, true);
+    }
+  }
+};
+
+// List files matching a wildcard pattern (e.g. "Models/*.smd")
+void ListWildcardFiles(const Str_t &strPattern, Strings_t &aFiles) {
+#ifdef _WIN32
+  const Str_t strDir = GetFileDir(strPattern);
+
+  WIN32_FIND_DATAA fd;
+  HANDLE hFind = FindFirstFileA(strPattern.c_str(), &fd);
+
+  if (hFind == INVALID_HANDLE_VALUE) {
+    return;
+  }
+
+  do {
+    if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+      aFiles.push_back(strDir + fd.cFileName);
+    }
+  } while (FindNextFileA(hFind, &fd));
+
+  FindClose(hFind);
+
+#else
+  glob_t gl;
+
+  if (glob(strPattern.c_str(), 0, nullptr, &gl) != 0) {
+    return;
+  }
+
+  for (size_t i = 0; i < gl.gl_pathc; ++i) {
+    if (!IsDirectory(gl.gl_pathv[i])) {
+      aFiles.push_back(gl.gl_pathv[i]);
+    }
+  }
+
+  globfree(&gl);
+#endif
+};
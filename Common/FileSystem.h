@@ -0,0 +1,64 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_FILESYSTEM_H
+#define _COMMON_FILESYSTEM_H
+
+// Basic info about a file on disk
+struct FileInfo {
+  u64 iSize;     // File size in bytes
+  u64 iModified; // Last modification time (seconds since the epoch)
+  bool bDir;     // It's a directory
+};
+
+// Retrieve info about a file or a directory (returns false if it doesn't exist)
+bool GetFileInfo(const Str_t &strPath, FileInfo &info);
+
+// Check if the path points to an existing directory
+bool IsDirectory(const Str_t &strPath);
+
+// Check if the path starts from the filesystem root
+bool IsAbsolutePath(const Str_t &strPath);
+
+// Get directory of the file with a trailing slash (empty if none)
+Str_t GetFileDir(const Str_t &strFile);
+
+// Get path to another file in the same directory as the file
+Str_t GetNearbyFile(const Str_t &strFile, const Str_t &strOther);
+
+// Get full absolute path to an existing file (returns the path itself on failure)
+Str_t GetCanonicalPath(const Str_t &strPath);
+
+// Create a directory with all of its parents (returns false if it doesn't exist afterwards)
+bool MakeDirectory(const Str_t &strDir);
+
+// List files in a directory
+void ListFiles(const Str_t &strDir, Strings_t &aFiles, bool bRecursive);
+
+// List files matching a wildcard pattern (e.g. "Models/*.smd")
+void ListWildcardFiles(const Str_t &strPattern, Strings_t &aFiles);
+
+// Check if the path contains any wildcard characters
+inline bool HasWildcards(const Str_t &strPath) {
+  return strPath.find_first_of("*?") != Str_t::npos;
+};
+
+#endif
@@ -0,0 +1,242 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Common/InputFile.h"
+
+#include "Common/MemoryStats.h"
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+// Size of blocks for reading files that can't be mapped
+#define INPUT_READ_BLOCK (64 * 1024)
+
+CInputFile::CInputFile(void) :
+  _pchData(""), _iSize(0), _pMapped(nullptr), _hFile(nullptr), _hMapping(nullptr)
+{
+};
+
+CInputFile::~CInputFile(void) {
+  Close();
+};
+
+#ifdef _WIN32
+
+// Map the opened file into memory
+bool CInputFile::Map(void *hFile, u64 iFileSize) {
+  // Too big for the address space
+  if (iFileSize > (u64)(size_t)-1) {
+    return false;
+  }
+
+  HANDLE hMapping = CreateFileMappingA((HANDLE)hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+  if (hMapping == nullptr) {
+    return false;
+  }
+
+  void *pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+
+  if (pView == nullptr) {
+    CloseHandle(hMapping);
+    return false;
+  }
+
+  _hMapping = hMapping;
+  _pMapped = pView;
+  _pchData = (const c8 *)pView;
+  _iSize = (size_t)iFileSize;
+  return true;
+};
+
+// Open the file for reading (returns false if it can't be opened)
+bool CInputFile::TryOpen(const Str_t &strFile) {
+  Close();
+
+  HANDLE hFile = CreateFileA(strFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+  if (hFile == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  _hFile = hFile;
+
+  // Map regular files that aren't empty
+  if (GetFileType(hFile) == FILE_TYPE_DISK) {
+    DWORD iSizeHigh = 0;
+    const DWORD iSizeLow = GetFileSize(hFile, &iSizeHigh);
+    const u64 iFileSize = ((u64)iSizeHigh << 32) | iSizeLow;
+
+    if (iFileSize == 0 || Map(hFile, iFileSize)) {
+      return true;
+    }
+  }
+
+  // Read everything into the buffer
+  for (;;) {
+    const size_t iOffset = _aBuffer.size();
+    _aBuffer.resize(iOffset + INPUT_READ_BLOCK);
+
+    DWORD iRead = 0;
+
+    if (!ReadFile(hFile, &_aBuffer[iOffset], INPUT_READ_BLOCK, &iRead, nullptr) || iRead == 0) {
+      _aBuffer.resize(iOffset);
+      break;
+    }
+
+    _aBuffer.resize(iOffset + iRead);
+  }
+
+  if (!_aBuffer.empty()) {
+    _pchData = &_aBuffer[0];
+    _iSize = _aBuffer.size();
+  }
+
+  return true;
+};
+
+// Release the file contents
+void CInputFile::Close(void) {
+  if (_iSize != 0) {
+    AddMemoryStructure(_pMapped != nullptr ? "Mapped input file" : "Input file buffer", _iSize);
+  }
+
+  if (_pMapped != nullptr) {
+    UnmapViewOfFile(_pMapped);
+  }
+
+  if (_hMapping != nullptr) {
+    CloseHandle((HANDLE)_hMapping);
+  }
+
+  if (_hFile != nullptr) {
+    CloseHandle((HANDLE)_hFile);
+  }
+
+  _pMapped = _hMapping = _hFile = nullptr;
+  _pchData = "";
+  _iSize = 0;
+
+  std::vector<c8>().swap(_aBuffer);
+};
+
+#else
+
+// Map the opened file into memory
+bool CInputFile::Map(void *hFile, u64 iFileSize) {
+  // Too big for the address space
+  if (iFileSize > (u64)(size_t)-1) {
+    return false;
+  }
+
+  const int iFile = (int)(size_t)hFile;
+  void *pView = mmap(nullptr, (size_t)iFileSize, PROT_READ, MAP_PRIVATE, iFile, 0);
+
+  if (pView == MAP_FAILED) {
+    return false;
+  }
+
+  // Files are always parsed from start to end
+  madvise(pView, (size_t)iFileSize, MADV_SEQUENTIAL);
+
+  _pMapped = pView;
+  _pchData = (const c8 *)pView;
+  _iSize = (size_t)iFileSize;
+  return true;
+};
+
+// Open the file for reading (returns false if it can't be opened)
+bool CInputFile::TryOpen(const Str_t &strFile) {
+  Close();
+
+  const int iFile = open(strFile.c_str(), O_RDONLY);
+
+  if (iFile < 0) {
+    return false;
+  }
+
+  // Map regular files that aren't empty
+  struct stat st;
+  bool bMapped = false;
+
+  if (fstat(iFile, &st) == 0 && S_ISREG(st.st_mode)) {
+    bMapped = (st.st_size == 0 || Map((void *)(size_t)iFile, (u64)st.st_size));
+  }
+
+  // Read everything into the buffer
+  while (!bMapped) {
+    const size_t iOffset = _aBuffer.size();
+    _aBuffer.resize(iOffset + INPUT_READ_BLOCK);
+
+    const ssize_t iRead = read(iFile, &_aBuffer[iOffset], INPUT_READ_BLOCK);
+
+    if (iRead <= 0) {
+      _aBuffer.resize(iOffset);
+      break;
+    }
+
+    _aBuffer.resize(iOffset + (size_t)iRead);
+  }
+
+  if (!_aBuffer.empty()) {
+    _pchData = &_aBuffer[0];
+    _iSize = _aBuffer.size();
+  }
+
+  // Mapping stays valid without the descriptor
+  close(iFile);
+  return true;
+};
+
+// Release the file contents
+void CInputFile::Close(void) {
+  if (_iSize != 0) {
+    AddMemoryStructure(_pMapped != nullptr ? "Mapped input file" : "Input file buffer", _iSize);
+  }
+
+  if (_pMapped != nullptr) {
+    munmap(_pMapped, _iSize);
+  }
+
+  _pMapped = nullptr;
+  _pchData = "";
+  _iSize = 0;
+
+  std::vector<c8>().swap(_aBuffer);
+};
+
+#endif
+
+// Open the file for reading (throws an exception if it can't be opened)
+void CInputFile::Open(const Str_t &strFile) {
+  if (!TryOpen(strFile)) {
+    CMessageException::Throw("Cannot open file '%s'", strFile.c_str());
+  }
+};
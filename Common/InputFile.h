@@ -0,0 +1,73 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_INPUTFILE_H
+#define _COMMON_INPUTFILE_H
+
+// Read-only view of the whole file contents
+// Regular files are mapped into memory and everything else (e.g. pipes) is read into a buffer
+class CInputFile {
+  private:
+    const c8 *_pchData;
+    size_t _iSize;
+
+    void *_pMapped;  // Start of the mapped memory
+    void *_hFile;    // File handle (Windows only)
+    void *_hMapping; // File mapping handle (Windows only)
+
+    std::vector<c8> _aBuffer; // File contents if it couldn't be mapped
+
+  private:
+    // Not copyable
+    CInputFile(const CInputFile &);
+    CInputFile &operator=(const CInputFile &);
+
+    // Map the opened file into memory
+    bool Map(void *hFile, u64 iFileSize);
+
+  public:
+    CInputFile(void);
+    ~CInputFile(void);
+
+    // Open the file for reading (returns false if it can't be opened)
+    bool TryOpen(const Str_t &strFile);
+
+    // Open the file for reading (throws an exception if it can't be opened)
+    void Open(const Str_t &strFile);
+
+    // Release the file contents
+    void Close(void);
+
+    inline const c8 *GetData(void) const {
+      return _pchData;
+    };
+
+    inline size_t GetSize(void) const {
+      return _iSize;
+    };
+
+    // Check if the file is mapped into memory instead of being read
+    inline bool IsMapped(void) const {
+      return _pMapped != nullptr;
+    };
+};
+
+#endif
@@ -0,0 +1,136 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Common/MemoryStats.h"
+
+#include "Common/Platform.h"
+
+#include <new>
+#include <stdlib.h>
+
+// Totals of the counting allocator
+static volatile u64 _ctAllocations = 0;
+static volatile u64 _iAllocated = 0;
+static volatile u64 _iLive = 0; // Wraps around if blocks from before the start are freed
+static volatile u64 _iPeakLive = 0;
+
+// Count a newly allocated block
+static inline void CountAllocation(void *pBlock) {
+  const u64 iSize = GetAllocationSize(pBlock);
+
+  AtomicAdd(_ctAllocations, 1);
+  AtomicAdd(_iAllocated, iSize);
+  const u64 iLive = AtomicAdd(_iLive, iSize);
+
+  // Skip the amount while it's below zero
+  if ((s64)iLive > 0) AtomicMax(_iPeakLive, iLive);
+};
+
+// Allocate a block and count it
+static inline void *AllocateBlock(size_t iSize) {
+  void *pBlock = malloc(iSize != 0 ? iSize : 1);
+
+  if (pBlock != nullptr && _bMemoryStats) {
+    CountAllocation(pBlock);
+  }
+
+  return pBlock;
+};
+
+// Free a block and stop counting it
+static inline void FreeBlock(void *pBlock) {
+  if (pBlock == nullptr) {
+    return;
+  }
+
+  if (_bMemoryStats) {
+    AtomicAdd(_iLive, 0 - (u64)GetAllocationSize(pBlock));
+  }
+
+  free(pBlock);
+};
+
+#if MEMORY_HOOK
+
+// Counting allocator hook
+// Blocks are taken straight from malloc(), so their sizes can be retrieved upon freeing without any headers
+void *operator new(size_t iSize) {
+  void *pBlock = AllocateBlock(iSize);
+
+  if (pBlock == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  return pBlock;
+};
+
+void *operator new[](size_t iSize) {
+  void *pBlock = AllocateBlock(iSize);
+
+  if (pBlock == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  return pBlock;
+};
+
+void *operator new(size_t iSize, const std::nothrow_t &) noexcept {
+  return AllocateBlock(iSize);
+};
+
+void *operator new[](size_t iSize, const std::nothrow_t &) noexcept {
+  return AllocateBlock(iSize);
+};
+
+void operator delete(void *pBlock) noexcept {
+  FreeBlock(pBlock);
+};
+
+void operator delete[](void *pBlock) noexcept {
+  FreeBlock(pBlock);
+};
+
+void operator delete(void *pBlock, const std::nothrow_t &) noexcept {
+  FreeBlock(pBlock);
+};
+
+void operator delete[](void *pBlock, const std::nothrow_t &) noexcept {
+  FreeBlock(pBlock);
+};
+
+// Sizes of blocks are retrieved from malloc() either way
+void operator delete(void *pBlock, size_t) noexcept {
+  FreeBlock(pBlock);
+};
+
+void operator delete[](void *pBlock, size_t) noexcept {
+  FreeBlock(pBlock);
+};
+
+#endif // MEMORY_HOOK
+
+void GetMemoryCounters(MemoryCounters &counters) {
+  counters.ctAllocations = _ctAllocations;
+  counters.iAllocated = _iAllocated;
+  counters.iLive = _iLive;
+  counters.iPeakLive = _iPeakLive;
+};
@@ -0,0 +1,256 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Common/MemoryStats.h"
+
+#include "Common/OutputFile.h"
+#include "Common/Platform.h"
+
+bool _bMemoryStats = false;
+
+// Sizes of one data structure
+struct MemoryStructure {
+  u64 ctSamples;
+  u64 iLargest;
+  u64 iTotal;
+};
+
+// Allocations in one stage
+struct MemoryStage {
+  u64 ctCalls;
+  u64 ctAllocations;
+  u64 iAllocated;
+  s64 iRetained;  // Bytes that haven't been freed by the end of the stage
+  u64 iPeakRSS;   // Peak physical memory of the process sampled at the end of the stage
+};
+
+static std::map<Str_t, MemoryStructure> _mapMemoryStructures;
+static std::map<Str_t, MemoryStage> _mapMemoryStages;
+static Strings_t _aMemoryStageOrder; // Stages in the order they have been finished for the first time
+static CMutex _mxMemoryStats;
+
+static Str_t _strMemoryFile;
+
+void StartMemoryStats(const Str_t &strFile) {
+  _strMemoryFile = strFile;
+  _bMemoryStats = true;
+};
+
+void AddMemoryStructure(const c8 *strName, u64 iBytes) {
+  if (!_bMemoryStats) {
+    return;
+  }
+
+  CMutexLock lock(_mxMemoryStats);
+
+  std::map<Str_t, MemoryStructure>::iterator it = _mapMemoryStructures.find(strName);
+
+  if (it == _mapMemoryStructures.end()) {
+    MemoryStructure structure;
+    structure.ctSamples = 0;
+    structure.iLargest = 0;
+    structure.iTotal = 0;
+
+    it = _mapMemoryStructures.insert(std::make_pair(Str_t(strName), structure)).first;
+  }
+
+  MemoryStructure &structure = it->second;
+  structure.ctSamples++;
+  structure.iTotal += iBytes;
+
+  if (iBytes > structure.iLargest) {
+    structure.iLargest = iBytes;
+  }
+};
+
+void AddMemoryStage(const c8 *strName, const MemoryCounters &countersStart) {
+  MemoryCounters counters;
+  GetMemoryCounters(counters);
+
+  const u64 iPeakRSS = GetPeakMemory();
+
+  CMutexLock lock(_mxMemoryStats);
+
+  std::map<Str_t, MemoryStage>::iterator it = _mapMemoryStages.find(strName);
+
+  if (it == _mapMemoryStages.end()) {
+    MemoryStage stage;
+    stage.ctCalls = 0;
+    stage.ctAllocations = 0;
+    stage.iAllocated = 0;
+    stage.iRetained = 0;
+    stage.iPeakRSS = 0;
+
+    it = _mapMemoryStages.insert(std::make_pair(Str_t(strName), stage)).first;
+    _aMemoryStageOrder.push_back(strName);
+  }
+
+  MemoryStage &stage = it->second;
+  stage.ctCalls++;
+  stage.ctAllocations += counters.ctAllocations - countersStart.ctAllocations;
+  stage.iAllocated += counters.iAllocated - countersStart.iAllocated;
+  stage.iRetained += (s64)(counters.iLive - countersStart.iLive);
+
+  if (iPeakRSS > stage.iPeakRSS) {
+    stage.iPeakRSS = iPeakRSS;
+  }
+};
+
+// Format amount of bytes for reading
+static Str_t FormatBytes(f64 fBytes) {
+  static const c8 *astrUnits[] = { "B", "KB", "MB", "GB", "TB" };
+  const bool bNegative = (fBytes < 0.0);
+  fBytes = fabs(fBytes);
+
+  s32 iUnit = 0;
+
+  while (fBytes >= 1024.0 && iUnit < 4) {
+    fBytes /= 1024.0;
+    ++iUnit;
+  }
+
+  c8 strBytes[32];
+  sprintf(strBytes, (iUnit == 0 ? "%s%.0f %s" : "%s%.2f %s"), (bNegative ? "-" : ""), fBytes, astrUnits[iUnit]);
+  return strBytes;
+};
+
+// Write string as a JSON value
+static void WriteMemoryString(COutputFile &file, const Str_t &str) {
+  file << '"';
+
+  for (size_t iChar = 0; iChar < str.size(); ++iChar) {
+    const c8 ch = str[iChar];
+
+    if (ch == '"' || ch == '\\') {
+      file << '\\' << ch;
+
+    } else if ((u8)ch < 0x20) {
+      c8 strEscape[8];
+      sprintf(strEscape, "\\u%04x", (u32)(u8)ch);
+      file << strEscape;
+
+    } else {
+      file << ch;
+    }
+  }
+
+  file << '"';
+};
+
+// Print the report for reading
+static void PrintMemoryReport(const MemoryCounters &counters, u64 iPeakLive, u64 iPeakRSS) {
+  std::cout << "\nMemory report:\n";
+  std::cout << "  Allocations: " << counters.ctAllocations << " (" << FormatBytes((f64)counters.iAllocated) << ")\n";
+  std::cout << "  Peak allocated memory: " << FormatBytes((f64)iPeakLive) << '\n';
+  std::cout << "  Peak physical memory: " << FormatBytes((f64)iPeakRSS) << '\n';
+
+  std::cout << "\n  Data structures (largest / total / samples):\n";
+  std::map<Str_t, MemoryStructure>::const_iterator itStructure;
+
+  for (itStructure = _mapMemoryStructures.begin(); itStructure != _mapMemoryStructures.end(); ++itStructure) {
+    const MemoryStructure &structure = itStructure->second;
+
+    c8 strLine[256];
+    sprintf(strLine, "    %-32s %12s %12s %8llu\n", itStructure->first.c_str(), FormatBytes((f64)structure.iLargest).c_str(),
+      FormatBytes((f64)structure.iTotal).c_str(), (unsigned long long)structure.ctSamples);
+    std::cout << strLine;
+  }
+
+  std::cout << "\n  Stages (calls / allocations / allocated / retained / peak physical memory):\n";
+
+  for (size_t iStage = 0; iStage < _aMemoryStageOrder.size(); ++iStage) {
+    const Str_t &strName = _aMemoryStageOrder[iStage];
+    const MemoryStage &stage = _mapMemoryStages[strName];
+
+    c8 strLine[256];
+    sprintf(strLine, "    %-32s %6llu %10llu %12s %12s %12s\n", strName.c_str(), (unsigned long long)stage.ctCalls,
+      (unsigned long long)stage.ctAllocations, FormatBytes((f64)stage.iAllocated).c_str(),
+      FormatBytes((f64)stage.iRetained).c_str(), FormatBytes((f64)stage.iPeakRSS).c_str());
+    std::cout << strLine;
+  }
+};
+
+// Write the report into the file
+static void WriteMemoryFile(const MemoryCounters &counters, u64 iPeakLive, u64 iPeakRSS) {
+  COutputFile file;
+  file.Open(_strMemoryFile);
+
+  file << "{\n\"allocator\":{\"allocations\":" << counters.ctAllocations << ",\"allocatedBytes\":" << counters.iAllocated
+       << ",\"peakAllocatedBytes\":" << iPeakLive << ",\"peakPhysicalBytes\":" << iPeakRSS << "},\n";
+
+  file << "\"structures\":[";
+  std::map<Str_t, MemoryStructure>::const_iterator itStructure;
+
+  for (itStructure = _mapMemoryStructures.begin(); itStructure != _mapMemoryStructures.end(); ++itStructure) {
+    const MemoryStructure &structure = itStructure->second;
+
+    file << (itStructure == _mapMemoryStructures.begin() ? "\n" : ",\n") << "{\"name\":";
+    WriteMemoryString(file, itStructure->first);
+    file << ",\"samples\":" << structure.ctSamples << ",\"largestBytes\":" << structure.iLargest << ",\"totalBytes\":" << structure.iTotal << "}";
+  }
+
+  file << "\n],\n\"stages\":[";
+
+  for (size_t iStage = 0; iStage < _aMemoryStageOrder.size(); ++iStage) {
+    const Str_t &strName = _aMemoryStageOrder[iStage];
+    const MemoryStage &stage = _mapMemoryStages[strName];
+
+    file << (iStage == 0 ? "\n" : ",\n") << "{\"name\":";
+    WriteMemoryString(file, strName);
+    file << ",\"calls\":" << stage.ctCalls << ",\"allocations\":" << stage.ctAllocations << ",\"allocatedBytes\":" << stage.iAllocated
+         << ",\"retainedBytes\":" << stage.iRetained << ",\"peakPhysicalBytes\":" << stage.iPeakRSS << "}";
+  }
+
+  file << "\n]\n}\n";
+  file.Close();
+
+  std::cout << "\nWritten memory report into " << _strMemoryFile << '\n';
+};
+
+void FinishMemoryStats(void) {
+  if (!_bMemoryStats) {
+    return;
+  }
+
+  MemoryCounters counters;
+  GetMemoryCounters(counters);
+
+  const u64 iPeakLive = counters.iPeakLive;
+  const u64 iPeakRSS = GetPeakMemory();
+
+  // Report itself isn't counted
+  _bMemoryStats = false;
+
+  CMutexLock lock(_mxMemoryStats);
+  PrintMemoryReport(counters, iPeakLive, iPeakRSS);
+
+  try {
+    WriteMemoryFile(counters, iPeakLive, iPeakRSS);
+
+  } catch (CException &ex) {
+    std::cout << "Error: " << ex.What() << '\n';
+  }
+
+  _mapMemoryStructures.clear();
+  _mapMemoryStages.clear();
+  _aMemoryStageOrder.clear();
+};
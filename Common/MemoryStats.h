@@ -0,0 +1,68 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_MEMORYSTATS_H
+#define _COMMON_MEMORYSTATS_H
+
+// Replace global operator new and operator delete with ones that count allocations
+// They check whether memory accounting has been started on every allocation, so define as 0 to keep the ones of the runtime
+#ifndef MEMORY_HOOK
+  #define MEMORY_HOOK 1
+#endif
+
+// Counting of allocations and sizes of data structures (only when memory accounting has been started)
+extern bool _bMemoryStats;
+
+// Totals of the counting allocator since memory accounting has been started
+struct MemoryCounters {
+  u64 ctAllocations; // Allocated blocks
+  u64 iAllocated;    // Bytes in allocated blocks
+  u64 iLive;         // Bytes in blocks that haven't been freed yet
+  u64 iPeakLive;     // Most bytes in blocks that haven't been freed at the same time
+};
+
+// Get current totals of the counting allocator (counted by the global operator new and operator delete)
+void GetMemoryCounters(MemoryCounters &counters);
+
+// Start counting allocations for writing a report into a file later
+void StartMemoryStats(const Str_t &strFile);
+
+// Print the report, write it into the file in JSON format and stop counting
+void FinishMemoryStats(void);
+
+// Add size of a data structure (the largest and the total size are reported for each name)
+void AddMemoryStructure(const c8 *strName, u64 iBytes);
+
+// Add allocations that have been made since the start of a stage
+void AddMemoryStage(const c8 *strName, const MemoryCounters &countersStart);
+
+// Bytes reserved for the array elements
+template<class Type> inline
+u64 GetArrayBytes(const std::vector<Type> &aArray) {
+  return (u64)aArray.capacity() * sizeof(Type);
+};
+
+// Bits are packed together
+inline u64 GetArrayBytes(const std::vector<bool> &aBits) {
+  return ((u64)aBits.capacity() + 7) / 8;
+};
+
+#endif
@@ -0,0 +1,1197 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Common/NumberFormat.h"
+#include "Common/Platform.h"
+#include "Common/WideMath.h"
+
+#include <string.h>
+
+s32 _iFloatDigits = 6;
+
+// Bits of double precision numbers
+#define DOUBLE_MANTISSA_BITS 52
+#define DOUBLE_EXPONENT_BIAS 1023
+
+// Precision of the power tables below
+#define FORMAT_POW5_BITS 125
+#define FORMAT_INV_POW5_COUNT 342
+#define FORMAT_POW5_COUNT 326
+
+// Inverse powers of five (floor(2^(bits(5^i) - 1 + 125) / 5^i) + 1) as low and high halves
+static const u64 _aiInvPowersOfFive[FORMAT_INV_POW5_COUNT][2] = {
+  { U64_C(0x0000000000000001), U64_C(0x2000000000000000) }, // 5^-0
+  { U64_C(0x999999999999999A), U64_C(0x1999999999999999) }, // 5^-1
+  { U64_C(0x47AE147AE147AE15), U64_C(0x147AE147AE147AE1) }, // 5^-2
+  { U64_C(0x6C8B4395810624DE), U64_C(0x10624DD2F1A9FBE7) }, // 5^-3
+  { U64_C(0x7A786C226809D496), U64_C(0x1A36E2EB1C432CA5) }, // 5^-4
+  { U64_C(0x61F9F01B866E43AB), U64_C(0x14F8B588E368F084) }, // 5^-5
+  { U64_C(0xB4C7F34938583622), U64_C(0x10C6F7A0B5ED8D36) }, // 5^-6
+  { U64_C(0x87A6520EC08D236A), U64_C(0x1AD7F29ABCAF4857) }, // 5^-7
+  { U64_C(0x9FB841A566D74F88), U64_C(0x15798EE2308C39DF) }, // 5^-8
+  { U64_C(0xE62D01511F12A607), U64_C(0x112E0BE826D694B2) }, // 5^-9
+  { U64_C(0xD6AE6881CB5109A4), U64_C(0x1B7CDFD9D7BDBAB7) }, // 5^-10
+  { U64_C(0xDEF1ED34A2A73AEA), U64_C(0x15FD7FE17964955F) }, // 5^-11
+  { U64_C(0x7F27F0F6E885C8BB), U64_C(0x119799812DEA1119) }, // 5^-12
+  { U64_C(0x650CB4BE40D60DF8), U64_C(0x1C25C268497681C2) }, // 5^-13
+  { U64_C(0xEA70909833DE7193), U64_C(0x16849B86A12B9B01) }, // 5^-14
+  { U64_C(0x21F3A6E0297EC143), U64_C(0x1203AF9EE756159B) }, // 5^-15
+  { U64_C(0x6985D7CD0F313537), U64_C(0x1CD2B297D889BC2B) }, // 5^-16
+  { U64_C(0x2137DFD73F5A90F9), U64_C(0x170EF54646D49689) }, // 5^-17
+  { U64_C(0xE75FE645CC4873FA), U64_C(0x12725DD1D243ABA0) }, // 5^-18
+  { U64_C(0xA5663D3C7A0D865D), U64_C(0x1D83C94FB6D2AC34) }, // 5^-19
+  { U64_C(0x511E976394D79EB1), U64_C(0x179CA10C9242235D) }, // 5^-20
+  { U64_C(0xDA7EDF82DD794BC1), U64_C(0x12E3B40A0E9B4F7D) }, // 5^-21
+  { U64_C(0x2A6498D1625BAC68), U64_C(0x1E392010175EE596) }, // 5^-22
+  { U64_C(0xEEB6E0A781E2F053), U64_C(0x182DB34012B25144) }, // 5^-23
+  { U64_C(0x58924D52CE4F26A9), U64_C(0x1357C299A88EA76A) }, // 5^-24
+  { U64_C(0x27507BB7B07EA441), U64_C(0x1EF2D0F5DA7DD8AA) }, // 5^-25
+  { U64_C(0x52A6C95FC0655034), U64_C(0x18C240C4AECB13BB) }, // 5^-26
+  { U64_C(0x0EEBD44C99EAA690), U64_C(0x13CE9A36F23C0FC9) }, // 5^-27
+  { U64_C(0xB17953ADC3110A80), U64_C(0x1FB0F6BE50601941) }, // 5^-28
+  { U64_C(0xC12DDC8B02740867), U64_C(0x195A5EFEA6B34767) }, // 5^-29
+  { U64_C(0x3424B06F3529A052), U64_C(0x14484BFEEBC29F86) }, // 5^-30
+  { U64_C(0x901D59F290EE19DB), U64_C(0x1039D66589687F9E) }, // 5^-31
+  { U64_C(0x4CFBC31DB4B0295F), U64_C(0x19F623D5A8A73297) }, // 5^-32
+  { U64_C(0x3D9635B15D59BAB2), U64_C(0x14C4E977BA1F5BAC) }, // 5^-33
+  { U64_C(0x97AB5E277DE16228), U64_C(0x109D8792FB4C4956) }, // 5^-34
+  { U64_C(0xF2ABC9D8C9689D0D), U64_C(0x1A95A5B7F87A0EF0) }, // 5^-35
+  { U64_C(0x5BBCA17A3ABA173E), U64_C(0x154484932D2E725A) }, // 5^-36
+  { U64_C(0xAFCA1AC82EFB45CB), U64_C(0x11039D428A8B8EAE) }, // 5^-37
+  { U64_C(0xB2DCF7A6B1920945), U64_C(0x1B38FB9DAA78E44A) }, // 5^-38
+  { U64_C(0xF57D92EBC141A104), U64_C(0x15C72FB1552D836E) }, // 5^-39
+  { U64_C(0xC46475896767B403), U64_C(0x116C262777579C58) }, // 5^-40
+  { U64_C(0x6D6D88DBD8A5ECD2), U64_C(0x1BE03D0BF225C6F4) }, // 5^-41
+  { U64_C(0x8ABE071646EB23DB), U64_C(0x164CFDA3281E38C3) }, // 5^-42
+  { U64_C(0x6EFE6C11D255B649), U64_C(0x11D7314F534B609C) }, // 5^-43
+  { U64_C(0xB197134FB6EF8A0E), U64_C(0x1C8B821885456760) }, // 5^-44
+  { U64_C(0x27AC0F72F8BFA1A5), U64_C(0x16D601AD376AB91A) }, // 5^-45
+  { U64_C(0xB95672C260994E1E), U64_C(0x1244CE242C5560E1) }, // 5^-46
+  { U64_C(0xF5571E03CDC21695), U64_C(0x1D3AE36D13BBCE35) }, // 5^-47
+  { U64_C(0x2AAC18030B01ABAB), U64_C(0x17624F8A762FD82B) }, // 5^-48
+  { U64_C(0xBBBCE0026F348956), U64_C(0x12B50C6EC4F31355) }, // 5^-49
+  { U64_C(0x92C7CCD0B1EDA889), U64_C(0x1DEE7A4AD4B81EEF) }, // 5^-50
+  { U64_C(0xDBD30A408E57BA07), U64_C(0x17F1FB6F10934BF2) }, // 5^-51
+  { U64_C(0x7CA8D50071DFC806), U64_C(0x1327FC58DA0F6FF5) }, // 5^-52
+  { U64_C(0xFAA7BB33E9660CD6), U64_C(0x1EA6608E29B24CBB) }, // 5^-53
+  { U64_C(0x9552FC298784D711), U64_C(0x18851A0B548EA3C9) }, // 5^-54
+  { U64_C(0xAAA8C9BAD2D0AC0E), U64_C(0x139DAE6F76D88307) }, // 5^-55
+  { U64_C(0xDDDADC5E1E1AACE3), U64_C(0x1F62B0B257C0D1A5) }, // 5^-56
+  { U64_C(0x7E48B04B4B488A4F), U64_C(0x191BC08EAC9A4151) }, // 5^-57
+  { U64_C(0xCB6D59D5D5D3A1D9), U64_C(0x141633A556E1CDDA) }, // 5^-58
+  { U64_C(0x3C577B1177DC817B), U64_C(0x1011C2EAABE7D7E2) }, // 5^-59
+  { U64_C(0xC6F25E825960CF2A), U64_C(0x19B604AAACA62636) }, // 5^-60
+  { U64_C(0x6BF518684780A5BB), U64_C(0x14919D5556EB51C5) }, // 5^-61
+  { U64_C(0x232A79ED06008496), U64_C(0x10747DDDDF22A7D1) }, // 5^-62
+  { U64_C(0xD1DD8FE1A3340756), U64_C(0x1A53FC9631D10C81) }, // 5^-63
+  { U64_C(0xA7E4731AE8F66C45), U64_C(0x150FFD44F4A73D34) }, // 5^-64
+  { U64_C(0x531D28E253F8569E), U64_C(0x10D9976A5D52975D) }, // 5^-65
+  { U64_C(0xEB61DB03B98D5762), U64_C(0x1AF5BF109550F22E) }, // 5^-66
+  { U64_C(0xBC4E48CFC7A445E8), U64_C(0x159165A6DDDA5B58) }, // 5^-67
+  { U64_C(0x6371D3D96C836B20), U64_C(0x11411E1F17E1E2AD) }, // 5^-68
+  { U64_C(0x9F1C8628AD9F11CD), U64_C(0x1B9B6364F3030448) }, // 5^-69
+  { U64_C(0xE5B06B53BE18DB0B), U64_C(0x1615E91D8F359D06) }, // 5^-70
+  { U64_C(0xEAF3890FCB4715A2), U64_C(0x11AB20E472914A6B) }, // 5^-71
+  { U64_C(0x44B8DB4C7871BC37), U64_C(0x1C45016D841BAA46) }, // 5^-72
+  { U64_C(0x03C715D6C6C1635F), U64_C(0x169D9ABE03495505) }, // 5^-73
+  { U64_C(0x3638DE456BCDE919), U64_C(0x1217AEFE69077737) }, // 5^-74
+  { U64_C(0x56C163A2461641C1), U64_C(0x1CF2B1970E725858) }, // 5^-75
+  { U64_C(0xDF011C81D1AB67CE), U64_C(0x17288E1271F51379) }, // 5^-76
+  { U64_C(0x7F3416CE4155ECA5), U64_C(0x1286D80EC190DC61) }, // 5^-77
+  { U64_C(0x6520247D3556476E), U64_C(0x1DA48CE468E7C702) }, // 5^-78
+  { U64_C(0xEA801D30F7783925), U64_C(0x17B6D71D20B96C01) }, // 5^-79
+  { U64_C(0xBB99B0F3F92CFA84), U64_C(0x12F8AC174D612334) }, // 5^-80
+  { U64_C(0x5F5C4E532847F739), U64_C(0x1E5AACF215683854) }, // 5^-81
+  { U64_C(0x7F7D0B75B9D32C2E), U64_C(0x18488A5B44536043) }, // 5^-82
+  { U64_C(0x9930D5F7C7DC2358), U64_C(0x136D3B7C36A919CF) }, // 5^-83
+  { U64_C(0x8EB4898C72F9D226), U64_C(0x1F152BF9F10E8FB2) }, // 5^-84
+  { U64_C(0x722A07A38F2E41B8), U64_C(0x18DDBCC7F40BA628) }, // 5^-85
+  { U64_C(0xC1BB394FA5BE9AFA), U64_C(0x13E497065CD61E86) }, // 5^-86
+  { U64_C(0x9C5EC2190930F7F6), U64_C(0x1FD424D6FAF030D7) }, // 5^-87
+  { U64_C(0x49E56814075A5FF8), U64_C(0x197683DF2F268D79) }, // 5^-88
+  { U64_C(0x6E51201005E1E660), U64_C(0x145ECFE5BF520AC7) }, // 5^-89
+  { U64_C(0xF1DA800CD181851A), U64_C(0x104BD984990E6F05) }, // 5^-90
+  { U64_C(0x4FC400148268D4F5), U64_C(0x1A12F5A0F4E3E4D6) }, // 5^-91
+  { U64_C(0xD96999AA01ED772B), U64_C(0x14DBF7B3F71CB711) }, // 5^-92
+  { U64_C(0xADEE1488018AC5BC), U64_C(0x10AFF95CC5B09274) }, // 5^-93
+  { U64_C(0x497CEDA668DE092C), U64_C(0x1AB328946F80EA54) }, // 5^-94
+  { U64_C(0x3ACA57B853E4D424), U64_C(0x155C2076BF9A5510) }, // 5^-95
+  { U64_C(0x623B7960431D7683), U64_C(0x1116805EFFAEAA73) }, // 5^-96
+  { U64_C(0x9D2BF566D1C8BD9E), U64_C(0x1B5733CB32B110B8) }, // 5^-97
+  { U64_C(0x7DBCC452416D647F), U64_C(0x15DF5CA28EF40D60) }, // 5^-98
+  { U64_C(0xCAFD69DB678AB6CC), U64_C(0x117F7D4ED8C33DE6) }, // 5^-99
+  { U64_C(0xAB2F0FC572778ADF), U64_C(0x1BFF2EE48E052FD7) }, // 5^-100
+  { U64_C(0x88F273045B92D580), U64_C(0x1665BF1D3E6A8CAC) }, // 5^-101
+  { U64_C(0xD3F528D049424466), U64_C(0x11EAFF4A98553D56) }, // 5^-102
+  { U64_C(0xB988414D4203A0A3), U64_C(0x1CAB3210F3BB9557) }, // 5^-103
+  { U64_C(0x6139CDD76802E6E9), U64_C(0x16EF5B40C2FC7779) }, // 5^-104
+  { U64_C(0xE761717920025254), U64_C(0x125915CD68C9F92D) }, // 5^-105
+  { U64_C(0xA568B58E999D5086), U64_C(0x1D5B561574765B7C) }, // 5^-106
+  { U64_C(0x5120913EE14AA6D2), U64_C(0x177C44DDF6C515FD) }, // 5^-107
+  { U64_C(0xA74D40FF1AA21F0E), U64_C(0x12C9D0B1923744CA) }, // 5^-108
+  { U64_C(0x0BAECE64F769CB4A), U64_C(0x1E0FB44F50586E11) }, // 5^-109
+  { U64_C(0x3C8BD850C5EE3C3B), U64_C(0x180C903F7379F1A7) }, // 5^-110
+  { U64_C(0xCA0979DA37F1C9C9), U64_C(0x133D4032C2C7F485) }, // 5^-111
+  { U64_C(0xA9A8C2F6BFE942DB), U64_C(0x1EC866B79E0CBA6F) }, // 5^-112
+  { U64_C(0x2153CF2BCCBA9BE3), U64_C(0x18A0522C7E709526) }, // 5^-113
+  { U64_C(0x1AA9728970954982), U64_C(0x13B374F06526DDB8) }, // 5^-114
+  { U64_C(0xF775840F1A88759D), U64_C(0x1F8587E7083E2F8C) }, // 5^-115
+  { U64_C(0x5F9136727BA05E17), U64_C(0x19379FEC0698260A) }, // 5^-116
+  { U64_C(0x1940F85B9619E4DF), U64_C(0x142C7FF0054684D5) }, // 5^-117
+  { U64_C(0xE100C6AFAB47EA4C), U64_C(0x1023998CD1053710) }, // 5^-118
+  { U64_C(0xCE67A44C453FDD47), U64_C(0x19D28F47B4D524E7) }, // 5^-119
+  { U64_C(0xD852E9D69DCCB106), U64_C(0x14A8729FC3DDB71F) }, // 5^-120
+  { U64_C(0x79DBEE454B0A2738), U64_C(0x1086C219697E2C19) }, // 5^-121
+  { U64_C(0x295FE3A211A9D859), U64_C(0x1A71368F0F30468F) }, // 5^-122
+  { U64_C(0xBAB31C81A7BB137A), U64_C(0x15275ED8D8F36BA5) }, // 5^-123
+  { U64_C(0x6228E39AEC95A92F), U64_C(0x10EC4BE0AD8F8951) }, // 5^-124
+  { U64_C(0x9D0E38F7E0EF7517), U64_C(0x1B13AC9AAF4C0EE8) }, // 5^-125
+  { U64_C(0xB0D82D931A592A79), U64_C(0x15A956E225D67253) }, // 5^-126
+  { U64_C(0x8D79BE0F4847552E), U64_C(0x11544581B7DEC1DC) }, // 5^-127
+  { U64_C(0x158F967EDA0BBB7C), U64_C(0x1BBA08CF8C979C94) }, // 5^-128
+  { U64_C(0x77A611FF14D62F97), U64_C(0x162E6D72D6DFB076) }, // 5^-129
+  { U64_C(0xF951A7FF43DE8C79), U64_C(0x11BEBDF578B2F391) }, // 5^-130
+  { U64_C(0xC21C3FFED2FDAD8E), U64_C(0x1C6463225AB7EC1C) }, // 5^-131
+  { U64_C(0x01B0333242648AD8), U64_C(0x16B6B5B5155FF017) }, // 5^-132
+  { U64_C(0x0159C28E9B83A246), U64_C(0x122BC490DDE659AC) }, // 5^-133
+  { U64_C(0xCEF604175F3903A3), U64_C(0x1D12D41AFCA3C2AC) }, // 5^-134
+  { U64_C(0x725E69AC4C2D9C83), U64_C(0x17424348CA1C9BBD) }, // 5^-135
+  { U64_C(0xF5185489D68AE39C), U64_C(0x129B69070816E2FD) }, // 5^-136
+  { U64_C(0xEE8D540FBDAB05C6), U64_C(0x1DC574D80CF16B2F) }, // 5^-137
+  { U64_C(0xBED77672FE226B05), U64_C(0x17D12A4670C1228C) }, // 5^-138
+  { U64_C(0xFF12C528CB4EBC04), U64_C(0x130DBB6B8D674ED6) }, // 5^-139
+  { U64_C(0xCB513B74787DF9A0), U64_C(0x1E7C5F127BD87E24) }, // 5^-140
+  { U64_C(0x090DC929F9FE614D), U64_C(0x18637F41FCAD31B7) }, // 5^-141
+  { U64_C(0xA0D7D42194CB810A), U64_C(0x1382CC34CA2427C5) }, // 5^-142
+  { U64_C(0x67BFB9CF5478CE77), U64_C(0x1F37AD21436D0C6F) }, // 5^-143
+  { U64_C(0x1FCC94A5DD2D71F9), U64_C(0x18F9574DCF8A7059) }, // 5^-144
+  { U64_C(0x7FD6DD517DBDF4C7), U64_C(0x13FAAC3E3FA1F37A) }, // 5^-145
+  { U64_C(0xFFBE2EE8C92FEE0B), U64_C(0x1FF779FD329CB8C3) }, // 5^-146
+  { U64_C(0x6631BF20A0F324D6), U64_C(0x1992C7FDC216FA36) }, // 5^-147
+  { U64_C(0xB827CC1A1A5C1D78), U64_C(0x14756CCB01ABFB5E) }, // 5^-148
+  { U64_C(0x935309AE7B7CE460), U64_C(0x105DF0A267BCC918) }, // 5^-149
+  { U64_C(0x1EEB42B0C594A099), U64_C(0x1A2FE76A3F9474F4) }, // 5^-150
+  { U64_C(0xE58902270476E6E1), U64_C(0x14F31F8832DD2A5C) }, // 5^-151
+  { U64_C(0xB7A0CE859D2BEBE7), U64_C(0x10C27FA028B0EEB0) }, // 5^-152
+  { U64_C(0x59014A6F61DFDFD8), U64_C(0x1AD0CC33744E4AB4) }, // 5^-153
+  { U64_C(0xE0CDD525E7E64CAD), U64_C(0x1573D68F903EA229) }, // 5^-154
+  { U64_C(0x4D7177518651D6F1), U64_C(0x11297872D9CBB4EE) }, // 5^-155
+  { U64_C(0x7BE8BEE8D6E957E8), U64_C(0x1B758D848FAC54B0) }, // 5^-156
+  { U64_C(0xFCBA3253DF211320), U64_C(0x15F7A46A0C89DD59) }, // 5^-157
+  { U64_C(0x63C8284318E74280), U64_C(0x1192E9EE706E4AAE) }, // 5^-158
+  { U64_C(0x060D0D3827D86A66), U64_C(0x1C1E43171A4A1117) }, // 5^-159
+  { U64_C(0x6B3DA42CECAD21EB), U64_C(0x167E9C127B6E7412) }, // 5^-160
+  { U64_C(0x88FE1CF0BD574E56), U64_C(0x11FEE341FC585CDB) }, // 5^-161
+  { U64_C(0x419694B462254A23), U64_C(0x1CCB0536608D615F) }, // 5^-162
+  { U64_C(0x67ABAA29E81DD4E9), U64_C(0x1708D0F84D3DE77F) }, // 5^-163
+  { U64_C(0xB95621BB2017DD87), U64_C(0x126D73F9D764B932) }, // 5^-164
+  { U64_C(0xC223692B668C95A5), U64_C(0x1D7BECC2F23AC1EA) }, // 5^-165
+  { U64_C(0xCE82BA891ED6DE1D), U64_C(0x179657025B6234BB) }, // 5^-166
+  { U64_C(0xA53562074BDF1818), U64_C(0x12DEAC01E2B4F6FC) }, // 5^-167
+  { U64_C(0x3B889CD87964F359), U64_C(0x1E3113363787F194) }, // 5^-168
+  { U64_C(0xFC6D4A46C783F5E1), U64_C(0x18274291C6065ADC) }, // 5^-169
+  { U64_C(0x30576E9F06032B1A), U64_C(0x13529BA7D19EAF17) }, // 5^-170
+  { U64_C(0x1A257DCB3CD1DE90), U64_C(0x1EEA92A61C311825) }, // 5^-171
+  { U64_C(0x481DFE3C30A7E540), U64_C(0x18BBA884E35A79B7) }, // 5^-172
+  { U64_C(0xD34B31C9C0865100), U64_C(0x13C9539D82AEC7C5) }, // 5^-173
+  { U64_C(0x5211E942CDA3B4CD), U64_C(0x1FA885C8D117A609) }, // 5^-174
+  { U64_C(0x74DB21023E1C90A4), U64_C(0x19539E3A40DFB807) }, // 5^-175
+  { U64_C(0xF715B401CB4A0D50), U64_C(0x1442E4FB67196005) }, // 5^-176
+  { U64_C(0xF8DE299B09080AA7), U64_C(0x103583FC527AB337) }, // 5^-177
+  { U64_C(0x8E304291A80CDDD7), U64_C(0x19EF3993B72AB859) }, // 5^-178
+  { U64_C(0x3E8D020E200A4B13), U64_C(0x14BF6142F8EEF9E1) }, // 5^-179
+  { U64_C(0x653D9B3E80083C0F), U64_C(0x10991A9BFA58C7E7) }, // 5^-180
+  { U64_C(0x6EC8F864000D2CE4), U64_C(0x1A8E90F9908E0CA5) }, // 5^-181
+  { U64_C(0x8BD3F9E999A423EA), U64_C(0x153EDA614071A3B7) }, // 5^-182
+  { U64_C(0x3CA994BAE1501CBB), U64_C(0x10FF151A99F482F9) }, // 5^-183
+  { U64_C(0xC775BAC49BB3612B), U64_C(0x1B31BB5DC320D18E) }, // 5^-184
+  { U64_C(0xD2C4956A16291A89), U64_C(0x15C162B168E70E0B) }, // 5^-185
+  { U64_C(0xDBD0778811BA7BA1), U64_C(0x11678227871F3E6F) }, // 5^-186
+  { U64_C(0x2C80BF401C5D929B), U64_C(0x1BD8D03F3E9863E6) }, // 5^-187
+  { U64_C(0xBD33CC3349E47549), U64_C(0x16470CFF6546B651) }, // 5^-188
+  { U64_C(0xCA8FD68F6E505DD4), U64_C(0x11D270CC51055EA7) }, // 5^-189
+  { U64_C(0x4419574BE3B3C953), U64_C(0x1C83E7AD4E6EFDD9) }, // 5^-190
+  { U64_C(0x0347790982F63AA9), U64_C(0x16CFEC8AA52597E1) }, // 5^-191
+  { U64_C(0xCF6C60D468C4FBBA), U64_C(0x123FF06EEA847980) }, // 5^-192
+  { U64_C(0xE57A34870E07F92A), U64_C(0x1D331A4B10D3F59A) }, // 5^-193
+  { U64_C(0x512E906C0B399422), U64_C(0x175C1508DA432AE2) }, // 5^-194
+  { U64_C(0xDA8BA6BCD5C7A9B5), U64_C(0x12B010D3E1CF5581) }, // 5^-195
+  { U64_C(0x90DF712E22D90F87), U64_C(0x1DE6815302E5559C) }, // 5^-196
+  { U64_C(0xDA4C5A8B4F140C6C), U64_C(0x17EB9AA8CF1DDE16) }, // 5^-197
+  { U64_C(0xAEA37BA2A5A9A38A), U64_C(0x1322E220A5B17E78) }, // 5^-198
+  { U64_C(0x7DD25F6AA2A905A9), U64_C(0x1E9E369AA2B59727) }, // 5^-199
+  { U64_C(0x97DB7F888220D154), U64_C(0x187E92154EF7AC1F) }, // 5^-200
+  { U64_C(0x797C6606CE80A777), U64_C(0x139874DDD8C6234C) }, // 5^-201
+  { U64_C(0x8F2D700AE4010BF1), U64_C(0x1F5A549627A36BAD) }, // 5^-202
+  { U64_C(0x0C2459A25000D65A), U64_C(0x191510781FB5EFBE) }, // 5^-203
+  { U64_C(0x701D1481D99A4515), U64_C(0x1410D9F9B2F7F2FE) }, // 5^-204
+  { U64_C(0xC017439B147B6A77), U64_C(0x100D7B2E28C65BFE) }, // 5^-205
+  { U64_C(0xCCF205C4ED9243F2), U64_C(0x19AF2B7D0E0A2CCA) }, // 5^-206
+  { U64_C(0x0A5B37D0BE0E9CC2), U64_C(0x148C22CA71A1BD6F) }, // 5^-207
+  { U64_C(0x0848F973CB3EE3CE), U64_C(0x10701BD527B4978C) }, // 5^-208
+  { U64_C(0xDA0E5BEC78649FB0), U64_C(0x1A4CF9550C5425AC) }, // 5^-209
+  { U64_C(0x7B3EAFF060507FC0), U64_C(0x150A6110D6A9B7BD) }, // 5^-210
+  { U64_C(0x95CBBFF380406633), U64_C(0x10D51A73DEEE2C97) }, // 5^-211
+  { U64_C(0xEFAC665266CD7052), U64_C(0x1AEE90B964B04758) }, // 5^-212
+  { U64_C(0x2623850EB8A459DB), U64_C(0x158BA6FAB6F36C47) }, // 5^-213
+  { U64_C(0x1E82D0D893B6AE49), U64_C(0x113C85955F29236C) }, // 5^-214
+  { U64_C(0xFD9E1AF41F8AB075), U64_C(0x1B9408EEFEA838AC) }, // 5^-215
+  { U64_C(0x97B1AF29B2D559F7), U64_C(0x16100725988693BD) }, // 5^-216
+  { U64_C(0xAC8E25BAF5777B2C), U64_C(0x11A66C1E139EDC97) }, // 5^-217
+  { U64_C(0x7A7D092B2258C513), U64_C(0x1C3D79C9B8FE2DBF) }, // 5^-218
+  { U64_C(0x61FDA0EF4EAD6A76), U64_C(0x169794A160CB57CC) }, // 5^-219
+  { U64_C(0xE7FE1A590BBDEEC5), U64_C(0x1212DD4DE7091309) }, // 5^-220
+  { U64_C(0xA6635D5B45FCB13A), U64_C(0x1CEAFBAFD80E84DC) }, // 5^-221
+  { U64_C(0x851C4AAF6B308DC8), U64_C(0x172262F3133ED0B0) }, // 5^-222
+  { U64_C(0xD0E36EF2BC26D7D4), U64_C(0x1281E8C275CBDA26) }, // 5^-223
+  { U64_C(0xB49F17EAC6A48C86), U64_C(0x1D9CA79D894629D7) }, // 5^-224
+  { U64_C(0x2A18DFEF0550706B), U64_C(0x17B08617A104EE46) }, // 5^-225
+  { U64_C(0x54E0B3259DD9F389), U64_C(0x12F39E794D9D8B6B) }, // 5^-226
+  { U64_C(0x87CDEB6F62F65274), U64_C(0x1E5297287C2F4578) }, // 5^-227
+  { U64_C(0xD30B22BF825EA85D), U64_C(0x18421286C9BF6AC6) }, // 5^-228
+  { U64_C(0x0F3C1BCC684BB9E4), U64_C(0x13680ED23AFF889F) }, // 5^-229
+  { U64_C(0x18602C7A4079296D), U64_C(0x1F0CE4839198DA98) }, // 5^-230
+  { U64_C(0x46B356C833942124), U64_C(0x18D71D360E13E213) }, // 5^-231
+  { U64_C(0x388F78A029434DB6), U64_C(0x13DF4A91A4DCB4DC) }, // 5^-232
+  { U64_C(0x5A7F2766A86BAF8A), U64_C(0x1FCBAA82A1612160) }, // 5^-233
+  { U64_C(0x153285EBB9EFBFA2), U64_C(0x196FBB9BB44DB44D) }, // 5^-234
+  { U64_C(0xAA8ED189618C994E), U64_C(0x145962E2F6A4903D) }, // 5^-235
+  { U64_C(0xEED8A7A11AD6E10C), U64_C(0x1047824F2BB6D9CA) }, // 5^-236
+  { U64_C(0x7E27729B5E249B45), U64_C(0x1A0C03B1DF8AF611) }, // 5^-237
+  { U64_C(0xFE85F549181D4904), U64_C(0x14D6695B193BF80D) }, // 5^-238
+  { U64_C(0xCB9E5DD4134AA0D0), U64_C(0x10AB877C142FF9A4) }, // 5^-239
+  { U64_C(0xDF63C9535211014D), U64_C(0x1AAC0BF9B9E65C3A) }, // 5^-240
+  { U64_C(0x191CA10F74DA6771), U64_C(0x15566FFAFB1EB02F) }, // 5^-241
+  { U64_C(0xADB080D92A4852C1), U64_C(0x1111F32F2F4BC025) }, // 5^-242
+  { U64_C(0x15E7348EAA0D5134), U64_C(0x1B4FEB7EB212CD09) }, // 5^-243
+  { U64_C(0xAB1F5D3EEE710DC4), U64_C(0x15D98932280F0A6D) }, // 5^-244
+  { U64_C(0xBC1917658B8DA49D), U64_C(0x117AD428200C0857) }, // 5^-245
+  { U64_C(0x2CF4F23C127C3A94), U64_C(0x1BF7B9D9CCE00D59) }, // 5^-246
+  { U64_C(0xF0C3F4FCDB969543), U64_C(0x165FC7E170B33DE0) }, // 5^-247
+  { U64_C(0x5A365D9716121103), U64_C(0x11E6398126F5CB1A) }, // 5^-248
+  { U64_C(0x9056FC24F01CE804), U64_C(0x1CA38F350B22DE90) }, // 5^-249
+  { U64_C(0xD9DF301D8CE3ECD0), U64_C(0x16E93F5DA2824BA6) }, // 5^-250
+  { U64_C(0xE17F59B13D8323DA), U64_C(0x125432B14ECEA2EB) }, // 5^-251
+  { U64_C(0x68CBC2B52F38395C), U64_C(0x1D53844EE47DD179) }, // 5^-252
+  { U64_C(0x53D6355DBF602DE3), U64_C(0x177603725064A794) }, // 5^-253
+  { U64_C(0xA9782AB165E68B1C), U64_C(0x12C4CF8EA6B6EC76) }, // 5^-254
+  { U64_C(0x0F26AAB56FD744FA), U64_C(0x1E07B27DD78B13F1) }, // 5^-255
+  { U64_C(0x3F52222ABFDF6A62), U64_C(0x18062864AC6F4327) }, // 5^-256
+  { U64_C(0x65DB4E88997F884E), U64_C(0x1338205089F29C1F) }, // 5^-257
+  { U64_C(0x6FC54A7428CC0D4A), U64_C(0x1EC033B40FEA9365) }, // 5^-258
+  { U64_C(0x596AA1F68709A43B), U64_C(0x1899C2F673220F84) }, // 5^-259
+  { U64_C(0xADEEE7F86C07B696), U64_C(0x13AE3591F5B4D936) }, // 5^-260
+  { U64_C(0x497E3FF3E00C5756), U64_C(0x1F7D228322BAF524) }, // 5^-261
+  { U64_C(0xD464FFF64CD6AC45), U64_C(0x1930E868E89590E9) }, // 5^-262
+  { U64_C(0x4383FFF83D7889D1), U64_C(0x14272053ED4473EE) }, // 5^-263
+  { U64_C(0xCF9CCCC69793A174), U64_C(0x101F4D0FF1038FF1) }, // 5^-264
+  { U64_C(0x7F6147A425B90252), U64_C(0x19CBAE7FE805B31C) }, // 5^-265
+  { U64_C(0xCC4DD2E9B7C7350F), U64_C(0x14A2F1FFECD15C16) }, // 5^-266
+  { U64_C(0x3D0B0F215FD290D9), U64_C(0x10825B3323DAB012) }, // 5^-267
+  { U64_C(0x61AB4B689950E7C1), U64_C(0x1A6A2B85062AB350) }, // 5^-268
+  { U64_C(0x4E22A2BA1440B967), U64_C(0x1521BC6A6B555C40) }, // 5^-269
+  { U64_C(0x0B4EE894DD009453), U64_C(0x10E7C9EEBC4449CD) }, // 5^-270
+  { U64_C(0x1217DA87C800ED51), U64_C(0x1B0C764AC6D3A948) }, // 5^-271
+  { U64_C(0xDB46486CA000BDDA), U64_C(0x15A391D56BDC876C) }, // 5^-272
+  { U64_C(0x490506BD4CCD64AF), U64_C(0x114FA7DDEFE39F8A) }, // 5^-273
+  { U64_C(0xA8080AC87AE23AB1), U64_C(0x1BB2A62FE638FF43) }, // 5^-274
+  { U64_C(0x5339A239FBE82EF4), U64_C(0x162884F31E93FF69) }, // 5^-275
+  { U64_C(0x75C7B4FB2FECF25D), U64_C(0x11BA03F5B20FFF87) }, // 5^-276
+  { U64_C(0x22D92191E647EA2E), U64_C(0x1C5CD322B67FFF3F) }, // 5^-277
+  { U64_C(0xB57A8141850654F2), U64_C(0x16B0A8E891FFFF65) }, // 5^-278
+  { U64_C(0xC4620101373843F5), U64_C(0x1226ED86DB3332B7) }, // 5^-279
+  { U64_C(0x3A366801F1F39FEE), U64_C(0x1D0B15A491EB8459) }, // 5^-280
+  { U64_C(0xFB5EB99B27F6198B), U64_C(0x173C115074BC69E0) }, // 5^-281
+  { U64_C(0x2F7EFAE2865E7AD6), U64_C(0x129674405D6387E7) }, // 5^-282
+  { U64_C(0xE597F7D0D6FD9156), U64_C(0x1DBD86CD6238D971) }, // 5^-283
+  { U64_C(0x8479930D78CADAAB), U64_C(0x17CAD23DE82D7AC1) }, // 5^-284
+  { U64_C(0xD06142712D6F1556), U64_C(0x1308A831868AC89A) }, // 5^-285
+  { U64_C(0x4D686A4EAF182222), U64_C(0x1E74404F3DAADA91) }, // 5^-286
+  { U64_C(0xA453883EF279B4E8), U64_C(0x185D003F6488AEDA) }, // 5^-287
+  { U64_C(0xE9DC6CFF28615D87), U64_C(0x137D99CC506D58AE) }, // 5^-288
+  { U64_C(0xA960AE650D6895A4), U64_C(0x1F2F5C7A1A488DE4) }, // 5^-289
+  { U64_C(0xBAB3BEB73DED4483), U64_C(0x18F2B061AEA07183) }, // 5^-290
+  { U64_C(0x2EF6322C318A9D36), U64_C(0x13F559E7BEE6C136) }, // 5^-291
+  { U64_C(0xE4BD1D13827761F0), U64_C(0x1FEEF63F97D79B89) }, // 5^-292
+  { U64_C(0x83CA7DA9352C4E5A), U64_C(0x198BF832DFDFAFA1) }, // 5^-293
+  { U64_C(0x9CA1FE20F756A515), U64_C(0x146FF9C24CB2F2E7) }, // 5^-294
+  { U64_C(0x4A1B31B3F9121DAA), U64_C(0x1059949B708F28B9) }, // 5^-295
+  { U64_C(0x435EB5ECC1B695DD), U64_C(0x1A28EDC580E50DF5) }, // 5^-296
+  { U64_C(0x35E55E57015EDE4A), U64_C(0x14ED8B04671DA4C4) }, // 5^-297
+  { U64_C(0xC4B77EAC0118B1D5), U64_C(0x10BE08D0527E1D69) }, // 5^-298
+  { U64_C(0xA12597799B5AB622), U64_C(0x1AC9A7B3B7302F0F) }, // 5^-299
+  { U64_C(0x4DB7AC6149155E81), U64_C(0x156E1FC2F8F358D9) }, // 5^-300
+  { U64_C(0xD7C6238107444B9B), U64_C(0x1124E63593F5E0AD) }, // 5^-301
+  { U64_C(0x593D059B3ED3AC2B), U64_C(0x1B6E3D2286563449) }, // 5^-302
+  { U64_C(0xE0FD9E15CBDC89BC), U64_C(0x15F1CA820511C36D) }, // 5^-303
+  { U64_C(0xB3FE18116FE3A163), U64_C(0x118E3B9B37416924) }, // 5^-304
+  { U64_C(0x866359B57FD29BD1), U64_C(0x1C16C5C525357507) }, // 5^-305
+  { U64_C(0xD1E91491330EE30E), U64_C(0x16789E3750F790D2) }, // 5^-306
+  { U64_C(0x74BA76DA8F3F1C0B), U64_C(0x11FA182C40C60D75) }, // 5^-307
+  { U64_C(0xEDF72490E531C678), U64_C(0x1CC359E067A348BB) }, // 5^-308
+  { U64_C(0x8B2C1D40B75B052D), U64_C(0x1702AE4D1FB5D3C9) }, // 5^-309
+  { U64_C(0x6F567DCD5F7C0424), U64_C(0x12688B70E62B0FD4) }, // 5^-310
+  { U64_C(0x7EF0C94898C66D06), U64_C(0x1D74124E3D11B2ED) }, // 5^-311
+  { U64_C(0x98C0A106E09EBD9F), U64_C(0x17900EA4FDA7C257) }, // 5^-312
+  { U64_C(0x470080D24D4BCAE6), U64_C(0x12D9A550CAEC9B79) }, // 5^-313
+  { U64_C(0xD800CE1D487944A2), U64_C(0x1E29088144ADC58E) }, // 5^-314
+  { U64_C(0x1333D8176D2DD082), U64_C(0x1820D39A9D57D13F) }, // 5^-315
+  { U64_C(0xA8F646792424A6CE), U64_C(0x134D76154AACA765) }, // 5^-316
+  { U64_C(0x74BD3D8EA03AA47D), U64_C(0x1EE25688777AA56F) }, // 5^-317
+  { U64_C(0x5D64313EE6955064), U64_C(0x18B51206C5FBB78C) }, // 5^-318
+  { U64_C(0x4AB68DCBEBAAA6B7), U64_C(0x13C40E6BD1962C70) }, // 5^-319
+  { U64_C(0x1124161312AAA457), U64_C(0x1FA01712E8F0471A) }, // 5^-320
+  { U64_C(0xDA8344DC0EEEE9DF), U64_C(0x194CDF4253F36C14) }, // 5^-321
+  { U64_C(0xE2029D7CD8BF2180), U64_C(0x143D7F6843292343) }, // 5^-322
+  { U64_C(0x4E687DFD7A328133), U64_C(0x103132B9CF541C36) }, // 5^-323
+  { U64_C(0x4A40C9959050CEB8), U64_C(0x19E851294BB9C6BD) }, // 5^-324
+  { U64_C(0x0833D477A6A70BC6), U64_C(0x14B9DA876FC7D231) }, // 5^-325
+  { U64_C(0xA02976C61EEC096B), U64_C(0x1094AED2BFD30E8D) }, // 5^-326
+  { U64_C(0x004257A364ACDBDF), U64_C(0x1A877E1DFFB81749) }, // 5^-327
+  { U64_C(0xCD01DFB5EA23E319), U64_C(0x153931B1996012A0) }, // 5^-328
+  { U64_C(0x70CE4C91881CB5AE), U64_C(0x10FA8E27ADE6754D) }, // 5^-329
+  { U64_C(0x1AE3ADB5A69455E2), U64_C(0x1B2A7D0C4970BBAF) }, // 5^-330
+  { U64_C(0x7BE957C4854377E8), U64_C(0x15BB973D078D62F2) }, // 5^-331
+  { U64_C(0xC987796A0435F987), U64_C(0x1162DF64060AB58E) }, // 5^-332
+  { U64_C(0x75A58F1006BCC271), U64_C(0x1BD1656CD67788E4) }, // 5^-333
+  { U64_C(0xF7B7A5A66BCA3527), U64_C(0x16411DF0AB92D3E9) }, // 5^-334
+  { U64_C(0x5FC61E1EBCA1C41F), U64_C(0x11CDB18D560F0FEE) }, // 5^-335
+  { U64_C(0xFFA363646102D365), U64_C(0x1C7C4F4889B1B316) }, // 5^-336
+  { U64_C(0x32E91C504D9BDC51), U64_C(0x16C9D906D48E28DF) }, // 5^-337
+  { U64_C(0x8F20E37371497D0E), U64_C(0x123B140576D820B2) }, // 5^-338
+  { U64_C(0x7E9B0585820F2E7C), U64_C(0x1D2B533BF159CDEA) }, // 5^-339
+  { U64_C(0xCBAF379E01A5BECA), U64_C(0x1755DC2FF447D7EE) }, // 5^-340
+  { U64_C(0x0958F94B348498A1), U64_C(0x12AB168CC36CACBF) }, // 5^-341
+};
+
+// Powers of five (5^i with the top 125 bits) as low and high halves
+static const u64 _aiPowersOfFive[FORMAT_POW5_COUNT][2] = {
+  { U64_C(0x0000000000000000), U64_C(0x1000000000000000) }, // 5^0
+  { U64_C(0x0000000000000000), U64_C(0x1400000000000000) }, // 5^1
+  { U64_C(0x0000000000000000), U64_C(0x1900000000000000) }, // 5^2
+  { U64_C(0x0000000000000000), U64_C(0x1F40000000000000) }, // 5^3
+  { U64_C(0x0000000000000000), U64_C(0x1388000000000000) }, // 5^4
+  { U64_C(0x0000000000000000), U64_C(0x186A000000000000) }, // 5^5
+  { U64_C(0x0000000000000000), U64_C(0x1E84800000000000) }, // 5^6
+  { U64_C(0x0000000000000000), U64_C(0x1312D00000000000) }, // 5^7
+  { U64_C(0x0000000000000000), U64_C(0x17D7840000000000) }, // 5^8
+  { U64_C(0x0000000000000000), U64_C(0x1DCD650000000000) }, // 5^9
+  { U64_C(0x0000000000000000), U64_C(0x12A05F2000000000) }, // 5^10
+  { U64_C(0x0000000000000000), U64_C(0x174876E800000000) }, // 5^11
+  { U64_C(0x0000000000000000), U64_C(0x1D1A94A200000000) }, // 5^12
+  { U64_C(0x0000000000000000), U64_C(0x12309CE540000000) }, // 5^13
+  { U64_C(0x0000000000000000), U64_C(0x16BCC41E90000000) }, // 5^14
+  { U64_C(0x0000000000000000), U64_C(0x1C6BF52634000000) }, // 5^15
+  { U64_C(0x0000000000000000), U64_C(0x11C37937E0800000) }, // 5^16
+  { U64_C(0x0000000000000000), U64_C(0x16345785D8A00000) }, // 5^17
+  { U64_C(0x0000000000000000), U64_C(0x1BC16D674EC80000) }, // 5^18
+  { U64_C(0x0000000000000000), U64_C(0x1158E460913D0000) }, // 5^19
+  { U64_C(0x0000000000000000), U64_C(0x15AF1D78B58C4000) }, // 5^20
+  { U64_C(0x0000000000000000), U64_C(0x1B1AE4D6E2EF5000) }, // 5^21
+  { U64_C(0x0000000000000000), U64_C(0x10F0CF064DD59200) }, // 5^22
+  { U64_C(0x0000000000000000), U64_C(0x152D02C7E14AF680) }, // 5^23
+  { U64_C(0x0000000000000000), U64_C(0x1A784379D99DB420) }, // 5^24
+  { U64_C(0x0000000000000000), U64_C(0x108B2A2C28029094) }, // 5^25
+  { U64_C(0x0000000000000000), U64_C(0x14ADF4B7320334B9) }, // 5^26
+  { U64_C(0x4000000000000000), U64_C(0x19D971E4FE8401E7) }, // 5^27
+  { U64_C(0x8800000000000000), U64_C(0x1027E72F1F128130) }, // 5^28
+  { U64_C(0xAA00000000000000), U64_C(0x1431E0FAE6D7217C) }, // 5^29
+  { U64_C(0xD480000000000000), U64_C(0x193E5939A08CE9DB) }, // 5^30
+  { U64_C(0xC9A0000000000000), U64_C(0x1F8DEF8808B02452) }, // 5^31
+  { U64_C(0xBE04000000000000), U64_C(0x13B8B5B5056E16B3) }, // 5^32
+  { U64_C(0xAD85000000000000), U64_C(0x18A6E32246C99C60) }, // 5^33
+  { U64_C(0xD8E6400000000000), U64_C(0x1ED09BEAD87C0378) }, // 5^34
+  { U64_C(0x878FE80000000000), U64_C(0x13426172C74D822B) }, // 5^35
+  { U64_C(0x6973E20000000000), U64_C(0x1812F9CF7920E2B6) }, // 5^36
+  { U64_C(0x03D0DA8000000000), U64_C(0x1E17B84357691B64) }, // 5^37
+  { U64_C(0x8262889000000000), U64_C(0x12CED32A16A1B11E) }, // 5^38
+  { U64_C(0x22FB2AB400000000), U64_C(0x178287F49C4A1D66) }, // 5^39
+  { U64_C(0xABB9F56100000000), U64_C(0x1D6329F1C35CA4BF) }, // 5^40
+  { U64_C(0xCB54395CA0000000), U64_C(0x125DFA371A19E6F7) }, // 5^41
+  { U64_C(0xBE2947B3C8000000), U64_C(0x16F578C4E0A060B5) }, // 5^42
+  { U64_C(0x2DB399A0BA000000), U64_C(0x1CB2D6F618C878E3) }, // 5^43
+  { U64_C(0xFC90400474400000), U64_C(0x11EFC659CF7D4B8D) }, // 5^44
+  { U64_C(0x7BB4500591500000), U64_C(0x166BB7F0435C9E71) }, // 5^45
+  { U64_C(0xDAA16406F5A40000), U64_C(0x1C06A5EC5433C60D) }, // 5^46
+  { U64_C(0xA8A4DE8459868000), U64_C(0x118427B3B4A05BC8) }, // 5^47
+  { U64_C(0xD2CE16256FE82000), U64_C(0x15E531A0A1C872BA) }, // 5^48
+  { U64_C(0x87819BAECBE22800), U64_C(0x1B5E7E08CA3A8F69) }, // 5^49
+  { U64_C(0xF4B1014D3F6D5900), U64_C(0x111B0EC57E6499A1) }, // 5^50
+  { U64_C(0x71DD41A08F48AF40), U64_C(0x1561D276DDFDC00A) }, // 5^51
+  { U64_C(0x0E549208B31ADB10), U64_C(0x1ABA4714957D300D) }, // 5^52
+  { U64_C(0x28F4DB456FF0C8EA), U64_C(0x10B46C6CDD6E3E08) }, // 5^53
+  { U64_C(0x33321216CBECFB24), U64_C(0x14E1878814C9CD8A) }, // 5^54
+  { U64_C(0xBFFE969C7EE839ED), U64_C(0x1A19E96A19FC40EC) }, // 5^55
+  { U64_C(0xF7FF1E21CF512434), U64_C(0x105031E2503DA893) }, // 5^56
+  { U64_C(0xF5FEE5AA43256D41), U64_C(0x14643E5AE44D12B8) }, // 5^57
+  { U64_C(0x337E9F14D3EEC892), U64_C(0x197D4DF19D605767) }, // 5^58
+  { U64_C(0x005E46DA08EA7AB6), U64_C(0x1FDCA16E04B86D41) }, // 5^59
+  { U64_C(0xA03AEC4845928CB2), U64_C(0x13E9E4E4C2F34448) }, // 5^60
+  { U64_C(0xC849A75A56F72FDE), U64_C(0x18E45E1DF3B0155A) }, // 5^61
+  { U64_C(0x7A5C1130ECB4FBD6), U64_C(0x1F1D75A5709C1AB1) }, // 5^62
+  { U64_C(0xEC798ABE93F11D65), U64_C(0x13726987666190AE) }, // 5^63
+  { U64_C(0xA797ED6E38ED64BF), U64_C(0x184F03E93FF9F4DA) }, // 5^64
+  { U64_C(0x517DE8C9C728BDEF), U64_C(0x1E62C4E38FF87211) }, // 5^65
+  { U64_C(0xD2EEB17E1C7976B5), U64_C(0x12FDBB0E39FB474A) }, // 5^66
+  { U64_C(0x87AA5DDDA397D462), U64_C(0x17BD29D1C87A191D) }, // 5^67
+  { U64_C(0xE994F5550C7DC97B), U64_C(0x1DAC74463A989F64) }, // 5^68
+  { U64_C(0x11FD195527CE9DED), U64_C(0x128BC8ABE49F639F) }, // 5^69
+  { U64_C(0xD67C5FAA71C24568), U64_C(0x172EBAD6DDC73C86) }, // 5^70
+  { U64_C(0x8C1B77950E32D6C2), U64_C(0x1CFA698C95390BA8) }, // 5^71
+  { U64_C(0x57912ABD28DFC639), U64_C(0x121C81F7DD43A749) }, // 5^72
+  { U64_C(0xAD75756C7317B7C8), U64_C(0x16A3A275D494911B) }, // 5^73
+  { U64_C(0x98D2D2C78FDDA5BA), U64_C(0x1C4C8B1349B9B562) }, // 5^74
+  { U64_C(0x9F83C3BCB9EA8794), U64_C(0x11AFD6EC0E14115D) }, // 5^75
+  { U64_C(0x0764B4ABE8652979), U64_C(0x161BCCA7119915B5) }, // 5^76
+  { U64_C(0x493DE1D6E27E73D7), U64_C(0x1BA2BFD0D5FF5B22) }, // 5^77
+  { U64_C(0x6DC6AD264D8F0866), U64_C(0x1145B7E285BF98F5) }, // 5^78
+  { U64_C(0xC938586FE0F2CA80), U64_C(0x159725DB272F7F32) }, // 5^79
+  { U64_C(0x7B866E8BD92F7D20), U64_C(0x1AFCEF51F0FB5EFF) }, // 5^80
+  { U64_C(0xAD34051767BDAE34), U64_C(0x10DE1593369D1B5F) }, // 5^81
+  { U64_C(0x9881065D41AD19C1), U64_C(0x15159AF804446237) }, // 5^82
+  { U64_C(0x7EA147F492186032), U64_C(0x1A5B01B605557AC5) }, // 5^83
+  { U64_C(0x6F24CCF8DB4F3C1F), U64_C(0x1078E111C3556CBB) }, // 5^84
+  { U64_C(0x4AEE003712230B27), U64_C(0x14971956342AC7EA) }, // 5^85
+  { U64_C(0xDDA98044D6ABCDF0), U64_C(0x19BCDFABC13579E4) }, // 5^86
+  { U64_C(0x0A89F02B062B60B6), U64_C(0x10160BCB58C16C2F) }, // 5^87
+  { U64_C(0xCD2C6C35C7B638E4), U64_C(0x141B8EBE2EF1C73A) }, // 5^88
+  { U64_C(0x8077874339A3C71D), U64_C(0x1922726DBAAE3909) }, // 5^89
+  { U64_C(0xE0956914080CB8E4), U64_C(0x1F6B0F092959C74B) }, // 5^90
+  { U64_C(0x6C5D61AC8507F38E), U64_C(0x13A2E965B9D81C8F) }, // 5^91
+  { U64_C(0x4774BA17A649F072), U64_C(0x188BA3BF284E23B3) }, // 5^92
+  { U64_C(0x1951E89D8FDC6C8F), U64_C(0x1EAE8CAEF261ACA0) }, // 5^93
+  { U64_C(0x0FD3316279E9C3D9), U64_C(0x132D17ED577D0BE4) }, // 5^94
+  { U64_C(0x13C7FDBB186434CF), U64_C(0x17F85DE8AD5C4EDD) }, // 5^95
+  { U64_C(0x58B9FD29DE7D4203), U64_C(0x1DF67562D8B36294) }, // 5^96
+  { U64_C(0xB7743E3A2B0E4942), U64_C(0x12BA095DC7701D9C) }, // 5^97
+  { U64_C(0xE5514DC8B5D1DB92), U64_C(0x17688BB5394C2503) }, // 5^98
+  { U64_C(0xDEA5A13AE3465277), U64_C(0x1D42AEA2879F2E44) }, // 5^99
+  { U64_C(0x0B2784C4CE0BF38A), U64_C(0x1249AD2594C37CEB) }, // 5^100
+  { U64_C(0xCDF165F6018EF06D), U64_C(0x16DC186EF9F45C25) }, // 5^101
+  { U64_C(0x416DBF7381F2AC88), U64_C(0x1C931E8AB871732F) }, // 5^102
+  { U64_C(0x88E497A83137ABD5), U64_C(0x11DBF316B346E7FD) }, // 5^103
+  { U64_C(0xEB1DBD923D8596CA), U64_C(0x1652EFDC6018A1FC) }, // 5^104
+  { U64_C(0x25E52CF6CCE6FC7D), U64_C(0x1BE7ABD3781ECA7C) }, // 5^105
+  { U64_C(0x97AF3C1A40105DCE), U64_C(0x1170CB642B133E8D) }, // 5^106
+  { U64_C(0xFD9B0B20D0147542), U64_C(0x15CCFE3D35D80E30) }, // 5^107
+  { U64_C(0x3D01CDE904199292), U64_C(0x1B403DCC834E11BD) }, // 5^108
+  { U64_C(0x462120B1A28FFB9B), U64_C(0x1108269FD210CB16) }, // 5^109
+  { U64_C(0xD7A968DE0B33FA82), U64_C(0x154A3047C694FDDB) }, // 5^110
+  { U64_C(0xCD93C3158E00F923), U64_C(0x1A9CBC59B83A3D52) }, // 5^111
+  { U64_C(0xC07C59ED78C09BB6), U64_C(0x10A1F5B813246653) }, // 5^112
+  { U64_C(0xB09B7068D6F0C2A3), U64_C(0x14CA732617ED7FE8) }, // 5^113
+  { U64_C(0xDCC24C830CACF34C), U64_C(0x19FD0FEF9DE8DFE2) }, // 5^114
+  { U64_C(0xC9F96FD1E7EC180F), U64_C(0x103E29F5C2B18BED) }, // 5^115
+  { U64_C(0x3C77CBC661E71E13), U64_C(0x144DB473335DEEE9) }, // 5^116
+  { U64_C(0x8B95BEB7FA60E598), U64_C(0x1961219000356AA3) }, // 5^117
+  { U64_C(0x6E7B2E65F8F91EFE), U64_C(0x1FB969F40042C54C) }, // 5^118
+  { U64_C(0xC50CFCFFBB9BB35F), U64_C(0x13D3E2388029BB4F) }, // 5^119
+  { U64_C(0xB6503C3FAA82A037), U64_C(0x18C8DAC6A0342A23) }, // 5^120
+  { U64_C(0xA3E44B4F95234844), U64_C(0x1EFB1178484134AC) }, // 5^121
+  { U64_C(0xE66EAF11BD360D2B), U64_C(0x135CEAEB2D28C0EB) }, // 5^122
+  { U64_C(0xE00A5AD62C839075), U64_C(0x183425A5F872F126) }, // 5^123
+  { U64_C(0x980CF18BB7A47493), U64_C(0x1E412F0F768FAD70) }, // 5^124
+  { U64_C(0x5F0816F752C6C8DC), U64_C(0x12E8BD69AA19CC66) }, // 5^125
+  { U64_C(0xF6CA1CB527787B13), U64_C(0x17A2ECC414A03F7F) }, // 5^126
+  { U64_C(0xF47CA3E2715699D7), U64_C(0x1D8BA7F519C84F5F) }, // 5^127
+  { U64_C(0xF8CDE66D86D62026), U64_C(0x127748F9301D319B) }, // 5^128
+  { U64_C(0xF7016008E88BA830), U64_C(0x17151B377C247E02) }, // 5^129
+  { U64_C(0xB4C1B80B22AE923C), U64_C(0x1CDA62055B2D9D83) }, // 5^130
+  { U64_C(0x50F91306F5AD1B65), U64_C(0x12087D4358FC8272) }, // 5^131
+  { U64_C(0xE53757C8B318623F), U64_C(0x168A9C942F3BA30E) }, // 5^132
+  { U64_C(0x9E852DBADFDE7ACF), U64_C(0x1C2D43B93B0A8BD2) }, // 5^133
+  { U64_C(0xA3133C94CBEB0CC1), U64_C(0x119C4A53C4E69763) }, // 5^134
+  { U64_C(0x8BD80BB9FEE5CFF1), U64_C(0x16035CE8B6203D3C) }, // 5^135
+  { U64_C(0xAECE0EA87E9F43EE), U64_C(0x1B843422E3A84C8B) }, // 5^136
+  { U64_C(0x4D40C9294F238A75), U64_C(0x1132A095CE492FD7) }, // 5^137
+  { U64_C(0x2090FB73A2EC6D12), U64_C(0x157F48BB41DB7BCD) }, // 5^138
+  { U64_C(0x68B53A508BA78856), U64_C(0x1ADF1AEA12525AC0) }, // 5^139
+  { U64_C(0x417144725748B536), U64_C(0x10CB70D24B7378B8) }, // 5^140
+  { U64_C(0x51CD958EED1AE283), U64_C(0x14FE4D06DE5056E6) }, // 5^141
+  { U64_C(0xE640FAF2A8619B24), U64_C(0x1A3DE04895E46C9F) }, // 5^142
+  { U64_C(0xEFE89CD7A93D00F7), U64_C(0x1066AC2D5DAEC3E3) }, // 5^143
+  { U64_C(0xEBE2C40D938C4134), U64_C(0x14805738B51A74DC) }, // 5^144
+  { U64_C(0x26DB7510F86F5181), U64_C(0x19A06D06E2611214) }, // 5^145
+  { U64_C(0x9849292A9B4592F1), U64_C(0x100444244D7CAB4C) }, // 5^146
+  { U64_C(0xBE5B73754216F7AD), U64_C(0x1405552D60DBD61F) }, // 5^147
+  { U64_C(0xADF25052929CB598), U64_C(0x1906AA78B912CBA7) }, // 5^148
+  { U64_C(0x996EE4673743E2FF), U64_C(0x1F485516E7577E91) }, // 5^149
+  { U64_C(0xFFE54EC0828A6DDF), U64_C(0x138D352E5096AF1A) }, // 5^150
+  { U64_C(0xBFDEA270A32D0957), U64_C(0x18708279E4BC5AE1) }, // 5^151
+  { U64_C(0x2FD64B0CCBF84BAD), U64_C(0x1E8CA3185DEB719A) }, // 5^152
+  { U64_C(0x5DE5EEE7FF7B2F4C), U64_C(0x1317E5EF3AB32700) }, // 5^153
+  { U64_C(0x755F6AA1FF59FB1F), U64_C(0x17DDDF6B095FF0C0) }, // 5^154
+  { U64_C(0x92B7454A7F3079E7), U64_C(0x1DD55745CBB7ECF0) }, // 5^155
+  { U64_C(0x5BB28B4E8F7E4C30), U64_C(0x12A5568B9F52F416) }, // 5^156
+  { U64_C(0xF29F2E22335DDF3C), U64_C(0x174EAC2E8727B11B) }, // 5^157
+  { U64_C(0xEF46F9AAC035570B), U64_C(0x1D22573A28F19D62) }, // 5^158
+  { U64_C(0xD58C5C0AB8215667), U64_C(0x123576845997025D) }, // 5^159
+  { U64_C(0x4AEF730D6629AC01), U64_C(0x16C2D4256FFCC2F5) }, // 5^160
+  { U64_C(0x9DAB4FD0BFB41701), U64_C(0x1C73892ECBFBF3B2) }, // 5^161
+  { U64_C(0xA28B11E277D08E60), U64_C(0x11C835BD3F7D784F) }, // 5^162
+  { U64_C(0x8B2DD65B15C4B1F9), U64_C(0x163A432C8F5CD663) }, // 5^163
+  { U64_C(0x6DF94BF1DB35DE77), U64_C(0x1BC8D3F7B3340BFC) }, // 5^164
+  { U64_C(0xC4BBCF772901AB0A), U64_C(0x115D847AD000877D) }, // 5^165
+  { U64_C(0x35EAC354F34215CD), U64_C(0x15B4E5998400A95D) }, // 5^166
+  { U64_C(0x8365742A30129B40), U64_C(0x1B221EFFE500D3B4) }, // 5^167
+  { U64_C(0xD21F689A5E0BA108), U64_C(0x10F5535FEF208450) }, // 5^168
+  { U64_C(0x06A742C0F58E894A), U64_C(0x1532A837EAE8A565) }, // 5^169
+  { U64_C(0x4851137132F22B9D), U64_C(0x1A7F5245E5A2CEBE) }, // 5^170
+  { U64_C(0xED32AC26BFD75B42), U64_C(0x108F936BAF85C136) }, // 5^171
+  { U64_C(0xA87F57306FCD3212), U64_C(0x14B378469B673184) }, // 5^172
+  { U64_C(0xD29F2CFC8BC07E97), U64_C(0x19E056584240FDE5) }, // 5^173
+  { U64_C(0xA3A37C1DD7584F1E), U64_C(0x102C35F729689EAF) }, // 5^174
+  { U64_C(0x8C8C5B254D2E62E6), U64_C(0x14374374F3C2C65B) }, // 5^175
+  { U64_C(0x6FAF71EEA079FB9F), U64_C(0x1945145230B377F2) }, // 5^176
+  { U64_C(0x0B9B4E6A48987A87), U64_C(0x1F965966BCE055EF) }, // 5^177
+  { U64_C(0x674111026D5F4C94), U64_C(0x13BDF7E0360C35B5) }, // 5^178
+  { U64_C(0xC111554308B71FBA), U64_C(0x18AD75D8438F4322) }, // 5^179
+  { U64_C(0x7155AA93CAE4E7A8), U64_C(0x1ED8D34E547313EB) }, // 5^180
+  { U64_C(0x26D58A9C5ECF10C9), U64_C(0x13478410F4C7EC73) }, // 5^181
+  { U64_C(0xF08AED437682D4FB), U64_C(0x1819651531F9E78F) }, // 5^182
+  { U64_C(0xECADA89454238A3A), U64_C(0x1E1FBE5A7E786173) }, // 5^183
+  { U64_C(0x73EC895CB4963664), U64_C(0x12D3D6F88F0B3CE8) }, // 5^184
+  { U64_C(0x90E7ABB3E1BBC3FD), U64_C(0x1788CCB6B2CE0C22) }, // 5^185
+  { U64_C(0x352196A0DA2AB4FD), U64_C(0x1D6AFFE45F818F2B) }, // 5^186
+  { U64_C(0x0134FE24885AB11E), U64_C(0x1262DFEEBBB0F97B) }, // 5^187
+  { U64_C(0xC1823DADAA715D65), U64_C(0x16FB97EA6A9D37D9) }, // 5^188
+  { U64_C(0x31E2CD19150DB4BF), U64_C(0x1CBA7DE5054485D0) }, // 5^189
+  { U64_C(0x1F2DC02FAD2890F7), U64_C(0x11F48EAF234AD3A2) }, // 5^190
+  { U64_C(0xA6F9303B9872B535), U64_C(0x1671B25AEC1D888A) }, // 5^191
+  { U64_C(0x50B77C4A7E8F6282), U64_C(0x1C0E1EF1A724EAAD) }, // 5^192
+  { U64_C(0x5272ADAE8F199D91), U64_C(0x1188D357087712AC) }, // 5^193
+  { U64_C(0x670F591A32E004F6), U64_C(0x15EB082CCA94D757) }, // 5^194
+  { U64_C(0x40D32F60BF980633), U64_C(0x1B65CA37FD3A0D2D) }, // 5^195
+  { U64_C(0x4883FD9C77BF03E0), U64_C(0x111F9E62FE44483C) }, // 5^196
+  { U64_C(0x5AA4FD0395AEC4D8), U64_C(0x156785FBBDD55A4B) }, // 5^197
+  { U64_C(0x314E3C447B1A760E), U64_C(0x1AC1677AAD4AB0DE) }, // 5^198
+  { U64_C(0xDED0E5AACCF089C9), U64_C(0x10B8E0ACAC4EAE8A) }, // 5^199
+  { U64_C(0x96851F15802CAC3B), U64_C(0x14E718D7D7625A2D) }, // 5^200
+  { U64_C(0xFC2666DAE037D74A), U64_C(0x1A20DF0DCD3AF0B8) }, // 5^201
+  { U64_C(0x9D980048CC22E68E), U64_C(0x10548B68A044D673) }, // 5^202
+  { U64_C(0x84FE005AFF2BA032), U64_C(0x1469AE42C8560C10) }, // 5^203
+  { U64_C(0xA63D8071BEF6883E), U64_C(0x198419D37A6B8F14) }, // 5^204
+  { U64_C(0xCFCCE08E2EB42A4E), U64_C(0x1FE52048590672D9) }, // 5^205
+  { U64_C(0x21E00C58DD309A70), U64_C(0x13EF342D37A407C8) }, // 5^206
+  { U64_C(0x2A580F6F147CC10D), U64_C(0x18EB0138858D09BA) }, // 5^207
+  { U64_C(0xB4EE134AD99BF150), U64_C(0x1F25C186A6F04C28) }, // 5^208
+  { U64_C(0x7114CC0EC80176D2), U64_C(0x137798F428562F99) }, // 5^209
+  { U64_C(0xCD59FF127A01D486), U64_C(0x18557F31326BBB7F) }, // 5^210
+  { U64_C(0xC0B07ED7188249A8), U64_C(0x1E6ADEFD7F06AA5F) }, // 5^211
+  { U64_C(0xD86E4F466F516E09), U64_C(0x1302CB5E6F642A7B) }, // 5^212
+  { U64_C(0xCE89E3180B25C98B), U64_C(0x17C37E360B3D351A) }, // 5^213
+  { U64_C(0x822C5BDE0DEF3BEE), U64_C(0x1DB45DC38E0C8261) }, // 5^214
+  { U64_C(0xF15BB96AC8B58575), U64_C(0x1290BA9A38C7D17C) }, // 5^215
+  { U64_C(0x2DB2A7C57AE2E6D2), U64_C(0x1734E940C6F9C5DC) }, // 5^216
+  { U64_C(0x391F51B6D99BA086), U64_C(0x1D022390F8B83753) }, // 5^217
+  { U64_C(0x03B3931248014454), U64_C(0x1221563A9B732294) }, // 5^218
+  { U64_C(0x04A077D6DA019569), U64_C(0x16A9ABC9424FEB39) }, // 5^219
+  { U64_C(0x45C895CC9081FAC3), U64_C(0x1C5416BB92E3E607) }, // 5^220
+  { U64_C(0x8B9D5D9FDA513CBA), U64_C(0x11B48E353BCE6FC4) }, // 5^221
+  { U64_C(0xAE84B507D0E58BE8), U64_C(0x1621B1C28AC20BB5) }, // 5^222
+  { U64_C(0x1A25E249C51EEEE3), U64_C(0x1BAA1E332D728EA3) }, // 5^223
+  { U64_C(0xF057AD6E1B33554D), U64_C(0x114A52DFFC679925) }, // 5^224
+  { U64_C(0x6C6D98C9A2002AA1), U64_C(0x159CE797FB817F6F) }, // 5^225
+  { U64_C(0x4788FEFC0A803549), U64_C(0x1B04217DFA61DF4B) }, // 5^226
+  { U64_C(0x0CB59F5D8690214E), U64_C(0x10E294EEBC7D2B8F) }, // 5^227
+  { U64_C(0xCFE30734E83429A1), U64_C(0x151B3A2A6B9C7672) }, // 5^228
+  { U64_C(0x83DBC9022241340A), U64_C(0x1A6208B50683940F) }, // 5^229
+  { U64_C(0xB2695DA15568C086), U64_C(0x107D457124123C89) }, // 5^230
+  { U64_C(0x1F03B509AAC2F0A7), U64_C(0x149C96CD6D16CBAC) }, // 5^231
+  { U64_C(0x26C4A24C1573ACD1), U64_C(0x19C3BC80C85C7E97) }, // 5^232
+  { U64_C(0x783AE56F8D684C03), U64_C(0x101A55D07D39CF1E) }, // 5^233
+  { U64_C(0x16499ECB70C25F03), U64_C(0x1420EB449C8842E6) }, // 5^234
+  { U64_C(0x9BDC067E4CF2F6C4), U64_C(0x19292615C3AA539F) }, // 5^235
+  { U64_C(0x82D3081DE02FB476), U64_C(0x1F736F9B3494E887) }, // 5^236
+  { U64_C(0xB1C3E512AC1DD0C9), U64_C(0x13A825C100DD1154) }, // 5^237
+  { U64_C(0xDE34DE57572544FC), U64_C(0x18922F31411455A9) }, // 5^238
+  { U64_C(0x55C215ED2CEE963B), U64_C(0x1EB6BAFD91596B14) }, // 5^239
+  { U64_C(0xB5994DB43C151DE5), U64_C(0x133234DE7AD7E2EC) }, // 5^240
+  { U64_C(0xE2FFA1214B1A655E), U64_C(0x17FEC216198DDBA7) }, // 5^241
+  { U64_C(0xDBBF89699DE0FEB6), U64_C(0x1DFE729B9FF15291) }, // 5^242
+  { U64_C(0x2957B5E202AC9F31), U64_C(0x12BF07A143F6D39B) }, // 5^243
+  { U64_C(0xF3ADA35A8357C6FE), U64_C(0x176EC98994F48881) }, // 5^244
+  { U64_C(0x70990C31242DB8BD), U64_C(0x1D4A7BEBFA31AAA2) }, // 5^245
+  { U64_C(0x865FA79EB69C9376), U64_C(0x124E8D737C5F0AA5) }, // 5^246
+  { U64_C(0xE7F791866443B854), U64_C(0x16E230D05B76CD4E) }, // 5^247
+  { U64_C(0xA1F575E7FD54A669), U64_C(0x1C9ABD04725480A2) }, // 5^248
+  { U64_C(0xA53969B0FE54E801), U64_C(0x11E0B622C774D065) }, // 5^249
+  { U64_C(0x0E87C41D3DEA2202), U64_C(0x1658E3AB7952047F) }, // 5^250
+  { U64_C(0xD229B5248D64AA82), U64_C(0x1BEF1C9657A6859E) }, // 5^251
+  { U64_C(0x435A1136D85EEA91), U64_C(0x117571DDF6C81383) }, // 5^252
+  { U64_C(0x143095848E76A536), U64_C(0x15D2CE55747A1864) }, // 5^253
+  { U64_C(0x193CBAE5B2144E83), U64_C(0x1B4781EAD1989E7D) }, // 5^254
+  { U64_C(0x2FC5F4CF8F4CB112), U64_C(0x110CB132C2FF630E) }, // 5^255
+  { U64_C(0xBBB77203731FDD56), U64_C(0x154FDD7F73BF3BD1) }, // 5^256
+  { U64_C(0x2AA54E844FE7D4AC), U64_C(0x1AA3D4DF50AF0AC6) }, // 5^257
+  { U64_C(0xDAA75112B1F0E4EB), U64_C(0x10A6650B926D66BB) }, // 5^258
+  { U64_C(0xD15125575E6D1E26), U64_C(0x14CFFE4E7708C06A) }, // 5^259
+  { U64_C(0x85A56EAD360865B0), U64_C(0x1A03FDE214CAF085) }, // 5^260
+  { U64_C(0x7387652C41C53F8E), U64_C(0x10427EAD4CFED653) }, // 5^261
+  { U64_C(0x50693E7752368F71), U64_C(0x14531E58A03E8BE8) }, // 5^262
+  { U64_C(0x64838E1526C4334E), U64_C(0x1967E5EEC84E2EE2) }, // 5^263
+  { U64_C(0xFDA4719A70754022), U64_C(0x1FC1DF6A7A61BA9A) }, // 5^264
+  { U64_C(0xDE86C70086494815), U64_C(0x13D92BA28C7D14A0) }, // 5^265
+  { U64_C(0x162878C0A7DB9A1A), U64_C(0x18CF768B2F9C59C9) }, // 5^266
+  { U64_C(0x5BB296F0D1D280A1), U64_C(0x1F03542DFB83703B) }, // 5^267
+  { U64_C(0x194F9E5683239064), U64_C(0x1362149CBD322625) }, // 5^268
+  { U64_C(0x5FA385EC23EC747E), U64_C(0x183A99C3EC7EAFAE) }, // 5^269
+  { U64_C(0xF78C67672CE7919D), U64_C(0x1E494034E79E5B99) }, // 5^270
+  { U64_C(0x3AB7C0A07C10BB02), U64_C(0x12EDC82110C2F940) }, // 5^271
+  { U64_C(0x4965B0C89B14E9C3), U64_C(0x17A93A2954F3B790) }, // 5^272
+  { U64_C(0x5BBF1CFAC1DA2433), U64_C(0x1D9388B3AA30A574) }, // 5^273
+  { U64_C(0xB957721CB92856A0), U64_C(0x127C35704A5E6768) }, // 5^274
+  { U64_C(0xE7AD4EA3E7726C48), U64_C(0x171B42CC5CF60142) }, // 5^275
+  { U64_C(0xA198A24CE14F075A), U64_C(0x1CE2137F74338193) }, // 5^276
+  { U64_C(0x44FF65700CD16498), U64_C(0x120D4C2FA8A030FC) }, // 5^277
+  { U64_C(0x563F3ECC1005BDBE), U64_C(0x16909F3B92C83D3B) }, // 5^278
+  { U64_C(0x2BCF0E7F14072D2E), U64_C(0x1C34C70A777A4C8A) }, // 5^279
+  { U64_C(0x5B61690F6C847C3D), U64_C(0x11A0FC668AAC6FD6) }, // 5^280
+  { U64_C(0xF239C35347A59B4C), U64_C(0x16093B802D578BCB) }, // 5^281
+  { U64_C(0xEEC83428198F021F), U64_C(0x1B8B8A6038AD6EBE) }, // 5^282
+  { U64_C(0x553D20990FF96153), U64_C(0x1137367C236C6537) }, // 5^283
+  { U64_C(0x2A8C68BF53F7B9A8), U64_C(0x1585041B2C477E85) }, // 5^284
+  { U64_C(0x752F82EF28F5A812), U64_C(0x1AE64521F7595E26) }, // 5^285
+  { U64_C(0x093DB1D57999890B), U64_C(0x10CFEB353A97DAD8) }, // 5^286
+  { U64_C(0x0B8D1E4AD7FFEB4E), U64_C(0x1503E602893DD18E) }, // 5^287
+  { U64_C(0x8E7065DD8DFFE622), U64_C(0x1A44DF832B8D45F1) }, // 5^288
+  { U64_C(0xF9063FAA78BFEFD5), U64_C(0x106B0BB1FB384BB6) }, // 5^289
+  { U64_C(0xB747CF9516EFEBCA), U64_C(0x1485CE9E7A065EA4) }, // 5^290
+  { U64_C(0xE519C37A5CABE6BD), U64_C(0x19A742461887F64D) }, // 5^291
+  { U64_C(0xAF301A2C79EB7036), U64_C(0x1008896BCF54F9F0) }, // 5^292
+  { U64_C(0xDAFC20B798664C43), U64_C(0x140AABC6C32A386C) }, // 5^293
+  { U64_C(0x11BB28E57E7FDF54), U64_C(0x190D56B873F4C688) }, // 5^294
+  { U64_C(0x1629F31EDE1FD72A), U64_C(0x1F50AC6690F1F82A) }, // 5^295
+  { U64_C(0x4DDA37F34AD3E67A), U64_C(0x13926BC01A973B1A) }, // 5^296
+  { U64_C(0xE150C5F01D88E019), U64_C(0x187706B0213D09E0) }, // 5^297
+  { U64_C(0x19A4F76C24EB181F), U64_C(0x1E94C85C298C4C59) }, // 5^298
+  { U64_C(0xB0071AA39712EF13), U64_C(0x131CFD3999F7AFB7) }, // 5^299
+  { U64_C(0x9C08E14C7CD7AAD8), U64_C(0x17E43C8800759BA5) }, // 5^300
+  { U64_C(0x030B199F9C0D958E), U64_C(0x1DDD4BAA0093028F) }, // 5^301
+  { U64_C(0x61E6F003C1887D79), U64_C(0x12AA4F4A405BE199) }, // 5^302
+  { U64_C(0xBA60AC04B1EA9CD7), U64_C(0x1754E31CD072D9FF) }, // 5^303
+  { U64_C(0xA8F8D705DE65440D), U64_C(0x1D2A1BE4048F907F) }, // 5^304
+  { U64_C(0xC99B8663AAFF4A88), U64_C(0x123A516E82D9BA4F) }, // 5^305
+  { U64_C(0xBC0267FC95BF1D2A), U64_C(0x16C8E5CA239028E3) }, // 5^306
+  { U64_C(0xAB0301FBBB2EE474), U64_C(0x1C7B1F3CAC74331C) }, // 5^307
+  { U64_C(0xEAE1E13D54FD4EC9), U64_C(0x11CCF385EBC89FF1) }, // 5^308
+  { U64_C(0x659A598CAA3CA27B), U64_C(0x1640306766BAC7EE) }, // 5^309
+  { U64_C(0xFF00EFEFD4CBCB1A), U64_C(0x1BD03C81406979E9) }, // 5^310
+  { U64_C(0x3F6095F5E4FF5EF0), U64_C(0x116225D0C841EC32) }, // 5^311
+  { U64_C(0xCF38BB735E3F36AC), U64_C(0x15BAAF44FA52673E) }, // 5^312
+  { U64_C(0x8306EA5035CF0457), U64_C(0x1B295B1638E7010E) }, // 5^313
+  { U64_C(0x11E4527221A162B6), U64_C(0x10F9D8EDE39060A9) }, // 5^314
+  { U64_C(0x565D670EAA09BB64), U64_C(0x15384F295C7478D3) }, // 5^315
+  { U64_C(0x2BF4C0D2548C2A3D), U64_C(0x1A8662F3B3919708) }, // 5^316
+  { U64_C(0x1B78F88374D79A66), U64_C(0x1093FDD8503AFE65) }, // 5^317
+  { U64_C(0x625736A4520D8100), U64_C(0x14B8FD4E6449BDFE) }, // 5^318
+  { U64_C(0xFAED044D6690E140), U64_C(0x19E73CA1FD5C2D7D) }, // 5^319
+  { U64_C(0xBCD422B0601A8CC8), U64_C(0x103085E53E599C6E) }, // 5^320
+  { U64_C(0x6C092B5C78212FFA), U64_C(0x143CA75E8DF0038A) }, // 5^321
+  { U64_C(0x070B763396297BF8), U64_C(0x194BD136316C046D) }, // 5^322
+  { U64_C(0x48CE53C07BB3DAF6), U64_C(0x1F9EC583BDC70588) }, // 5^323
+  { U64_C(0x2D80F4584D5068DA), U64_C(0x13C33B72569C6375) }, // 5^324
+  { U64_C(0x78E1316E60A48310), U64_C(0x18B40A4EEC437C52) }, // 5^325
+};
+
+// Amount of bits in 5^e (ceil(log2(5^e)) for e > 0)
+static inline s32 Pow5Bits(s32 iExp) {
+  return (s32)(((u32)iExp * 1217359) >> 19) + 1;
+};
+
+// floor(log10(2^e))
+static inline s32 Log10Pow2(s32 iExp) {
+  return (s32)(((u32)iExp * 78913) >> 18);
+};
+
+// floor(log10(5^e))
+static inline s32 Log10Pow5(s32 iExp) {
+  return (s32)(((u32)iExp * 732923) >> 20);
+};
+
+// Check if the number is divisible by 5^p
+static inline bool IsMultipleOfPowerOf5(u64 iValue, s32 iPower) {
+  s32 ctFactors = 0;
+
+  while (ctFactors < iPower && iValue % 5 == 0) {
+    iValue /= 5;
+    ++ctFactors;
+  }
+
+  return ctFactors >= iPower;
+};
+
+// Check if the number is divisible by 2^p
+static inline bool IsMultipleOfPowerOf2(u64 iValue, s32 iPower) {
+  return (iValue & (((u64)1 << iPower) - 1)) == 0;
+};
+
+// Multiply by a 125-bit factor and shift the product to the right
+static inline u64 MulShift(u64 iValue, const u64 *aiFactor, s32 iShift) {
+  u64 iHigh0, iLow0, iHigh1, iLow1;
+  Multiply128(iValue, aiFactor[0], iHigh0, iLow0);
+  Multiply128(iValue, aiFactor[1], iHigh1, iLow1);
+
+  const u64 iSumLow = iLow1 + iHigh0;
+  const u64 iSumHigh = iHigh1 + (iSumLow < iLow1);
+
+  return ShiftRight128(iSumHigh, iSumLow, iShift - 64);
+};
+
+// Powers of ten that fit into 64 bits
+static const u64 _aiPowersOfTen[20] = {
+  U64_C(1), U64_C(10), U64_C(100), U64_C(1000), U64_C(10000), U64_C(100000), U64_C(1000000),
+  U64_C(10000000), U64_C(100000000), U64_C(1000000000), U64_C(10000000000), U64_C(100000000000),
+  U64_C(1000000000000), U64_C(10000000000000), U64_C(100000000000000), U64_C(1000000000000000),
+  U64_C(10000000000000000), U64_C(100000000000000000), U64_C(1000000000000000000),
+  U64_C(10000000000000000000),
+};
+
+// Amount of decimal digits in a number
+static inline s32 DecimalLength(u64 iValue) {
+  s32 ctDigits = 1;
+
+  while (ctDigits < 20 && iValue >= _aiPowersOfTen[ctDigits]) {
+    ++ctDigits;
+  }
+
+  return ctDigits;
+};
+
+// Decimal number (iDigits * 10^iExp10)
+struct DecimalNumber {
+  u64 iDigits;
+  s32 iExp10;
+};
+
+// Number that's being converted from binary to decimal
+struct DecimalScale {
+  u64 iMantissa; // Binary mantissa with two extra bits (exact value is iMantissa * 2^iExp2)
+  s32 iExp2;     // Binary exponent
+  s32 iExp10;    // Decimal exponent of the scaled values
+  s32 iPower;    // Power of ten that the value has been divided by (q)
+  s32 iShift;    // Shift of the table product
+  const u64 *aiFactor; // Table factor
+};
+
+// Select table factor for scaling the binary number to the decimal exponent
+static void PrepareScale(u64 iIeeeMantissa, u32 iIeeeExponent, DecimalScale &scale) {
+  u64 iMantissa;
+
+  // Subnormal number
+  if (iIeeeExponent == 0) {
+    scale.iExp2 = 1 - DOUBLE_EXPONENT_BIAS - DOUBLE_MANTISSA_BITS - 2;
+    iMantissa = iIeeeMantissa;
+
+  } else {
+    scale.iExp2 = (s32)iIeeeExponent - DOUBLE_EXPONENT_BIAS - DOUBLE_MANTISSA_BITS - 2;
+    iMantissa = ((u64)1 << DOUBLE_MANTISSA_BITS) | iIeeeMantissa;
+  }
+
+  scale.iMantissa = iMantissa * 4;
+
+  if (scale.iExp2 >= 0) {
+    // Divide by 10^q
+    const s32 q = Log10Pow2(scale.iExp2) - (scale.iExp2 > 3);
+    const s32 k = FORMAT_POW5_BITS + Pow5Bits(q) - 1;
+
+    scale.iExp10 = q;
+    scale.iPower = q;
+    scale.iShift = -scale.iExp2 + q + k;
+    scale.aiFactor = _aiInvPowersOfFive[q];
+
+  } else {
+    // Multiply by 5^i
+    const s32 q = Log10Pow5(-scale.iExp2) - (-scale.iExp2 > 1);
+    const s32 i = -scale.iExp2 - q;
+    const s32 k = Pow5Bits(i) - FORMAT_POW5_BITS;
+
+    scale.iExp10 = q + scale.iExp2;
+    scale.iPower = q;
+    scale.iShift = q - k;
+    scale.aiFactor = _aiPowersOfFive[i];
+  }
+};
+
+// Find the shortest decimal number that reads back as the same binary number (Ryu algorithm by Ulf Adams)
+static void ShortestDecimal(u64 iIeeeMantissa, u32 iIeeeExponent, DecimalNumber &dec) {
+  DecimalScale scale;
+  PrepareScale(iIeeeMantissa, iIeeeExponent, scale);
+
+  const u64 mv = scale.iMantissa;
+  const s32 q = scale.iPower;
+
+  // Numbers exactly at the interval bounds read back as the same number if the mantissa is even
+  const bool bAcceptBounds = ((mv >> 2) & 1) == 0;
+
+  // Lower bound is closer if the mantissa is at the power of two
+  const u32 iLowerShift = (iIeeeMantissa != 0 || iIeeeExponent <= 1);
+
+  // Scale the value and the interval bounds
+  u64 vr = MulShift(mv, scale.aiFactor, scale.iShift);
+  u64 vp = MulShift(mv + 2, scale.aiFactor, scale.iShift);
+  u64 vm = MulShift(mv - 1 - iLowerShift, scale.aiFactor, scale.iShift);
+
+  // Whether digits that have been cut off from the values are zeros
+  bool bLowerZeros = false;
+  bool bValueZeros = false;
+
+  if (scale.iExp2 >= 0) {
+    if (q <= 21) {
+      // Only one of the values can be a multiple of 5
+      if (mv % 5 == 0) {
+        bValueZeros = IsMultipleOfPowerOf5(mv, q);
+
+      } else if (bAcceptBounds) {
+        bLowerZeros = IsMultipleOfPowerOf5(mv - 1 - iLowerShift, q);
+
+      } else {
+        vp -= IsMultipleOfPowerOf5(mv + 2, q);
+      }
+    }
+
+  } else {
+    if (q <= 1) {
+      // Value has at least two trailing zero bits
+      bValueZeros = true;
+
+      if (bAcceptBounds) {
+        bLowerZeros = (iLowerShift == 1);
+      } else {
+        --vp;
+      }
+
+    } else if (q < 63) {
+      bValueZeros = IsMultipleOfPowerOf2(mv, q);
+    }
+  }
+
+  // Remove digits while the bounds still differ
+  s32 ctRemoved = 0;
+  u32 iLastDigit = 0;
+  u64 iOutput;
+
+  if (bLowerZeros || bValueZeros) {
+    // General case that's very rare
+    while (vp / 10 > vm / 10) {
+      bLowerZeros &= (vm % 10 == 0);
+      bValueZeros &= (iLastDigit == 0);
+      iLastDigit = (u32)(vr % 10);
+
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++ctRemoved;
+    }
+
+    if (bLowerZeros) {
+      while (vm % 10 == 0) {
+        bValueZeros &= (iLastDigit == 0);
+        iLastDigit = (u32)(vr % 10);
+
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        ++ctRemoved;
+      }
+    }
+
+    // Round to even if the exact number ends with 5
+    if (bValueZeros && iLastDigit == 5 && vr % 2 == 0) {
+      iLastDigit = 4;
+    }
+
+    // Take the next number if the value is out of bounds or it needs to be rounded up
+    iOutput = vr + ((vr == vm && (!bAcceptBounds || !bLowerZeros)) || iLastDigit >= 5);
+
+  } else {
+    bool bRoundUp = false;
+
+    // Remove two digits at a time
+    if (vp / 100 > vm / 100) {
+      bRoundUp = (vr % 100 >= 50);
+
+      vr /= 100;
+      vp /= 100;
+      vm /= 100;
+      ctRemoved += 2;
+    }
+
+    while (vp / 10 > vm / 10) {
+      bRoundUp = (vr % 10 >= 5);
+
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++ctRemoved;
+    }
+
+    // Take the next number if the value is out of bounds or it needs to be rounded up
+    iOutput = vr + (vr == vm || bRoundUp);
+  }
+
+  dec.iDigits = iOutput;
+  dec.iExp10 = scale.iExp10 + ctRemoved;
+};
+
+// Base of the digit groups of subnormal numbers and their amount
+// (mantissa * 2^-1074 is written as mantissa * 5^1074 with less than 770 digits)
+#define SUBNORMAL_LIMB_BASE 1000000000
+#define SUBNORMAL_LIMB_DIGITS 9
+#define SUBNORMAL_LIMBS 90
+#define SUBNORMAL_POW5 1074
+
+// Leading 18 digits of a subnormal number computed exactly (returns true if the rest of the digits are zeros)
+static bool SubnormalDecimal(u64 iIeeeMantissa, DecimalNumber &dec) {
+  // Groups of digits from the lowest one
+  u32 aiLimbs[SUBNORMAL_LIMBS];
+  s32 ctLimbs = 0;
+
+  for (u64 iRest = iIeeeMantissa; iRest != 0; iRest /= SUBNORMAL_LIMB_BASE) {
+    aiLimbs[ctLimbs++] = (u32)(iRest % SUBNORMAL_LIMB_BASE);
+  }
+
+  // Multiply by 5^1074 with up to 5^13 at a time
+  for (s32 iPower = SUBNORMAL_POW5; iPower > 0; iPower -= 13) {
+    u64 iFactor = 1;
+
+    for (s32 i = (iPower < 13 ? iPower : 13); i > 0; --i) {
+      iFactor *= 5;
+    }
+
+    u64 iCarry = 0;
+
+    for (s32 iLimb = 0; iLimb < ctLimbs; ++iLimb) {
+      const u64 iProduct = aiLimbs[iLimb] * iFactor + iCarry;
+      aiLimbs[iLimb] = (u32)(iProduct % SUBNORMAL_LIMB_BASE);
+      iCarry = iProduct / SUBNORMAL_LIMB_BASE;
+    }
+
+    for (; iCarry != 0; iCarry /= SUBNORMAL_LIMB_BASE) {
+      aiLimbs[ctLimbs++] = (u32)(iCarry % SUBNORMAL_LIMB_BASE);
+    }
+  }
+
+  // Take digits from the highest group until there are 18 of them
+  const s32 ctTopDigits = DecimalLength(aiLimbs[ctLimbs - 1]);
+  const s32 ctTotal = ctTopDigits + (ctLimbs - 1) * SUBNORMAL_LIMB_DIGITS;
+
+  u64 iDigits = aiLimbs[ctLimbs - 1];
+  s32 ctTaken = ctTopDigits;
+  s32 iLimb = ctLimbs - 2;
+
+  // Remaining digits of the group that has been taken partially
+  u32 iPartRest = 0;
+
+  for (; ctTaken < 18; --iLimb) {
+    const s32 ctTake = (18 - ctTaken < SUBNORMAL_LIMB_DIGITS ? 18 - ctTaken : SUBNORMAL_LIMB_DIGITS);
+    const u32 iDivisor = (u32)_aiPowersOfTen[SUBNORMAL_LIMB_DIGITS - ctTake];
+
+    iDigits = iDigits * _aiPowersOfTen[ctTake] + aiLimbs[iLimb] / iDivisor;
+    iPartRest = aiLimbs[iLimb] % iDivisor;
+    ctTaken += ctTake;
+  }
+
+  dec.iDigits = iDigits;
+  dec.iExp10 = ctTotal - ctTaken - SUBNORMAL_POW5;
+
+  bool bExact = (iPartRest == 0);
+
+  for (; bExact && iLimb >= 0; --iLimb) {
+    bExact = (aiLimbs[iLimb] == 0);
+  }
+
+  return bExact;
+};
+
+// Round the exact decimal value to a certain amount of significant digits (half to even)
+static void RoundedDecimal(u64 iIeeeMantissa, u32 iIeeeExponent, s32 ctDigits, DecimalNumber &dec) {
+  bool bExact;
+
+  // Subnormal numbers are out of range of the tables, so their digits are computed exactly
+  if (iIeeeExponent == 0) {
+    bExact = SubnormalDecimal(iIeeeMantissa, dec);
+
+  } else {
+    DecimalScale scale;
+    PrepareScale(iIeeeMantissa, iIeeeExponent, scale);
+
+    // Floor of the exact value with at least 17 digits
+    dec.iDigits = MulShift(scale.iMantissa, scale.aiFactor, scale.iShift);
+    dec.iExp10 = scale.iExp10;
+
+    // Check if the value has been divided without a remainder
+    if (scale.iExp2 >= 0) {
+      bExact = (scale.iPower <= 22 && IsMultipleOfPowerOf5(scale.iMantissa, scale.iPower));
+    } else {
+      bExact = (scale.iPower < 63 && IsMultipleOfPowerOf2(scale.iMantissa, scale.iPower));
+    }
+  }
+
+  // Remove extra digits at once
+  const s32 ctLength = DecimalLength(dec.iDigits);
+
+  if (ctLength <= ctDigits) {
+    return;
+  }
+
+  const u64 iDivisor = _aiPowersOfTen[ctLength - ctDigits];
+  const u64 iRemainder = dec.iDigits % iDivisor;
+
+  dec.iDigits /= iDivisor;
+  dec.iExp10 += ctLength - ctDigits;
+
+  // Round up unless exactly in the middle with an even last digit
+  const u64 iHalf = iDivisor / 2;
+
+  if (iRemainder > iHalf || (iRemainder == iHalf && (!bExact || (dec.iDigits & 1)))) {
+    ++dec.iDigits;
+
+    // Rounded up to the next power of ten
+    if (dec.iDigits == _aiPowersOfTen[ctDigits]) {
+      dec.iDigits /= 10;
+      ++dec.iExp10;
+    }
+  }
+};
+
+size_t FormatDouble(c8 *pchBuffer, f64 fValue, s32 iDigits) {
+  u64 iBits;
+  memcpy(&iBits, &fValue, sizeof(iBits));
+
+  const bool bNegative = (iBits >> 63) != 0;
+  const u64 iIeeeMantissa = iBits & (((u64)1 << DOUBLE_MANTISSA_BITS) - 1);
+  const u32 iIeeeExponent = (u32)(iBits >> DOUBLE_MANTISSA_BITS) & 0x7FF;
+
+  c8 *pch = pchBuffer;
+
+  // Not a number
+  if (iIeeeExponent == 0x7FF && iIeeeMantissa != 0) {
+    strcpy(pchBuffer, "nan");
+    return 3;
+  }
+
+  if (bNegative) {
+    *pch++ = '-';
+  }
+
+  // Infinity
+  if (iIeeeExponent == 0x7FF) {
+    strcpy(pch, "inf");
+    return pch + 3 - pchBuffer;
+  }
+
+  // Zero
+  if (iIeeeExponent == 0 && iIeeeMantissa == 0) {
+    strcpy(pch, "0");
+    return pch + 1 - pchBuffer;
+  }
+
+  DecimalNumber dec;
+
+  if (iDigits < 1 || iDigits > 17) {
+    iDigits = 17;
+    ShortestDecimal(iIeeeMantissa, iIeeeExponent, dec);
+
+  } else {
+    RoundedDecimal(iIeeeMantissa, iIeeeExponent, iDigits, dec);
+  }
+
+  // Remove trailing zeros
+  while (dec.iDigits % 10 == 0) {
+    dec.iDigits /= 10;
+    ++dec.iExp10;
+  }
+
+  // Write digits from the end
+  c8 strDigits[20];
+  s32 ctDigits = 0;
+
+  for (u64 iRest = dec.iDigits; iRest != 0; iRest /= 10) {
+    strDigits[sizeof(strDigits) - 1 - ctDigits] = (c8)('0' + iRest % 10);
+    ++ctDigits;
+  }
+
+  const c8 *pchDigits = strDigits + sizeof(strDigits) - ctDigits;
+
+  // Exponent of the first digit
+  const s32 iExp = dec.iExp10 + ctDigits - 1;
+
+  // Scientific notation
+  if (iExp < -4 || iExp >= iDigits) {
+    *pch++ = pchDigits[0];
+
+    if (ctDigits > 1) {
+      *pch++ = '.';
+      memcpy(pch, pchDigits + 1, ctDigits - 1);
+      pch += ctDigits - 1;
+    }
+
+    // At least two exponent digits
+    s32 iExpAbs = (iExp < 0 ? -iExp : iExp);
+    *pch++ = 'e';
+    *pch++ = (iExp < 0 ? '-' : '+');
+
+    if (iExpAbs >= 100) {
+      *pch++ = (c8)('0' + iExpAbs / 100);
+      iExpAbs %= 100;
+    }
+
+    *pch++ = (c8)('0' + iExpAbs / 10);
+    *pch++ = (c8)('0' + iExpAbs % 10);
+
+  // Number without a whole part
+  } else if (iExp < 0) {
+    *pch++ = '0';
+    *pch++ = '.';
+
+    for (s32 iZero = -1; iZero > iExp; --iZero) {
+      *pch++ = '0';
+    }
+
+    memcpy(pch, pchDigits, ctDigits);
+    pch += ctDigits;
+
+  // Whole number with an optional fraction
+  } else {
+    const s32 ctWhole = iExp + 1;
+
+    if (ctDigits <= ctWhole) {
+      memcpy(pch, pchDigits, ctDigits);
+      pch += ctDigits;
+
+      for (s32 iZero = ctDigits; iZero < ctWhole; ++iZero) {
+        *pch++ = '0';
+      }
+
+    } else {
+      memcpy(pch, pchDigits, ctWhole);
+      pch += ctWhole;
+      *pch++ = '.';
+      memcpy(pch, pchDigits + ctWhole, ctDigits - ctWhole);
+      pch += ctDigits - ctWhole;
+    }
+  }
+
+  *pch = '\0';
+  return pch - pchBuffer;
+};
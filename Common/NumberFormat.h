@@ -0,0 +1,45 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_NUMBERFORMAT_H
+#define _COMMON_NUMBERFORMAT_H
+
+// Buffer size that fits any formatted number with the null terminator
+#define FLOAT_TEXT_LENGTH 32
+
+// Amount of significant digits that stands for the shortest representation that reads back as the same number
+#define FLOAT_DIGITS_SHORTEST 0
+
+// Significant digits of floating-point numbers in output files (6 by default, same as standard streams)
+extern s32 _iFloatDigits;
+
+// Write a number into the buffer in the same style as "%g" and return its length
+// Amount of significant digits may be 1-17 or FLOAT_DIGITS_SHORTEST
+// The result doesn't depend on the platform, the C library or the current locale
+size_t FormatDouble(c8 *pchBuffer, f64 fValue, s32 iDigits);
+
+// Longest text of a number formatted with a certain amount of significant digits
+inline size_t MaxFloatTextLength(s32 iDigits) {
+  // Sign, digits, decimal point and a three-digit exponent
+  return (iDigits < 1 || iDigits > 17 ? 17 : iDigits) + 7;
+};
+
+#endif
@@ -0,0 +1,34 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_NUMBERPARSER_H
+#define _COMMON_NUMBERPARSER_H
+
+// Parse a decimal floating-point number written in C locale format (e.g. "-12.5e-3")
+// The result is correctly rounded, the same as strtod() in the "C" locale would give
+// Returns position after the number or nullptr if there is no number
+const c8 *ParseDouble(const c8 *pchBegin, const c8 *pchEnd, f64 &fValue);
+
+// Parse a decimal integer number with an optional sign
+// Returns position after the number or nullptr if there is no number or it doesn't fit
+const c8 *ParseInteger(const c8 *pchBegin, const c8 *pchEnd, s64 &iValue);
+
+#endif
@@ -0,0 +1,225 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Common/OutputFile.h"
+
+#include "Common/FileSystem.h"
+#include "Common/InputFile.h"
+#include "Common/MemoryStats.h"
+
+bool _bKeepUnchangedFiles = false;
+
+COutputFile::COutputFile(void) :
+  _pFile(nullptr), _pchBuffer(nullptr), _iUsed(0), _iCapacity(0), _iWritten(0)
+{
+};
+
+COutputFile::~COutputFile(void) {
+  // Keep whatever has been written so far without throwing any errors
+  if (_pFile != nullptr) {
+    fwrite(_pchBuffer, 1, _iUsed, _pFile);
+    fclose(_pFile);
+
+    // Existing file stays intact
+    if (!_strTemp.empty()) {
+      remove(_strTemp.c_str());
+    }
+  }
+
+  if (_pchBuffer != nullptr) {
+    AddMemoryStructure("Output file buffer", _iCapacity);
+  }
+
+  delete[] _pchBuffer;
+};
+
+void COutputFile::Open(const Str_t &strFile) {
+  FileInfo info;
+  _strTemp = "";
+
+  // Compare with the existing file after writing
+  if (_bKeepUnchangedFiles && GetFileInfo(strFile, info) && !info.bDir) {
+    _strTemp = strFile + ".new";
+  }
+
+  _pFile = fopen((_strTemp.empty() ? strFile : _strTemp).c_str(), "wb");
+
+  if (_pFile == nullptr) {
+    CMessageException::Throw("Cannot create file '%s'", strFile.c_str());
+  }
+
+  // Everything is buffered here
+  setvbuf(_pFile, nullptr, _IONBF, 0);
+
+  _strFile = strFile;
+  _iUsed = 0;
+  _iWritten = 0;
+
+  if (_pchBuffer == nullptr) {
+    Reserve(OUTPUT_BLOCK_SIZE);
+  }
+};
+
+void COutputFile::Reserve(size_t iSize) {
+  // Numbers are always written straight into the buffer
+  if (iSize < FLOAT_TEXT_LENGTH) {
+    iSize = FLOAT_TEXT_LENGTH;
+
+  } else if (iSize > OUTPUT_MAX_RESERVE) {
+    iSize = OUTPUT_MAX_RESERVE;
+  }
+
+  if (iSize <= _iCapacity) {
+    return;
+  }
+
+  c8 *pchNewBuffer = new c8[iSize];
+  memcpy(pchNewBuffer, _pchBuffer, _iUsed);
+
+  delete[] _pchBuffer;
+  _pchBuffer = pchNewBuffer;
+  _iCapacity = iSize;
+};
+
+void COutputFile::Flush(void) {
+  if (_iUsed == 0) {
+    return;
+  }
+
+  WriteDirectly(_pchBuffer, _iUsed);
+  _iUsed = 0;
+};
+
+void COutputFile::Close(void) {
+  if (_pFile == nullptr) {
+    return;
+  }
+
+  Flush();
+
+  FILE *pFile = _pFile;
+  _pFile = nullptr;
+
+  if (fclose(pFile) != 0) {
+    if (!_strTemp.empty()) {
+      remove(_strTemp.c_str());
+    }
+
+    CMessageException::Throw("Cannot write file '%s'", _strFile.c_str());
+  }
+
+  if (!_strTemp.empty()) {
+    ReplaceIfChanged();
+  }
+};
+
+// Check if both files have the same contents
+static bool IsSameFile(const Str_t &strFile1, const Str_t &strFile2) {
+  CInputFile file1, file2;
+
+  if (!file1.TryOpen(strFile1) || !file2.TryOpen(strFile2) || file1.GetSize() != file2.GetSize()) {
+    return false;
+  }
+
+  return file1.GetSize() == 0 || memcmp(file1.GetData(), file2.GetData(), file1.GetSize()) == 0;
+};
+
+void COutputFile::ReplaceIfChanged(void) {
+  const Str_t strTemp = _strTemp;
+  _strTemp = "";
+
+  // Keep modification time of the existing file
+  if (IsSameFile(strTemp, _strFile)) {
+    remove(strTemp.c_str());
+    return;
+  }
+
+  remove(_strFile.c_str());
+
+  if (rename(strTemp.c_str(), _strFile.c_str()) != 0) {
+    CMessageException::Throw("Cannot write file '%s'", _strFile.c_str());
+  }
+};
+
+void COutputFile::WriteDirectly(const c8 *pchData, size_t iSize) {
+  if (fwrite(pchData, 1, iSize, _pFile) != iSize) {
+    CMessageException::Throw("Cannot write file '%s'", _strFile.c_str());
+  }
+
+  _iWritten += iSize;
+};
+
+// Move to a position in the file
+static bool SeekFile(FILE *pFile, u64 iPos, int iOrigin) {
+#if defined(_MSC_VER) && _MSC_VER >= 1400
+  return _fseeki64(pFile, (__int64)iPos, iOrigin) == 0;
+#elif defined(_WIN32)
+  return fseek(pFile, (long)iPos, iOrigin) == 0;
+#else
+  return fseeko(pFile, (off_t)iPos, iOrigin) == 0;
+#endif
+};
+
+void COutputFile::Overwrite(u64 iPos, const c8 *pchData, size_t iSize) {
+  if (iPos + iSize > Tell()) {
+    CMessageException::Throw("Cannot overwrite text past the end of file '%s'", _strFile.c_str());
+  }
+
+  // Part that's still in the buffer
+  if (iPos + iSize > _iWritten) {
+    const size_t iSkip = (iPos < _iWritten ? (size_t)(_iWritten - iPos) : 0);
+    memcpy(_pchBuffer + (size_t)(iPos + iSkip - _iWritten), pchData + iSkip, iSize - iSkip);
+
+    iSize = iSkip;
+  }
+
+  // Part that has already been written into the file
+  if (iSize == 0) {
+    return;
+  }
+
+  if (!SeekFile(_pFile, iPos, SEEK_SET) || fwrite(pchData, 1, iSize, _pFile) != iSize || !SeekFile(_pFile, 0, SEEK_END)) {
+    CMessageException::Throw("Cannot write file '%s'", _strFile.c_str());
+  }
+};
+
+void COutputFile::WriteUnsigned(u64 iValue, bool bNegative) {
+  c8 *pch = Require(21);
+
+  if (bNegative) {
+    *pch++ = '-';
+  }
+
+  // Write digits from the end
+  c8 strDigits[20];
+  c8 *pchDigit = strDigits + sizeof(strDigits);
+
+  do {
+    *--pchDigit = (c8)('0' + iValue % 10);
+    iValue /= 10;
+  } while (iValue != 0);
+
+  const size_t ctDigits = strDigits + sizeof(strDigits) - pchDigit;
+  memcpy(pch, pchDigit, ctDigits);
+
+  _iUsed = (pch + ctDigits) - _pchBuffer;
+};
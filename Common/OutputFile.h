@@ -0,0 +1,209 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_OUTPUTFILE_H
+#define _COMMON_OUTPUTFILE_H
+
+#include "Common/NumberFormat.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// 64-bit integers that are different from 'long' on every platform
+#if defined(_MSC_VER)
+  typedef __int64 OutputLongLong_t;
+  typedef unsigned __int64 OutputULongLong_t;
+#else
+  __extension__ typedef long long OutputLongLong_t;
+  __extension__ typedef unsigned long long OutputULongLong_t;
+#endif
+
+// Default size of the output buffer
+#define OUTPUT_BLOCK_SIZE (1024 * 1024)
+
+// Biggest buffer that can be reserved for the whole file at once
+#define OUTPUT_MAX_RESERVE (256 * 1024 * 1024)
+
+// Write new files into temporary ones and keep existing files if their contents don't change
+extern bool _bKeepUnchangedFiles;
+
+// Text file that's written in big blocks from a memory buffer
+// If the buffer can fit the whole file, it's written out with a single call upon closing
+class COutputFile {
+  private:
+    FILE *_pFile;
+    Str_t _strFile;
+    Str_t _strTemp; // File that's actually being written if the existing file might stay the same
+
+    c8 *_pchBuffer;
+    size_t _iUsed;
+    size_t _iCapacity;
+    u64 _iWritten; // Text that has been written into the file past the buffer
+
+  private:
+    // Not copyable
+    COutputFile(const COutputFile &);
+    COutputFile &operator=(const COutputFile &);
+
+    // Make sure there's enough space for a certain amount of characters
+    inline c8 *Require(size_t iSize) {
+      if (_iUsed + iSize > _iCapacity) {
+        Flush();
+      }
+
+      return _pchBuffer + _iUsed;
+    };
+
+    // Write a whole number
+    void WriteUnsigned(u64 iValue, bool bNegative);
+
+    // Replace the file with the temporary one unless they're the same
+    void ReplaceIfChanged(void);
+
+  public:
+    COutputFile(void);
+    ~COutputFile(void);
+
+    // Create the file for writing (throws an exception if it can't be created)
+    void Open(const Str_t &strFile);
+
+    // Allocate the buffer for a certain amount of text (e.g. the expected file size)
+    void Reserve(size_t iSize);
+
+    // Write buffered text into the file
+    void Flush(void);
+
+    // Write the rest of the text and close the file
+    void Close(void);
+
+    // Write raw text
+    inline void Write(const c8 *pchData, size_t iSize) {
+      // Doesn't fit into the buffer
+      if (iSize > _iCapacity - _iUsed) {
+        Flush();
+
+        if (iSize > _iCapacity) {
+          WriteDirectly(pchData, iSize);
+          return;
+        }
+      }
+
+      memcpy(_pchBuffer + _iUsed, pchData, iSize);
+      _iUsed += iSize;
+    };
+
+    // Write text past the buffer
+    void WriteDirectly(const c8 *pchData, size_t iSize);
+
+    // Position in the file where the next text will be written
+    inline u64 Tell(void) const {
+      return _iWritten + _iUsed;
+    };
+
+    // Replace text that has already been written at a certain position (e.g. sizes and checksums that are only known at the end)
+    void Overwrite(u64 iPos, const c8 *pchData, size_t iSize);
+
+    // Write 16-bit number in little-endian byte order (for binary files)
+    inline void WriteShort(u16 iValue) {
+      c8 *pch = Require(2);
+      pch[0] = (c8)(iValue & 0xFF);
+      pch[1] = (c8)(iValue >> 8);
+      _iUsed += 2;
+    };
+
+    // Write 32-bit number in little-endian byte order (for binary files)
+    inline void WriteLong(u32 iValue) {
+      c8 *pch = Require(4);
+      pch[0] = (c8)(iValue & 0xFF);
+      pch[1] = (c8)((iValue >> 8) & 0xFF);
+      pch[2] = (c8)((iValue >> 16) & 0xFF);
+      pch[3] = (c8)(iValue >> 24);
+      _iUsed += 4;
+    };
+
+    // Write number as a single precision float (for binary files)
+    inline void WriteFloat(f64 fValue) {
+      const f32 fSingle = (f32)fValue;
+      u32 iBits;
+      memcpy(&iBits, &fSingle, sizeof(iBits));
+      WriteLong(iBits);
+    };
+
+    // Write text after its length (for binary files)
+    inline void WriteString(const Str_t &str) {
+      WriteLong((u32)str.size());
+      Write(str.c_str(), str.size());
+    };
+
+    inline COutputFile &operator<<(const c8 *str) {
+      Write(str, strlen(str));
+      return *this;
+    };
+
+    inline COutputFile &operator<<(const Str_t &str) {
+      Write(str.c_str(), str.size());
+      return *this;
+    };
+
+    inline COutputFile &operator<<(c8 ch) {
+      *Require(1) = ch;
+      ++_iUsed;
+      return *this;
+    };
+
+    // Numbers are formatted with the precision of output files
+    inline COutputFile &operator<<(f64 fValue) {
+      _iUsed += FormatDouble(Require(FLOAT_TEXT_LENGTH), fValue, _iFloatDigits);
+      return *this;
+    };
+
+    inline COutputFile &operator<<(int iValue) {
+      WriteUnsigned(iValue < 0 ? 0 - (u64)iValue : (u64)iValue, iValue < 0);
+      return *this;
+    };
+
+    inline COutputFile &operator<<(unsigned int iValue) {
+      WriteUnsigned(iValue, false);
+      return *this;
+    };
+
+    inline COutputFile &operator<<(long iValue) {
+      WriteUnsigned(iValue < 0 ? 0 - (u64)iValue : (u64)iValue, iValue < 0);
+      return *this;
+    };
+
+    inline COutputFile &operator<<(unsigned long iValue) {
+      WriteUnsigned(iValue, false);
+      return *this;
+    };
+
+    inline COutputFile &operator<<(OutputLongLong_t iValue) {
+      WriteUnsigned(iValue < 0 ? 0 - (u64)iValue : (u64)iValue, iValue < 0);
+      return *this;
+    };
+
+    inline COutputFile &operator<<(OutputULongLong_t iValue) {
+      WriteUnsigned(iValue, false);
+      return *this;
+    };
+};
+
+#endif
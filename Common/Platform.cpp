@@ -0,0 +1,315 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Common/Platform.h"
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+  #include <psapi.h>
+  #include <malloc.h>
+
+  #ifdef _MSC_VER
+    #pragma comment(lib, "psapi.lib")
+  #endif
+#else
+  #include <pthread.h>
+  #include <unistd.h>
+  #include <time.h>
+  #include <sys/resource.h>
+
+  #ifdef __APPLE__
+    #include <malloc/malloc.h>
+  #else
+    #include <malloc.h>
+  #endif
+#endif
+
+#ifdef _WIN32
+
+CMutex::CMutex(void) {
+  CRITICAL_SECTION *pcs = new CRITICAL_SECTION;
+  InitializeCriticalSection(pcs);
+  _pHandle = pcs;
+};
+
+CMutex::~CMutex(void) {
+  CRITICAL_SECTION *pcs = (CRITICAL_SECTION *)_pHandle;
+  DeleteCriticalSection(pcs);
+  delete pcs;
+};
+
+void CMutex::Lock(void) {
+  EnterCriticalSection((CRITICAL_SECTION *)_pHandle);
+};
+
+void CMutex::Unlock(void) {
+  LeaveCriticalSection((CRITICAL_SECTION *)_pHandle);
+};
+
+#else
+
+CMutex::CMutex(void) {
+  pthread_mutex_t *pmx = new pthread_mutex_t;
+  pthread_mutex_init(pmx, nullptr);
+  _pHandle = pmx;
+};
+
+CMutex::~CMutex(void) {
+  pthread_mutex_t *pmx = (pthread_mutex_t *)_pHandle;
+  pthread_mutex_destroy(pmx);
+  delete pmx;
+};
+
+void CMutex::Lock(void) {
+  pthread_mutex_lock((pthread_mutex_t *)_pHandle);
+};
+
+void CMutex::Unlock(void) {
+  pthread_mutex_unlock((pthread_mutex_t *)_pHandle);
+};
+
+#endif
+
+// Function with its parameter for starting a thread
+struct ThreadStart {
+  ThreadFunc_t pFunc;
+  void *pParam;
+};
+
+#ifdef _WIN32
+
+static DWORD WINAPI ThreadEntry(LPVOID pData) {
+  ThreadStart start = *(ThreadStart *)pData;
+  delete (ThreadStart *)pData;
+
+  start.pFunc(start.pParam);
+  return 0;
+};
+
+#else
+
+static void *ThreadEntry(void *pData) {
+  ThreadStart start = *(ThreadStart *)pData;
+  delete (ThreadStart *)pData;
+
+  start.pFunc(start.pParam);
+  return nullptr;
+};
+
+#endif
+
+CThread::CThread(void) : _pHandle(nullptr)
+{
+};
+
+CThread::~CThread(void) {
+  Join();
+};
+
+bool CThread::Start(ThreadFunc_t pFunc, void *pParam) {
+  // Already running
+  if (_pHandle != nullptr) {
+    return false;
+  }
+
+  ThreadStart *pStart = new ThreadStart;
+  pStart->pFunc = pFunc;
+  pStart->pParam = pParam;
+
+#ifdef _WIN32
+  HANDLE hThread = CreateThread(nullptr, 0, &ThreadEntry, pStart, 0, nullptr);
+
+  if (hThread == nullptr) {
+    delete pStart;
+    return false;
+  }
+
+  _pHandle = hThread;
+
+#else
+  pthread_t *pThread = new pthread_t;
+
+  if (pthread_create(pThread, nullptr, &ThreadEntry, pStart) != 0) {
+    delete pThread;
+    delete pStart;
+    return false;
+  }
+
+  _pHandle = pThread;
+#endif
+
+  return true;
+};
+
+void CThread::Join(void) {
+  // Not running
+  if (_pHandle == nullptr) {
+    return;
+  }
+
+#ifdef _WIN32
+  WaitForSingleObject((HANDLE)_pHandle, INFINITE);
+  CloseHandle((HANDLE)_pHandle);
+
+#else
+  pthread_t *pThread = (pthread_t *)_pHandle;
+  pthread_join(*pThread, nullptr);
+  delete pThread;
+#endif
+
+  _pHandle = nullptr;
+};
+
+// Amount of threads that can run simultaneously
+s32 GetHardwareThreads(void) {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  s32 ct = (s32)info.dwNumberOfProcessors;
+
+#else
+  s32 ct = (s32)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+  return (ct > 0 ? ct : 1);
+};
+
+// Identifier of the current thread
+u64 GetCurrentThreadID(void) {
+#ifdef _WIN32
+  return (u64)GetCurrentThreadId();
+#else
+  return (u64)pthread_self();
+#endif
+};
+
+// Put current thread to sleep
+void ThreadSleep(u32 iMilliseconds) {
+#ifdef _WIN32
+  Sleep(iMilliseconds);
+#else
+  usleep(iMilliseconds * 1000);
+#endif
+};
+
+// Monotonic time in seconds
+f64 GetTimeSeconds(void) {
+#ifdef _WIN32
+  LARGE_INTEGER llFreq, llTime;
+  QueryPerformanceFrequency(&llFreq);
+  QueryPerformanceCounter(&llTime);
+
+  return (f64)llTime.QuadPart / (f64)llFreq.QuadPart;
+
+#else
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (f64)ts.tv_sec + (f64)ts.tv_nsec * 1e-9;
+#endif
+};
+
+// Add a value to the counter that's shared between threads and return the new value
+u64 AtomicAdd(volatile u64 &iCounter, u64 iValue) {
+#ifdef _WIN32
+  return (u64)InterlockedExchangeAdd64((volatile LONG64 *)&iCounter, (LONG64)iValue) + iValue;
+#else
+  return __sync_add_and_fetch(&iCounter, iValue);
+#endif
+};
+
+// Raise the counter that's shared between threads up to the value
+void AtomicMax(volatile u64 &iCounter, u64 iValue) {
+  u64 iCurrent = iCounter;
+
+  while (iCurrent < iValue) {
+  #ifdef _WIN32
+    const u64 iPrevious = (u64)InterlockedCompareExchange64((volatile LONG64 *)&iCounter, (LONG64)iValue, (LONG64)iCurrent);
+  #else
+    const u64 iPrevious = __sync_val_compare_and_swap(&iCounter, iCurrent, iValue);
+  #endif
+
+    if (iPrevious == iCurrent) {
+      break;
+    }
+
+    iCurrent = iPrevious;
+  }
+};
+
+// Usable size of the memory block that has been allocated by malloc()
+size_t GetAllocationSize(void *pBlock) {
+#if defined(_WIN32)
+  return _msize(pBlock);
+#elif defined(__APPLE__)
+  return malloc_size(pBlock);
+#else
+  return malloc_usable_size(pBlock);
+#endif
+};
+
+// Largest amount of physical memory used by the process in bytes (0 if unknown)
+u64 GetPeakMemory(void) {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS pmc;
+
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+    return 0;
+  }
+
+  return (u64)pmc.PeakWorkingSetSize;
+
+#else
+  // Peak that can be reset on Linux
+  FILE *file = fopen("/proc/self/status", "r");
+
+  if (file != nullptr) {
+    c8 strLine[256];
+    u64 iKilobytes = 0;
+    bool bFound = false;
+
+    while (!bFound && fgets(strLine, sizeof(strLine), file) != nullptr) {
+      bFound = (sscanf(strLine, "VmHWM: %llu kB", (unsigned long long *)&iKilobytes) == 1);
+    }
+
+    fclose(file);
+
+    if (bFound) {
+      return iKilobytes * 1024;
+    }
+  }
+
+  // Peak since the start of the process
+  rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+
+  #ifdef __APPLE__
+    return (u64)usage.ru_maxrss;
+  #else
+    return (u64)usage.ru_maxrss * 1024;
+  #endif
+#endif
+};
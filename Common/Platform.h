@@ -0,0 +1,115 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_PLATFORM_H
+#define _COMMON_PLATFORM_H
+
+// 64-bit integer constant
+#if defined(_MSC_VER) && _MSC_VER < 1310
+  #define U64_C(_Value) _Value##ui64
+#else
+  #define U64_C(_Value) _Value##ULL
+#endif
+
+// Mutual exclusion object
+class CMutex {
+  private:
+    void *_pHandle;
+
+    // Not copyable
+    CMutex(const CMutex &);
+    CMutex &operator=(const CMutex &);
+
+  public:
+    CMutex(void);
+    ~CMutex(void);
+
+    void Lock(void);
+    void Unlock(void);
+};
+
+// Mutex that's locked for the lifetime of the object
+class CMutexLock {
+  private:
+    CMutex &_mutex;
+
+    // Not copyable
+    CMutexLock(const CMutexLock &);
+    CMutexLock &operator=(const CMutexLock &);
+
+  public:
+    CMutexLock(CMutex &mutex) : _mutex(mutex) {
+      _mutex.Lock();
+    };
+
+    ~CMutexLock(void) {
+      _mutex.Unlock();
+    };
+};
+
+// Function that's executed by a thread
+typedef void (*ThreadFunc_t)(void *pParam);
+
+// Operating system thread
+class CThread {
+  private:
+    void *_pHandle;
+
+    // Not copyable
+    CThread(const CThread &);
+    CThread &operator=(const CThread &);
+
+  public:
+    CThread(void);
+    ~CThread(void);
+
+    // Start executing a function in a new thread
+    bool Start(ThreadFunc_t pFunc, void *pParam);
+
+    // Wait until the thread finishes
+    void Join(void);
+};
+
+// Amount of threads that can run simultaneously
+s32 GetHardwareThreads(void);
+
+// Identifier of the current thread
+u64 GetCurrentThreadID(void);
+
+// Put current thread to sleep
+void ThreadSleep(u32 iMilliseconds);
+
+// Monotonic time in seconds
+f64 GetTimeSeconds(void);
+
+// Add a value to the counter that's shared between threads and return the new value
+u64 AtomicAdd(volatile u64 &iCounter, u64 iValue);
+
+// Raise the counter that's shared between threads up to the value
+void AtomicMax(volatile u64 &iCounter, u64 iValue);
+
+// Usable size of the memory block that has been allocated by malloc()
+size_t GetAllocationSize(void *pBlock);
+
+// Largest amount of physical memory used by the process in bytes (0 if unknown)
+u64 GetPeakMemory(void);
+
+#endif
@@ -0,0 +1,99 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Common/ScratchFile.h"
+
+#if !defined(_MSC_VER)
+  #include <sys/types.h>
+#endif
+
+CScratchFile::CScratchFile(void) :
+  _pFile(nullptr), _iSize(0)
+{
+};
+
+CScratchFile::~CScratchFile(void) {
+  Close();
+};
+
+void CScratchFile::Create(const Str_t &strFile) {
+  Close();
+
+  _pFile = fopen(strFile.c_str(), "w+b");
+
+  if (_pFile == nullptr) {
+    CMessageException::Throw("Cannot create scratch file '%s'", strFile.c_str());
+  }
+
+  _strFile = strFile;
+  _iSize = 0;
+};
+
+void CScratchFile::Close(void) {
+  if (_pFile == nullptr) {
+    return;
+  }
+
+  fclose(_pFile);
+  _pFile = nullptr;
+
+  remove(_strFile.c_str());
+  _iSize = 0;
+};
+
+void CScratchFile::Seek(u64 iOffset) {
+  #if defined(_MSC_VER) && _MSC_VER >= 1400
+    const bool bMoved = (_fseeki64(_pFile, (__int64)iOffset, SEEK_SET) == 0);
+
+  #elif defined(_MSC_VER)
+    // Positions are 64-bit integers in older runtimes
+    fpos_t pos = (fpos_t)iOffset;
+    const bool bMoved = (fsetpos(_pFile, &pos) == 0);
+
+  #else
+    const bool bMoved = (fseeko(_pFile, (off_t)iOffset, SEEK_SET) == 0);
+  #endif
+
+  if (!bMoved) {
+    CMessageException::Throw("Cannot seek in scratch file '%s'", _strFile.c_str());
+  }
+};
+
+u64 CScratchFile::Append(const void *pData, size_t iSize) {
+  const u64 iOffset = _iSize;
+  Seek(iOffset);
+
+  if (fwrite(pData, 1, iSize, _pFile) != iSize) {
+    CMessageException::Throw("Cannot write scratch file '%s' (out of disk space?)", _strFile.c_str());
+  }
+
+  _iSize += iSize;
+  return iOffset;
+};
+
+void CScratchFile::Read(u64 iOffset, void *pData, size_t iSize) {
+  Seek(iOffset);
+
+  if (fread(pData, 1, iSize, _pFile) != iSize) {
+    CMessageException::Throw("Cannot read scratch file '%s'", _strFile.c_str());
+  }
+};
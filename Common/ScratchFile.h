@@ -0,0 +1,68 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_SCRATCHFILE_H
+#define _COMMON_SCRATCHFILE_H
+
+#include <stdio.h>
+
+// Temporary file for data that doesn't fit into memory
+// It can grow past 4 GB and is deleted upon closing
+class CScratchFile {
+  private:
+    FILE *_pFile;
+    Str_t _strFile;
+    u64 _iSize;
+
+  private:
+    // Not copyable
+    CScratchFile(const CScratchFile &);
+    CScratchFile &operator=(const CScratchFile &);
+
+    // Move to a position in the file (throws an exception on failure)
+    void Seek(u64 iOffset);
+
+  public:
+    CScratchFile(void);
+    ~CScratchFile(void);
+
+    // Create an empty file (throws an exception if it can't be created)
+    void Create(const Str_t &strFile);
+
+    // Close and delete the file
+    void Close(void);
+
+    // Write data at the end of the file and return its offset
+    u64 Append(const void *pData, size_t iSize);
+
+    // Read data from some offset in the file
+    void Read(u64 iOffset, void *pData, size_t iSize);
+
+    inline bool IsOpen(void) const {
+      return _pFile != nullptr;
+    };
+
+    inline u64 GetSize(void) const {
+      return _iSize;
+    };
+};
+
+#endif
@@ -0,0 +1,200 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_SIMDMATH_H
+#define _COMMON_SIMDMATH_H
+
+// Widest instruction set enabled for the compiler
+#if defined(__AVX2__)
+  #include <immintrin.h>
+  #define SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define SIMD_SSE2 1
+#endif
+
+// Inputs above this magnitude are out of the range of the vectorized argument reduction
+#define SIMD_SINCOS_MAX 1e8
+
+#if SIMD_AVX2
+
+// Four doubles at once
+struct SimdLanes {
+  enum { COUNT = 4 };
+
+  typedef __m256d Vec;
+  typedef __m256d Mask;
+
+  static inline Vec Set(f64 f) { return _mm256_set1_pd(f); };
+  static inline Vec Load(const f64 *pf) { return _mm256_loadu_pd(pf); };
+  static inline void Store(f64 *pf, Vec v) { _mm256_storeu_pd(pf, v); };
+
+  static inline Vec Add(Vec a, Vec b) { return _mm256_add_pd(a, b); };
+  static inline Vec Sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); };
+  static inline Vec Mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); };
+
+  static inline Vec Abs(Vec v) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v); };
+  static inline Vec SignBits(Vec v) { return _mm256_and_pd(_mm256_set1_pd(-0.0), v); };
+  static inline Vec XorSign(Vec v, Vec vSign) { return _mm256_xor_pd(v, vSign); };
+  static inline Vec Select(Mask m, Vec a, Vec b) { return _mm256_blendv_pd(b, a, m); };
+  static inline Vec FlipSign(Vec v, Mask m) { return _mm256_xor_pd(v, _mm256_and_pd(m, _mm256_set1_pd(-0.0))); };
+
+  // Round a non-negative number to an even integer and get masks of its 2nd and 3rd bits (and of them after adding 2)
+  static inline Vec EvenOctant(Vec v, Mask &mBit1, Mask &mBit2, Mask &mNextBit2) {
+    __m128i iOctant = _mm256_cvttpd_epi32(v);
+    iOctant = _mm_and_si128(_mm_add_epi32(iOctant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+
+    // Widen each 32-bit integer to a whole 64-bit lane
+    const __m256i iWide = _mm256_cvtepi32_epi64(iOctant);
+    const __m256i iTwo = _mm256_set1_epi64x(2), iFour = _mm256_set1_epi64x(4);
+
+    mBit1 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(iWide, iTwo), iTwo));
+    mBit2 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(iWide, iFour), iFour));
+    mNextBit2 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(_mm256_add_epi64(iWide, iTwo), iFour), iFour));
+
+    return _mm256_cvtepi32_pd(iOctant);
+  };
+};
+
+#elif SIMD_SSE2
+
+// Two doubles at once
+struct SimdLanes {
+  enum { COUNT = 2 };
+
+  typedef __m128d Vec;
+  typedef __m128d Mask;
+
+  static inline Vec Set(f64 f) { return _mm_set1_pd(f); };
+  static inline Vec Load(const f64 *pf) { return _mm_loadu_pd(pf); };
+  static inline void Store(f64 *pf, Vec v) { _mm_storeu_pd(pf, v); };
+
+  static inline Vec Add(Vec a, Vec b) { return _mm_add_pd(a, b); };
+  static inline Vec Sub(Vec a, Vec b) { return _mm_sub_pd(a, b); };
+  static inline Vec Mul(Vec a, Vec b) { return _mm_mul_pd(a, b); };
+
+  static inline Vec Abs(Vec v) { return _mm_andnot_pd(_mm_set1_pd(-0.0), v); };
+  static inline Vec SignBits(Vec v) { return _mm_and_pd(_mm_set1_pd(-0.0), v); };
+  static inline Vec XorSign(Vec v, Vec vSign) { return _mm_xor_pd(v, vSign); };
+  static inline Vec Select(Mask m, Vec a, Vec b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); };
+  static inline Vec FlipSign(Vec v, Mask m) { return _mm_xor_pd(v, _mm_and_pd(m, _mm_set1_pd(-0.0))); };
+
+  // Round a non-negative number to an even integer and get masks of its 2nd and 3rd bits (and of them after adding 2)
+  static inline Vec EvenOctant(Vec v, Mask &mBit1, Mask &mBit2, Mask &mNextBit2) {
+    __m128i iOctant = _mm_cvttpd_epi32(v);
+    iOctant = _mm_and_si128(_mm_add_epi32(iOctant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+
+    // Spread each 32-bit integer over a whole 64-bit lane
+    const __m128i iSpread = _mm_shuffle_epi32(iOctant, _MM_SHUFFLE(1, 1, 0, 0));
+    const __m128i iTwo = _mm_set1_epi32(2), iFour = _mm_set1_epi32(4);
+
+    mBit1 = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(iSpread, iTwo), iTwo));
+    mBit2 = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(iSpread, iFour), iFour));
+    mNextBit2 = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(_mm_add_epi32(iSpread, iTwo), iFour), iFour));
+
+    return _mm_cvtepi32_pd(iOctant);
+  };
+};
+
+#else
+
+// One double at a time
+struct SimdLanes {
+  enum { COUNT = 1 };
+
+  typedef f64 Vec;
+  typedef bool Mask;
+
+  static inline Vec Set(f64 f) { return f; };
+  static inline Vec Load(const f64 *pf) { return *pf; };
+  static inline void Store(f64 *pf, Vec v) { *pf = v; };
+
+  static inline Vec Add(Vec a, Vec b) { return a + b; };
+  static inline Vec Sub(Vec a, Vec b) { return a - b; };
+  static inline Vec Mul(Vec a, Vec b) { return a * b; };
+
+  static inline Vec Abs(Vec v) { return (v < 0.0 ? -v : v); };
+  static inline Vec SignBits(Vec v) { return v; };
+  static inline Vec XorSign(Vec v, Vec vSign) { return (IsNegative(vSign) ? -v : v); };
+
+  // Check the sign bit (including negative zero)
+  static inline bool IsNegative(f64 f) {
+    u64 iBits;
+    memcpy(&iBits, &f, sizeof(iBits));
+    return (iBits >> 63) != 0;
+  };
+  static inline Vec Select(Mask m, Vec a, Vec b) { return (m ? a : b); };
+  static inline Vec FlipSign(Vec v, Mask m) { return (m ? -v : v); };
+
+  // Round a non-negative number to an even integer and get its 2nd and 3rd bits (and of them after adding 2)
+  static inline Vec EvenOctant(Vec v, Mask &mBit1, Mask &mBit2, Mask &mNextBit2) {
+    const s32 iOctant = ((s32)v + 1) & ~1;
+
+    mBit1 = (iOctant & 2) != 0;
+    mBit2 = (iOctant & 4) != 0;
+    mNextBit2 = ((iOctant + 2) & 4) != 0;
+
+    return (f64)iOctant;
+  };
+};
+
+#endif
+
+// Sine and cosine of all lanes (Cephes polynomials, within 2 ulp for magnitudes below SIMD_SINCOS_MAX)
+inline void SimdSinCos(SimdLanes::Vec vAngle, SimdLanes::Vec &vSin, SimdLanes::Vec &vCos) {
+  typedef SimdLanes L;
+
+  // Reduce the angle into [-Pi/4, Pi/4] using Pi/4 split into three parts
+  const L::Vec vAbs = L::Abs(vAngle);
+
+  L::Mask mSwap, mSinNeg, mCosNeg;
+  const L::Vec vOctant = L::EvenOctant(L::Mul(vAbs, L::Set(1.27323954473516268615)), mSwap, mSinNeg, mCosNeg);
+
+  L::Vec x = L::Sub(vAbs, L::Mul(vOctant, L::Set(7.85398125648498535156E-1)));
+  x = L::Sub(x, L::Mul(vOctant, L::Set(3.77489470793079817668E-8)));
+  x = L::Sub(x, L::Mul(vOctant, L::Set(2.69515142907905952645E-15)));
+
+  const L::Vec x2 = L::Mul(x, x);
+
+  // Sine polynomial
+  L::Vec vPolySin = L::Set(1.58962301576546568060E-10);
+  vPolySin = L::Add(L::Mul(vPolySin, x2), L::Set(-2.50507477628578072866E-8));
+  vPolySin = L::Add(L::Mul(vPolySin, x2), L::Set(2.75573136213857245213E-6));
+  vPolySin = L::Add(L::Mul(vPolySin, x2), L::Set(-1.98412698295895385996E-4));
+  vPolySin = L::Add(L::Mul(vPolySin, x2), L::Set(8.33333333332211858878E-3));
+  vPolySin = L::Add(L::Mul(vPolySin, x2), L::Set(-1.66666666666666307295E-1));
+  vPolySin = L::Add(x, L::Mul(L::Mul(x, x2), vPolySin));
+
+  // Cosine polynomial
+  L::Vec vPolyCos = L::Set(-1.13585365213876817300E-11);
+  vPolyCos = L::Add(L::Mul(vPolyCos, x2), L::Set(2.08757008419747316778E-9));
+  vPolyCos = L::Add(L::Mul(vPolyCos, x2), L::Set(-2.75573141792967388112E-7));
+  vPolyCos = L::Add(L::Mul(vPolyCos, x2), L::Set(2.48015872888517045348E-5));
+  vPolyCos = L::Add(L::Mul(vPolyCos, x2), L::Set(-1.38888888888730564116E-3));
+  vPolyCos = L::Add(L::Mul(vPolyCos, x2), L::Set(4.16666666666665929218E-2));
+  vPolyCos = L::Add(L::Sub(L::Set(1.0), L::Mul(x2, L::Set(0.5))), L::Mul(L::Mul(x2, x2), vPolyCos));
+
+  // Pick polynomials and signs for the octant
+  vSin = L::XorSign(L::FlipSign(L::Select(mSwap, vPolyCos, vPolySin), mSinNeg), L::SignBits(vAngle));
+  vCos = L::FlipSign(L::Select(mSwap, vPolySin, vPolyCos), mCosNeg);
+};
+
+#endif
@@ -0,0 +1,247 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Common/TaskScheduler.h"
+
+#include <algorithm>
+
+CTaskScheduler::CTaskScheduler(void) : _ctRemaining(0), _pFunc(nullptr), _pData(nullptr)
+{
+};
+
+CTaskScheduler::~CTaskScheduler(void) {
+  for (size_t i = 0; i < _aWorkers.size(); ++i) {
+    delete _aWorkers[i];
+  }
+};
+
+// Add new task with some estimated cost and return its index
+s32 CTaskScheduler::AddTask(u64 iCost) {
+  Task task;
+  task.iCost = iCost;
+  task.ctWaiting = 0;
+
+  _aTasks.push_back(task);
+  return (s32)_aTasks.size() - 1;
+};
+
+// Make a task wait until another task is finished
+void CTaskScheduler::AddDependency(s32 iTask, s32 iPrerequisite) {
+  if (iTask == iPrerequisite) {
+    return;
+  }
+
+  _aTasks[iTask].ctWaiting++;
+  _aTasks[iPrerequisite].aDependents.push_back(iTask);
+};
+
+// Put a ready task into the worker's queue
+void CTaskScheduler::Enqueue(s32 iWorker, s32 iTask) {
+  Worker &worker = *_aWorkers[iWorker];
+  CMutexLock lock(worker.mxQueue);
+
+  // Keep the queue sorted by cost
+  const u64 iCost = _aTasks[iTask].iCost;
+  std::deque<s32>::iterator itPos = worker.aQueue.begin();
+
+  while (itPos != worker.aQueue.end() && _aTasks[*itPos].iCost >= iCost) {
+    ++itPos;
+  }
+
+  worker.aQueue.insert(itPos, iTask);
+};
+
+// Take the biggest task from the worker's own queue
+bool CTaskScheduler::PopTask(s32 iWorker, s32 &iTask) {
+  Worker &worker = *_aWorkers[iWorker];
+  CMutexLock lock(worker.mxQueue);
+
+  if (worker.aQueue.empty()) {
+    return false;
+  }
+
+  iTask = worker.aQueue.front();
+  worker.aQueue.pop_front();
+  return true;
+};
+
+// Take the biggest task from any other worker
+bool CTaskScheduler::StealTask(s32 iWorker, s32 &iTask) {
+  const s32 ctWorkers = (s32)_aWorkers.size();
+
+  // Pick the victim with the biggest pending task
+  s32 iVictim = -1;
+  u64 iBestCost = 0;
+
+  for (s32 iOffset = 1; iOffset < ctWorkers; ++iOffset) {
+    const s32 iOther = (iWorker + iOffset) % ctWorkers;
+    Worker &other = *_aWorkers[iOther];
+
+    CMutexLock lock(other.mxQueue);
+
+    if (other.aQueue.empty()) {
+      continue;
+    }
+
+    const u64 iCost = _aTasks[other.aQueue.front()].iCost;
+
+    if (iVictim == -1 || iCost > iBestCost) {
+      iVictim = iOther;
+      iBestCost = iCost;
+    }
+  }
+
+  // Nothing to steal
+  if (iVictim == -1) {
+    return false;
+  }
+
+  // The queue might've been emptied in the meantime
+  return PopTask(iVictim, iTask);
+};
+
+// Release tasks that were waiting for this one
+void CTaskScheduler::FinishTask(s32 iWorker, s32 iTask) {
+  Ints_t aReady;
+
+  {
+    CMutexLock lock(_mxState);
+    _ctRemaining--;
+
+    const Ints_t &aDependents = _aTasks[iTask].aDependents;
+
+    for (size_t i = 0; i < aDependents.size(); ++i) {
+      if (--_aTasks[aDependents[i]].ctWaiting == 0) {
+        aReady.push_back(aDependents[i]);
+      }
+    }
+  }
+
+  // Continue with the released tasks on the same worker, others may steal them
+  for (size_t i = 0; i < aReady.size(); ++i) {
+    Enqueue(iWorker, aReady[i]);
+  }
+};
+
+// Keep executing tasks until there are none left
+void CTaskScheduler::WorkerLoop(s32 iWorker) {
+  for (;;) {
+    s32 iTask;
+
+    if (PopTask(iWorker, iTask) || StealTask(iWorker, iTask)) {
+      _pFunc(iTask, _pData);
+      FinishTask(iWorker, iTask);
+      continue;
+    }
+
+    // Everything is done
+    {
+      CMutexLock lock(_mxState);
+
+      if (_ctRemaining <= 0) {
+        break;
+      }
+    }
+
+    // Wait for other workers to release dependent tasks
+    ThreadSleep(1);
+  }
+};
+
+void CTaskScheduler::WorkerThread(void *pWorker) {
+  Worker *pThis = (Worker *)pWorker;
+  pThis->pScheduler->WorkerLoop(pThis->iIndex);
+};
+
+// Execute all tasks on a specific amount of threads (including the calling one)
+void CTaskScheduler::Run(s32 ctThreads, TaskFunc_t pFunc, void *pData) {
+  const s32 ctTasks = (s32)_aTasks.size();
+
+  if (ctTasks == 0) {
+    return;
+  }
+
+  if (ctThreads < 1) {
+    ctThreads = 1;
+  }
+
+  _pFunc = pFunc;
+  _pData = pData;
+  _ctRemaining = ctTasks;
+
+  // Create workers
+  s32 i;
+
+  for (i = 0; i < ctThreads; ++i) {
+    Worker *pWorker = new Worker;
+    pWorker->pScheduler = this;
+    pWorker->iIndex = i;
+
+    _aWorkers.push_back(pWorker);
+  }
+
+  // Gather tasks that can be started right away
+  Ints_t aReady;
+
+  for (i = 0; i < ctTasks; ++i) {
+    if (_aTasks[i].ctWaiting == 0) {
+      aReady.push_back(i);
+    }
+  }
+
+  // Deal ready tasks from the biggest to the smallest between the workers
+  CostOrder order;
+  order.paTasks = &_aTasks;
+  std::stable_sort(aReady.begin(), aReady.end(), order);
+
+  for (size_t iReady = 0; iReady < aReady.size(); ++iReady) {
+    _aWorkers[iReady % ctThreads]->aQueue.push_back(aReady[iReady]);
+  }
+
+  // Start extra threads and work on the calling one
+  std::vector<CThread *> aThreads;
+
+  for (i = 1; i < ctThreads; ++i) {
+    CThread *pThread = new CThread;
+
+    // Leave the queue to be stolen by others if the thread couldn't be started
+    if (!pThread->Start(&WorkerThread, _aWorkers[i])) {
+      delete pThread;
+      continue;
+    }
+
+    aThreads.push_back(pThread);
+  }
+
+  WorkerLoop(0);
+
+  for (size_t iThread = 0; iThread < aThreads.size(); ++iThread) {
+    aThreads[iThread]->Join();
+    delete aThreads[iThread];
+  }
+
+  for (i = 0; i < ctThreads; ++i) {
+    delete _aWorkers[i];
+  }
+
+  _aWorkers.clear();
+};
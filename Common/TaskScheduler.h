@@ -0,0 +1,102 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_TASKSCHEDULER_H
+#define _COMMON_TASKSCHEDULER_H
+
+#include "Common/Platform.h"
+
+#include <deque>
+
+// Work-stealing scheduler for independent tasks with optional dependencies
+class CTaskScheduler {
+  public:
+    // Function that executes a task by its index
+    typedef void (*TaskFunc_t)(s32 iTask, void *pData);
+
+  private:
+    // Scheduled task
+    struct Task {
+      u64 iCost;          // Estimated cost (bigger tasks are started first)
+      s32 ctWaiting;      // Amount of unfinished tasks that need to be done before this one
+      Ints_t aDependents; // Tasks that are waiting for this one
+    };
+
+    // Thread with its own task queue
+    struct Worker {
+      CTaskScheduler *pScheduler;
+      s32 iIndex;
+
+      CMutex mxQueue;
+      std::deque<s32> aQueue; // Ready tasks sorted from the biggest to the smallest
+    };
+
+    // Sorting order from the biggest to the smallest task
+    struct CostOrder {
+      const std::vector<Task> *paTasks;
+
+      bool operator()(s32 iTask1, s32 iTask2) const {
+        return (*paTasks)[iTask1].iCost > (*paTasks)[iTask2].iCost;
+      };
+    };
+
+    std::vector<Task> _aTasks;
+    std::vector<Worker *> _aWorkers;
+
+    CMutex _mxState;
+    s32 _ctRemaining; // Amount of unfinished tasks
+
+    TaskFunc_t _pFunc;
+    void *_pData;
+
+  private:
+    // Put a ready task into the worker's queue
+    void Enqueue(s32 iWorker, s32 iTask);
+
+    // Take the biggest task from the worker's own queue
+    bool PopTask(s32 iWorker, s32 &iTask);
+
+    // Take the biggest task from any other worker
+    bool StealTask(s32 iWorker, s32 &iTask);
+
+    // Release tasks that were waiting for this one
+    void FinishTask(s32 iWorker, s32 iTask);
+
+    // Keep executing tasks until there are none left
+    void WorkerLoop(s32 iWorker);
+
+    static void WorkerThread(void *pWorker);
+
+  public:
+    CTaskScheduler(void);
+    ~CTaskScheduler(void);
+
+    // Add new task with some estimated cost and return its index
+    s32 AddTask(u64 iCost);
+
+    // Make a task wait until another task is finished
+    void AddDependency(s32 iTask, s32 iPrerequisite);
+
+    // Execute all tasks on a specific amount of threads (including the calling one)
+    void Run(s32 ctThreads, TaskFunc_t pFunc, void *pData);
+};
+
+#endif
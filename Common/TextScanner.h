@@ -0,0 +1,343 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_TEXTSCANNER_H
+#define _COMMON_TEXTSCANNER_H
+
+#include "Common/NumberParser.h"
+
+#include <stdarg.h>
+
+// Single-pass reader of ASCII text files that keeps track of lines and columns
+class CTextScanner {
+  public:
+    const c8 *pchBegin; // Text start
+    const c8 *pchEnd;   // Text end
+    const c8 *pchCur;   // Current character
+    const c8 *pchLine;  // Start of the current line
+    u32 iLine;          // Current line number
+
+    // Characters that begin comments until the end of the line (besides '//')
+    const c8 *strLineComments;
+
+  public:
+    CTextScanner(const c8 *pchData, size_t iSize, const c8 *strSetComments = "") :
+      pchBegin(pchData), pchEnd(pchData + iSize), pchCur(pchData), pchLine(pchData), iLine(1),
+      strLineComments(strSetComments)
+    {
+    };
+
+    // Throw an exception with the current position in the text
+    void Throw(const c8 *strFormat, ...) const {
+      c8 strMessage[512];
+
+      va_list args;
+      va_start(args, strFormat);
+      vsnprintf(strMessage, sizeof(strMessage), strFormat, args);
+      va_end(args);
+
+      CMessageException::Throw("%s (line %u, column %u)", strMessage, iLine, (u32)(pchCur - pchLine + 1));
+    };
+
+    inline bool AtEnd(void) const {
+      return pchCur >= pchEnd;
+    };
+
+    // Check if the character starts a comment
+    inline bool IsComment(const c8 *pch) const {
+      if (*pch == '/' && pch + 1 < pchEnd) {
+        return pch[1] == '/' || pch[1] == '*';
+      }
+
+      return *pch != '\0' && strchr(strLineComments, *pch) != nullptr;
+    };
+
+    // Skip the comment under the cursor
+    void SkipComment(void) {
+      // Block comment
+      if (*pchCur == '/' && pchCur[1] == '*') {
+        pchCur += 2;
+
+        while (pchCur < pchEnd && !(*pchCur == '*' && pchCur + 1 < pchEnd && pchCur[1] == '/')) {
+          if (*pchCur == '\n') {
+            pchLine = pchCur + 1;
+            ++iLine;
+          }
+
+          ++pchCur;
+        }
+
+        pchCur += (pchCur < pchEnd ? 2 : 0);
+        return;
+      }
+
+      // Until the end of the line
+      while (pchCur < pchEnd && *pchCur != '\n' && *pchCur != '\r') {
+        ++pchCur;
+      }
+    };
+
+    // Skip spaces and comments on the current line
+    inline void SkipSpaces(void) {
+      while (pchCur < pchEnd) {
+        const c8 ch = *pchCur;
+
+        if (ch == ' ' || ch == '\t') {
+          ++pchCur;
+
+        } else if (IsComment(pchCur)) {
+          SkipComment();
+
+        } else {
+          break;
+        }
+      }
+    };
+
+    // Skip spaces, comments and line breaks
+    inline void SkipWhitespace(void) {
+      for (;;) {
+        SkipSpaces();
+
+        if (pchCur >= pchEnd) {
+          return;
+        }
+
+        if (*pchCur == '\n') {
+          pchLine = ++pchCur;
+          ++iLine;
+
+        } else if (*pchCur == '\r') {
+          ++pchCur;
+
+        } else {
+          return;
+        }
+      }
+    };
+
+    // Check if there's nothing else on the current line
+    inline bool AtLineEnd(void) {
+      SkipSpaces();
+      return pchCur >= pchEnd || *pchCur == '\n' || *pchCur == '\r';
+    };
+
+    // Check if the character separates words
+    static inline bool IsSeparator(c8 ch) {
+      return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+    };
+
+    // Get length of the word under the cursor
+    inline size_t WordLength(void) const {
+      const c8 *pch = pchCur;
+
+      while (pch < pchEnd && !IsSeparator(*pch) && !IsComment(pch)) {
+        ++pch;
+      }
+
+      return pch - pchCur;
+    };
+
+    // Check if the next word matches without skipping it
+    inline bool IsWord(const c8 *strWord) {
+      SkipWhitespace();
+
+      const size_t iLength = strlen(strWord);
+      return WordLength() == iLength && memcmp(pchCur, strWord, iLength) == 0;
+    };
+
+    // Skip the next word if it matches
+    inline bool SkipWord(const c8 *strWord) {
+      if (!IsWord(strWord)) {
+        return false;
+      }
+
+      pchCur += strlen(strWord);
+      return true;
+    };
+
+    // Expect a certain word and skip it
+    inline void ExpectWord(const c8 *strWord) {
+      if (!SkipWord(strWord)) {
+        Throw("Expected '%s' keyword", strWord);
+      }
+    };
+
+    // Read the next word
+    inline Str_t ReadWord(void) {
+      SkipWhitespace();
+
+      const size_t iLength = WordLength();
+
+      if (iLength == 0) {
+        Throw("Unexpected end of file");
+      }
+
+      Str_t str(pchCur, iLength);
+      pchCur += iLength;
+      return str;
+    };
+
+    // Read string in double quotes or a single word
+    inline Str_t ReadString(void) {
+      SkipWhitespace();
+
+      if (pchCur >= pchEnd || *pchCur != '"') {
+        return ReadWord();
+      }
+
+      const c8 *pchStart = ++pchCur;
+
+      while (pchCur < pchEnd && *pchCur != '"' && *pchCur != '\n') {
+        ++pchCur;
+      }
+
+      if (pchCur >= pchEnd || *pchCur != '"') {
+        Throw("Unclosed string");
+      }
+
+      return Str_t(pchStart, pchCur++);
+    };
+
+    // Read the rest of the line without surrounding spaces
+    inline Str_t ReadLine(void) {
+      SkipSpaces();
+
+      const c8 *pchStart = pchCur;
+      const c8 *pchLast = pchCur;
+
+      while (pchCur < pchEnd && *pchCur != '\n' && *pchCur != '\r') {
+        if (!IsSeparator(*pchCur)) {
+          pchLast = pchCur + 1;
+        }
+
+        ++pchCur;
+      }
+
+      return Str_t(pchStart, pchLast);
+    };
+
+    // Read an integer number
+    inline s64 ReadInt(void) {
+      SkipWhitespace();
+
+      s64 iValue;
+      const c8 *pchNumEnd = ParseInteger(pchCur, pchEnd, iValue);
+
+      if (pchNumEnd == nullptr) {
+        Throw("Expected an integer number");
+      }
+
+      pchCur = pchNumEnd;
+      return iValue;
+    };
+
+    // Read a floating-point number
+    inline f64 ReadFloat(void) {
+      SkipWhitespace();
+
+      f64 fValue;
+      const c8 *pchNumEnd = ParseDouble(pchCur, pchEnd, fValue);
+
+      if (pchNumEnd == nullptr) {
+        Throw("Expected a number");
+      }
+
+      pchCur = pchNumEnd;
+      return fValue;
+    };
+
+    // Check if the character can be used in identifiers
+    static inline bool IsIdentifierChar(c8 ch) {
+      return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+    };
+
+    // Check if the next token is a certain identifier without skipping it
+    inline bool IsIdentifier(const c8 *strIdentifier) {
+      SkipWhitespace();
+
+      const size_t iLength = strlen(strIdentifier);
+
+      return pchCur + iLength <= pchEnd && memcmp(pchCur, strIdentifier, iLength) == 0
+        && (pchCur + iLength == pchEnd || !IsIdentifierChar(pchCur[iLength]));
+    };
+
+    // Skip the next token if it's a certain identifier
+    inline bool SkipIdentifier(const c8 *strIdentifier) {
+      if (!IsIdentifier(strIdentifier)) {
+        return false;
+      }
+
+      pchCur += strlen(strIdentifier);
+      return true;
+    };
+
+    // Skip the next token if it's a certain symbol
+    inline bool SkipSymbol(c8 chSymbol) {
+      SkipWhitespace();
+
+      if (pchCur >= pchEnd || *pchCur != chSymbol) {
+        return false;
+      }
+
+      ++pchCur;
+      return true;
+    };
+
+    // Skip one token of C-like syntax (identifier, number, string or a single symbol)
+    void SkipToken(void) {
+      SkipWhitespace();
+
+      if (pchCur >= pchEnd) {
+        Throw("Unexpected end of file");
+      }
+
+      const c8 ch = *pchCur;
+
+      // Number without a sign
+      if ((ch >= '0' && ch <= '9') || (ch == '.' && pchCur + 1 < pchEnd && pchCur[1] >= '0' && pchCur[1] <= '9')) {
+        ReadFloat();
+
+      // Identifier
+      } else if (IsIdentifierChar(ch)) {
+        while (pchCur < pchEnd && IsIdentifierChar(*pchCur)) {
+          ++pchCur;
+        }
+
+      // String
+      } else if (ch == '"') {
+        ReadString();
+
+      // Symbol
+      } else {
+        ++pchCur;
+      }
+    };
+
+    // Skip multiple tokens
+    inline void SkipTokens(s32 ctTokens) {
+      while (--ctTokens >= 0) {
+        SkipToken();
+      }
+    };
+};
+
+#endif
@@ -0,0 +1,200 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Common/Trace.h"
+
+#include "Common/OutputFile.h"
+#include "Common/Platform.h"
+
+bool _bTrace = false;
+
+// One finished span
+struct TraceSpan {
+  const c8 *strName;
+  Str_t strDetail;
+  u64 iThread;
+  f64 fStart;
+  f64 fEnd;
+};
+
+static std::vector<TraceSpan> _aTraceSpans;
+static CMutex _mxTrace;
+
+static Str_t _strTraceFile;
+static f64 _fTraceStart = 0.0;
+static u64 _iMainThread = 0;
+
+void StartTrace(const Str_t &strFile) {
+  _strTraceFile = strFile;
+  _fTraceStart = GetTimeSeconds();
+  _iMainThread = GetCurrentThreadID();
+  _bTrace = true;
+};
+
+void AddTraceSpan(const c8 *strName, const Str_t &strDetail, f64 fStart, f64 fEnd) {
+  TraceSpan span;
+  span.strName = strName;
+  span.strDetail = strDetail;
+  span.iThread = GetCurrentThreadID();
+  span.fStart = fStart;
+  span.fEnd = fEnd;
+
+  CMutexLock lock(_mxTrace);
+  _aTraceSpans.push_back(span);
+};
+
+void CTraceScope::Begin(const c8 *strName, const Str_t &strDetail) {
+  _strName = strName;
+
+  if (_bTrace) {
+    _strDetail = strDetail;
+    _fStart = GetTimeSeconds();
+  }
+
+  if (_bMemoryStats) {
+    GetMemoryCounters(_memStart);
+  }
+};
+
+void CTraceScope::End(void) {
+  if (_bTrace) {
+    AddTraceSpan(_strName, _strDetail, _fStart, GetTimeSeconds());
+  }
+
+  if (_bMemoryStats) {
+    AddMemoryStage(_strName, _memStart);
+  }
+};
+
+// Write string as a JSON value
+static void WriteTraceString(COutputFile &file, const Str_t &str) {
+  file << '"';
+
+  for (size_t iChar = 0; iChar < str.size(); ++iChar) {
+    const c8 ch = str[iChar];
+
+    if (ch == '"' || ch == '\\') {
+      file << '\\' << ch;
+
+    } else if ((u8)ch < 0x20) {
+      c8 strEscape[8];
+      sprintf(strEscape, "\\u%04x", (u32)(u8)ch);
+      file << strEscape;
+
+    } else {
+      file << ch;
+    }
+  }
+
+  file << '"';
+};
+
+// Write time in microseconds since the start of the trace
+static void WriteTraceTime(COutputFile &file, f64 fSeconds) {
+  c8 strTime[32];
+  sprintf(strTime, "%.3f", fSeconds * 1000000.0);
+  file << strTime;
+};
+
+// Write recorded spans into the file
+static void WriteTraceFile(std::map<u64, s32> &mapThreads) {
+  COutputFile file;
+  file.Open(_strTraceFile);
+
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Serious SKA Converter\"}}";
+
+  // Name thread tracks
+  std::map<u64, s32>::const_iterator itThread;
+
+  for (itThread = mapThreads.begin(); itThread != mapThreads.end(); ++itThread) {
+    const s32 iTrack = itThread->second;
+
+    c8 strName[32];
+
+    if (iTrack == 1) {
+      strcpy(strName, "Main thread");
+    } else {
+      sprintf(strName, "Worker thread %d", iTrack - 1);
+    }
+
+    file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << iTrack << ",\"args\":{\"name\":\"" << strName << "\"}}";
+    file << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << iTrack << ",\"args\":{\"sort_index\":" << iTrack << "}}";
+  }
+
+  // Complete events with their durations
+  for (size_t iSpan = 0; iSpan < _aTraceSpans.size(); ++iSpan) {
+    const TraceSpan &span = _aTraceSpans[iSpan];
+
+    file << ",\n{\"name\":";
+    WriteTraceString(file, span.strName);
+    file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << mapThreads[span.iThread] << ",\"ts\":";
+    WriteTraceTime(file, span.fStart - _fTraceStart);
+    file << ",\"dur\":";
+    WriteTraceTime(file, span.fEnd - span.fStart);
+
+    if (!span.strDetail.empty()) {
+      file << ",\"args\":{\"detail\":";
+      WriteTraceString(file, span.strDetail);
+      file << "}";
+    }
+
+    file << "}";
+  }
+
+  file << "\n]}\n";
+  file.Close();
+
+  std::cout << "Written " << _aTraceSpans.size() << " trace spans into " << _strTraceFile << '\n';
+};
+
+void FinishTrace(void) {
+  if (!_bTrace) {
+    return;
+  }
+
+  _bTrace = false;
+
+  CMutexLock lock(_mxTrace);
+
+  // Number threads in the order they appear with the main thread being the first one
+  std::map<u64, s32> mapThreads;
+  mapThreads[_iMainThread] = 1;
+
+  for (size_t iSpan = 0; iSpan < _aTraceSpans.size(); ++iSpan) {
+    const u64 iThread = _aTraceSpans[iSpan].iThread;
+
+    if (mapThreads.find(iThread) == mapThreads.end()) {
+      const s32 iNext = (s32)mapThreads.size() + 1;
+      mapThreads[iThread] = iNext;
+    }
+  }
+
+  try {
+    WriteTraceFile(mapThreads);
+
+  } catch (CException &ex) {
+    std::cout << "Error: " << ex.What() << '\n';
+  }
+
+  _aTraceSpans.clear();
+};
@@ -0,0 +1,78 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_TRACE_H
+#define _COMMON_TRACE_H
+
+#include "Common/MemoryStats.h"
+
+// Recording of timed spans (only when tracing has been started)
+extern bool _bTrace;
+
+// Start recording spans for writing them into a file later
+void StartTrace(const Str_t &strFile);
+
+// Write recorded spans into the file in Chrome trace event format and stop recording
+void FinishTrace(void);
+
+// Add a finished span on the current thread
+void AddTraceSpan(const c8 *strName, const Str_t &strDetail, f64 fStart, f64 fEnd);
+
+// Span that lasts for the lifetime of the object
+// Also counts allocations in it as a stage while memory accounting is active
+class CTraceScope {
+  private:
+    const c8 *_strName;
+    Str_t _strDetail;
+    f64 _fStart;
+    MemoryCounters _memStart;
+
+  private:
+    // Not copyable
+    CTraceScope(const CTraceScope &);
+    CTraceScope &operator=(const CTraceScope &);
+
+  public:
+    // Name should be a string literal (it's kept until the trace is written)
+    inline CTraceScope(const c8 *strName) : _strName(nullptr) {
+      if (_bTrace || _bMemoryStats) Begin(strName, "");
+    };
+
+    // Detail is displayed among the span arguments (e.g. file name)
+    inline CTraceScope(const c8 *strName, const Str_t &strDetail) : _strName(nullptr) {
+      if (_bTrace || _bMemoryStats) Begin(strName, strDetail);
+    };
+
+    inline ~CTraceScope(void) {
+      if (_strName != nullptr) End();
+    };
+
+    void Begin(const c8 *strName, const Str_t &strDetail);
+    void End(void);
+};
+
+// Measure the rest of the current scope
+#define TRACE_SCOPE_NAME(_Line) _traceScope##_Line
+#define TRACE_SCOPE_LINE(_Line, _Args) CTraceScope TRACE_SCOPE_NAME(_Line) _Args
+#define TRACE_SCOPE(_Name) TRACE_SCOPE_LINE(__LINE__, (_Name))
+#define TRACE_SCOPE_DETAIL(_Name, _Detail) TRACE_SCOPE_LINE(__LINE__, (_Name, _Detail))
+
+#endif
@@ -0,0 +1,85 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COMMON_WIDEMATH_H
+#define _COMMON_WIDEMATH_H
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  #include <intrin.h>
+  #define WIDEMATH_MSVC_INTRINSICS 1
+#endif
+
+// Full 128-bit product of two 64-bit numbers
+inline void Multiply128(u64 iA, u64 iB, u64 &iHigh, u64 &iLow) {
+#if defined(__SIZEOF_INT128__)
+  __extension__ typedef unsigned __int128 u128;
+  const u128 iProduct = (u128)iA * iB;
+  iHigh = (u64)(iProduct >> 64);
+  iLow = (u64)iProduct;
+
+#elif WIDEMATH_MSVC_INTRINSICS && defined(_M_X64)
+  iLow = _umul128(iA, iB, &iHigh);
+
+#else
+  // Multiply 32-bit halves
+  const u64 iALo = (u32)iA, iAHi = iA >> 32;
+  const u64 iBLo = (u32)iB, iBHi = iB >> 32;
+
+  const u64 iLoLo = iALo * iBLo;
+  const u64 iHiLo = iAHi * iBLo;
+  const u64 iLoHi = iALo * iBHi;
+  const u64 iHiHi = iAHi * iBHi;
+
+  const u64 iCross = (iLoLo >> 32) + (u32)iHiLo + iLoHi;
+
+  iHigh = (iHiLo >> 32) + (iCross >> 32) + iHiHi;
+  iLow = (iCross << 32) | (u32)iLoLo;
+#endif
+};
+
+// Count zero bits above the highest set bit of a non-zero number
+inline s32 CountLeadingZeros(u64 iValue) {
+#if defined(__GNUC__)
+  return __builtin_clzll(iValue);
+
+#elif WIDEMATH_MSVC_INTRINSICS
+  unsigned long iIndex;
+  _BitScanReverse64(&iIndex, iValue);
+  return 63 - (s32)iIndex;
+
+#else
+  s32 iCount = 0;
+
+  while (!(iValue & ((u64)1 << 63))) {
+    iValue <<= 1;
+    ++iCount;
+  }
+
+  return iCount;
+#endif
+};
+
+// Shift 128-bit number to the right by 1-63 bits and take the lower half
+inline u64 ShiftRight128(u64 iHigh, u64 iLow, s32 iShift) {
+  return (iHigh << (64 - iShift)) | (iLow >> iShift);
+};
+
+#endif
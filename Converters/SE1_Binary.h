@@ -0,0 +1,84 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _SE1_BINARY_H
+#define _SE1_BINARY_H
+
+// Chunk IDs and versions of binary SKA files that SE1 compiles ASCII files into
+#define SE1_MESH_ID "MESH"
+#define SE1_MESH_VERSION 16
+
+#define SE1_SKELETON_ID "SKEL"
+#define SE1_SKELETON_VERSION 6
+
+#define SE1_ANIMSET_ID "ANIM"
+#define SE1_ANIMSET_VERSION 14
+
+// Frame numbers of binary animations are 16-bit
+#define SE1_MAX_ANIM_FRAMES 0xFFFF
+
+// LOD distance that's never reached
+#define SE1_LOD_MAX_DISTANCE -1.0
+
+// Rotation of the placement as a quaternion
+inline void PlacementToQuat(const Mat12D &m, QuatD &q) {
+  Mat3D m3D;
+
+  for (s32 i = 0; i < 9; ++i) {
+    m3D(i / 3, i % 3) = m(i / 3, i % 3);
+  }
+
+  q.FromMatrix(m3D);
+};
+
+// Placement from a rotation quaternion and a position
+inline void QuatToPlacement(const QuatD &q, const Vec3D &vPos, Mat12D &m) {
+  Mat3D m3D;
+  q.ToMatrix(m3D);
+
+  for (s32 iRow = 0; iRow < 3; ++iRow) {
+    m(iRow, 0) = m3D(iRow, 0);
+    m(iRow, 1) = m3D(iRow, 1);
+    m(iRow, 2) = m3D(iRow, 2);
+    m(iRow, 3) = vPos[iRow];
+  }
+};
+
+// Apply placement on top of the parent placement
+inline void CombinePlacements(const Mat12D &mParent, const Mat12D &m, Mat12D &mResult) {
+  for (s32 iRow = 0; iRow < 3; ++iRow) {
+    for (s32 iCol = 0; iCol < 4; ++iCol) {
+      mResult(iRow, iCol) = mParent(iRow, 0) * m(0, iCol) + mParent(iRow, 1) * m(1, iCol) + mParent(iRow, 2) * m(2, iCol);
+    }
+
+    mResult(iRow, 3) += mParent(iRow, 3);
+  }
+};
+
+// Write quaternion in the same order as SE1 stores it (W, X, Y, Z)
+inline void WriteQuat(COutputFile &file, const QuatD &q) {
+  file.WriteFloat(q._w);
+  file.WriteFloat(q._x);
+  file.WriteFloat(q._y);
+  file.WriteFloat(q._z);
+};
+
+#endif
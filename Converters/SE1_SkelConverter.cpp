@@ -20,75 +20,53 @@
  */
 
 #include "Main.h"
+#include "SE_Skeleton.h"
 
-// Convert SE1 ASCII skeleton file (.as) into SE2+ ASCII skeleton (.asf)
-extern void ConvertSkeletonSE1(CTokenList &aTokens, const CPath &strFile, Str_t strSkeleton) {
-  // Go through the skeleton file
-  CTokenList::reverse_iterator it;
-
-  for (it = aTokens.rbegin(); it != aTokens.rend(); ++it)
-  {
-    // Skip non-keyword tokens
-    if (it->GetType() != CParserToken::TKN_IDENTIFIER) {
-      continue;
-    }
+#include "Common/OutputFile.h"
+#include "Common/Trace.h"
 
-    const Str_t str = it->GetValue().ToString();
+// Convert SE1 ASCII skeleton file (.as) into SE2+ ASCII skeleton (.asf)
+extern void ConvertSkeletonSE1(const c8 *pchData, size_t iSize, const CPath &strFile) {
+  TRACE_SCOPE_DETAIL("ConvertSkeletonSE1", strFile);
 
-    // Encountered variables
-    if (str == "NAME" || str == "PARENT" || str == "LENGTH") {
-      // Erase semicolon after the value
-      CTokenList::reverse_iterator itValue = it - 1;
-      strSkeleton.erase(itValue->GetTokenPos().iLast, 1);
+  CSkeletonBones aBones;
+  ReadSkeletonBones(pchData, iSize, aBones);
 
-      // If it's the last variable
-      if (str == "LENGTH")
-      {
-        // Add "DEFAULT_POSE" keyword before the next block
-        CTokenList::reverse_iterator itDefPose = it - 3; // Opening curly bracket
-        
-        strSkeleton.insert(itDefPose->GetTokenPos().iFirst - 1, "DEFAULT_POSE ");
+  // Generic limits for every bone
+  static const c8 *strLimits =
+    "  LIMITS {\n"
+    "   { 0: -3.14159, 3.14159; }\n"
+    "   { 0: -3.14159, 3.14159; }\n"
+    "   { 0: -3.14159, 3.14159; }\n"
+    "  }\n";
 
-        // Add generic "LIMITS" block after the length
-        static const c8 *strLimits = "\n"
-          "  LIMITS {\n"
-          "   { 0: -3.14159, 3.14159; }\n"
-          "   { 0: -3.14159, 3.14159; }\n"
-          "   { 0: -3.14159, 3.14159; }\n"
-          "  }";
+  COutputFile file;
+  file.Open(strFile.RemoveExt() + ".asf");
+  file.Reserve(iSize + aBones.size() * (strlen(strLimits) + 16) + 64);
 
-        strSkeleton.insert(itValue->GetTokenPos().iLast, strLimits);
-      }
+  file << "SE_SKELETON 1.01\n\n";
+  file << "BONES " << (u32)aBones.size() << "\n{\n";
 
-    // Encountered version
-    } else if (str == "SE_SKELETON") {
-      // Get version number
-      CTokenList::reverse_iterator itValue = it - 1;
+  // Write each bone with limits
+  for (size_t iBone = 0; iBone < aBones.size(); ++iBone) {
+    const CSkeletonBone &bone = aBones[iBone];
 
-      // Erase version with the semicolon
-      strSkeleton.erase(itValue->GetTokenPos().iFirst, itValue->GetTokenPos().Length() + 1);
+    file << "  NAME \"" << bone.strName << "\"\n";
+    file << "  PARENT \"" << bone.strParent << "\"\n";
+    file << "  LENGTH " << bone.strLength << "\n";
+    file << strLimits;
 
-      // Write new version
-      strSkeleton.insert(itValue->GetTokenPos().iFirst, "1.01");
+    file << "  DEFAULT_POSE {\n    ";
 
-    // Encountered ending keyword
-    } else if (str == "SE_SKELETON_END") {
-      // Erase keyword with the semicolon (+1) and surrounding linebreaks (+2)
-      strSkeleton.erase(it->GetTokenPos().iFirst - 1, it->GetTokenPos().Length() + 3);
+    for (s32 i = 0; i < SE_POSE_VALUES; ++i) {
+      file << bone.astrPose[i] << (i == SE_POSE_VALUES - 1 ? ";" : ", ");
     }
-  }
 
-#if !_DEV_STL_IO
-  CFileDevice fileD((strFile.RemoveExt() + ".asf").c_str());
-  CStringStream file(&fileD, IReadWriteDevice::OM_WRITEONLY);
+    file << "\n  }\n";
+  }
 
-  file << strSkeleton;
-  fileD.Close();
-#else
-  FileOut_t file((strFile.RemoveExt() + ".asf").c_str());
-  file << strSkeleton;
-  file.close();
-#endif
+  file << "}\n";
+  file.Close();
   
-  std::cout << "Successfully converted SE1 ASCII skeleton into SE2+ ASCII skeleton!\n";
+  Console() << "Successfully converted SE1 ASCII skeleton into SE2+ ASCII skeleton!\n";
 };
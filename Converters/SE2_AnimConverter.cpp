@@ -20,228 +20,439 @@
  */
 
 #include "Main.h"
+#include "Common/NumberFormat.h"
+#include "Common/OutputFile.h"
+#include "Common/SimdMath.h"
+#include "Common/TaskScheduler.h"
+#include "Common/TextScanner.h"
+#include "Common/Trace.h"
 
-// Place in 3D space
-struct Placement {
-  Vec3D pos;
-  Vec3D rot;
-};
+// Values of one placement as they appear in the file (XYZHPB)
+#define ENVELOPE_PLACEMENT_VALUES 6
+
+// Values of one converted placement (3x4 matrix)
+#define ENVELOPE_MATRIX_VALUES 12
+
+// Placements converted at once
+#define ENVELOPE_BATCH 64
+
+// Envelopes that are read before converting them on multiple threads (per thread)
+#define ENVELOPE_GROUP_PER_THREAD 4
 
 // Bone envelope structure
 class CEnvelope {
   public:
     Str_t strName;
-    Placement plDefault;
 
-    std::vector<Placement> avFrames;
+    // Default placement followed by placements in each frame (XYZHPB)
+    std::vector<f64> afPlacements;
 
+    // Converted envelope text
+    Str_t strText;
+
+  public:
     CEnvelope(void) : strName("") {};
+
+    inline s32 CountFrames(void) const {
+      return (s32)(afPlacements.size() / ENVELOPE_PLACEMENT_VALUES) - 1;
+    };
 };
 
-// Create bone envelopes from the animation file
-void CreateBones(CTokenList &aTokens, std::vector<CEnvelope> &aBones) {
-  CTokenList::const_iterator it;
+// Read a number that may have a unary minus in front of it
+static f64 ReadSignedNumber(CTextScanner &scan) {
+  const bool bNegative = scan.SkipSymbol('-');
+  return scan.ReadFloat() * (bNegative ? -1 : 1);
+};
 
-  for (it = aTokens.begin(); it != aTokens.end(); ++it)
-  {
-    // Skip non-keyword tokens
-    if (it->GetType() != CParserToken::TKN_IDENTIFIER) {
-      continue;
+// Read bone envelope after its keyword (reuses memory of the previous envelope)
+static void ReadEnvelope(CTextScanner &scan, CEnvelope &env) {
+  // Get bone name
+  env.strName = scan.ReadString();
+  env.afPlacements.assign(ENVELOPE_PLACEMENT_VALUES, 0.0);
+
+  scan.SkipTokens(2); // Offset
+
+  // Go through individual positions
+  for (s32 iPos = 0; iPos < ENVELOPE_PLACEMENT_VALUES; ++iPos) {
+    scan.SkipTokens(5);
+
+    // Encountered default position
+    if (scan.SkipIdentifier("DEFAULT")) {
+      scan.SkipToken(); // Value of "DEFAULT:"
+
+      // Get the value
+      env.afPlacements[iPos] = ReadSignedNumber(scan);
+
+      // Skip semicolon
+      scan.SkipToken();
     }
 
-    // Not a bone envelope
-    if (it->GetValue().ToString() != "ENVELOPE") {
-      continue;
+    // Amount of frames
+    scan.SkipToken();
+    const s64 iFrames = scan.ReadInt(); // Value of "FRAMES"
+
+    // Fill bone frames
+    if (iPos == 0) {
+      if (iFrames < 0) {
+        scan.Throw("Invalid amount of frames");
+      }
+
+      env.afPlacements.resize((size_t)(iFrames + 1) * ENVELOPE_PLACEMENT_VALUES, 0.0);
+
+    } else if (iFrames < 0 || iFrames > env.CountFrames()) {
+      scan.Throw("Expected %u frames for the envelope '%s'", (u32)env.CountFrames(), env.strName.c_str());
     }
 
-    CEnvelope env;
+    for (s64 iFrame = 0; iFrame < iFrames; ++iFrame) {
+      scan.SkipTokens(3); // Goes to the value of "<frame>:"
 
-    // Get bone name
-    env.strName = (++it)->GetValue().ToString();
+      // Fill appropriate position with this frame's position
+      env.afPlacements[(size_t)(iFrame + 1) * ENVELOPE_PLACEMENT_VALUES + iPos] = ReadSignedNumber(scan);
+    }
+  }
+};
 
-    it += 2; // Offset
+// Convert XYZHPB placements into 3x4 matrices one by one using the library
+extern void ConvertPlacementsSE2Scalar(const f64 *afPlacements, s32 ctPlacements, f64 *afMatrices) {
+  for (s32 iPlacement = 0; iPlacement < ctPlacements; ++iPlacement) {
+    const f64 *pf = afPlacements + iPlacement * ENVELOPE_PLACEMENT_VALUES;
 
-    // Go through individual positions
-    for (s32 iPos = 0; iPos < 6; ++iPos) {
-      it += 6;
+    QuatVecD qv;
+    Mat12D m12;
 
-      f64 fValue;
-      bool bNegative = false;
+    qv._pos = Vec3D(pf[0], pf[1], pf[2]);
+    qv._rot.FromEuler(Vec3D(pf[3], pf[4], pf[5]));
+    qv.ToMatrix12(m12);
 
-      // Encountered default position
-      if (it->GetValue().ToString() == "DEFAULT") {
-        it += 2; // Value of "DEFAULT:"
+    f64 *pm = afMatrices + iPlacement * ENVELOPE_MATRIX_VALUES;
 
-        // Skip unary operators
-        if (it->GetType() == CParserToken::TKN_SUB) {
-          bNegative = true;
-          ++it;
-        }
+    for (s32 i = 0; i < ENVELOPE_MATRIX_VALUES; ++i) {
+      pm[i] = m12(i / 4, i % 4);
+    }
+  }
+};
+
+// Convert XYZHPB placements into 3x4 matrices in vectorized batches
+extern void ConvertPlacementsSE2Batch(const f64 *afPlacements, s32 ctPlacements, f64 *afMatrices) {
+  typedef SimdLanes L;
+
+  // Half angles of each rotation axis
+  f64 aafHalf[3][ENVELOPE_BATCH];
+  f64 aafMatrix[9][ENVELOPE_BATCH];
+
+  for (s32 iFirst = 0; iFirst < ctPlacements; iFirst += ENVELOPE_BATCH) {
+    const s32 ctBatch = (ctPlacements - iFirst > ENVELOPE_BATCH ? ENVELOPE_BATCH : ctPlacements - iFirst);
 
-        // Get the value
-        fValue = GetNumber<f64>(it->GetValue()) * (bNegative ? -1 : 1);
+    // Gather angles
+    for (s32 iLane = 0; iLane < ENVELOPE_BATCH; ++iLane) {
+      for (s32 i = 0; i < 3; ++i) {
+        f64 fHalf = 0.0;
 
-        if (iPos < 3) {
-          env.plDefault.pos[iPos] = fValue;
-        } else {
-          env.plDefault.rot[iPos - 3] = fValue;
+        if (iLane < ctBatch) {
+          fHalf = afPlacements[(iFirst + iLane) * ENVELOPE_PLACEMENT_VALUES + 3 + i] * 0.5;
+
+          // Bring huge angles into the range of the vectorized functions
+          if (fHalf > SIMD_SINCOS_MAX || fHalf < -SIMD_SINCOS_MAX) {
+            fHalf = fmod(fHalf, 2.0 * 3.14159265358979323846);
+          }
         }
 
-        // Skip semicolon
-        it += 2;
+        aafHalf[i][iLane] = fHalf;
       }
+    }
+
+    for (s32 iLane = 0; iLane < ENVELOPE_BATCH; iLane += L::COUNT) {
+      L::Vec vSinH, vCosH, vSinP, vCosP, vSinB, vCosB;
+      SimdSinCos(L::Load(aafHalf[0] + iLane), vSinH, vCosH);
+      SimdSinCos(L::Load(aafHalf[1] + iLane), vSinP, vCosP);
+      SimdSinCos(L::Load(aafHalf[2] + iLane), vSinB, vCosB);
+
+      // Quaternion of heading around Y, pitch around X and banking around Z (same as QuatD::FromEuler)
+      const L::Vec vCosHCosP = L::Mul(vCosH, vCosP);
+      const L::Vec vSinHSinP = L::Mul(vSinH, vSinP);
+      const L::Vec vCosHSinP = L::Mul(vCosH, vSinP);
+      const L::Vec vSinHCosP = L::Mul(vSinH, vCosP);
+
+      const L::Vec w = L::Add(L::Mul(vCosHCosP, vCosB), L::Mul(vSinHSinP, vSinB));
+      const L::Vec x = L::Add(L::Mul(vCosHSinP, vCosB), L::Mul(vSinHCosP, vSinB));
+      const L::Vec y = L::Sub(L::Mul(vSinHCosP, vCosB), L::Mul(vCosHSinP, vSinB));
+      const L::Vec z = L::Sub(L::Mul(vCosHCosP, vSinB), L::Mul(vSinHSinP, vCosB));
+
+      // Rotation matrix of the quaternion (same as QuatVecD::ToMatrix12)
+      const L::Vec x2 = L::Add(x, x), y2 = L::Add(y, y), z2 = L::Add(z, z);
+      const L::Vec xx = L::Mul(x, x2), xy = L::Mul(x, y2), xz = L::Mul(x, z2);
+      const L::Vec yy = L::Mul(y, y2), yz = L::Mul(y, z2), zz = L::Mul(z, z2);
+      const L::Vec wx = L::Mul(w, x2), wy = L::Mul(w, y2), wz = L::Mul(w, z2);
+      const L::Vec vOne = L::Set(1.0);
+
+      L::Store(aafMatrix[0] + iLane, L::Sub(vOne, L::Add(yy, zz)));
+      L::Store(aafMatrix[1] + iLane, L::Sub(xy, wz));
+      L::Store(aafMatrix[2] + iLane, L::Add(xz, wy));
+      L::Store(aafMatrix[3] + iLane, L::Add(xy, wz));
+      L::Store(aafMatrix[4] + iLane, L::Sub(vOne, L::Add(xx, zz)));
+      L::Store(aafMatrix[5] + iLane, L::Sub(yz, wx));
+      L::Store(aafMatrix[6] + iLane, L::Sub(xz, wy));
+      L::Store(aafMatrix[7] + iLane, L::Add(yz, wx));
+      L::Store(aafMatrix[8] + iLane, L::Sub(vOne, L::Add(xx, yy)));
+    }
 
-      // Amount of frames
-      ++it;
-      s32 iFrames = GetNumber<s32>(it->GetValue()); // Value of "FRAMES"
+    // Scatter matrices with positions
+    for (s32 iLane = 0; iLane < ctBatch; ++iLane) {
+      const f64 *pf = afPlacements + (iFirst + iLane) * ENVELOPE_PLACEMENT_VALUES;
+      f64 *pm = afMatrices + (iFirst + iLane) * ENVELOPE_MATRIX_VALUES;
 
-      // Fill bone frames
-      if (iPos == 0) {
-        env.avFrames.resize(iFrames);
+      for (s32 iRow = 0; iRow < 3; ++iRow) {
+        pm[iRow * 4 + 0] = aafMatrix[iRow * 3 + 0][iLane];
+        pm[iRow * 4 + 1] = aafMatrix[iRow * 3 + 1][iLane];
+        pm[iRow * 4 + 2] = aafMatrix[iRow * 3 + 2][iLane];
+        pm[iRow * 4 + 3] = pf[iRow];
       }
+    }
+  }
+};
 
-      for (s32 iFrame = 0; iFrame < iFrames; ++iFrame) {
-        it += 4; // Goes to the value of "<frame>:"
-        bNegative = false;
+// Append a number with the precision of output files
+static inline void AppendNumber(Str_t &strText, f64 fValue) {
+  c8 strNumber[FLOAT_TEXT_LENGTH];
+  strText.append(strNumber, FormatDouble(strNumber, fValue, _iFloatDigits));
+};
 
-        // Skip unary operators
-        if (it->GetType() == CParserToken::TKN_SUB) {
-          bNegative = true;
-          ++it;
-        }
-            
-        // Fill appropriate position with this frame's position
-        fValue = GetNumber<f64>(it->GetValue()) * (bNegative ? -1 : 1);
-        Placement &pl = env.avFrames[iFrame];
-
-        if (iPos < 3) {
-          pl.pos[iPos] = fValue;
-        } else {
-          pl.rot[iPos - 3] = fValue;
-        }
-      }
+// Append converted placement
+static void AppendPlacement(Str_t &strText, const f64 *pm, const c8 *strEnd) {
+  for (s32 i = 0; i < ENVELOPE_MATRIX_VALUES; ++i) {
+    AppendNumber(strText, pm[i]);
+    strText += (i == ENVELOPE_MATRIX_VALUES - 1 ? strEnd : ", ");
+  }
+};
+
+// Convert bone envelope into text
+static void ConvertEnvelope(CEnvelope &env, bool bBatch, std::vector<f64> &afMatrices) {
+  const s32 ctPlacements = env.CountFrames() + 1;
+  afMatrices.resize((size_t)ctPlacements * ENVELOPE_MATRIX_VALUES);
+
+  if (bBatch) {
+    ConvertPlacementsSE2Batch(&env.afPlacements[0], ctPlacements, &afMatrices[0]);
+  } else {
+    ConvertPlacementsSE2Scalar(&env.afPlacements[0], ctPlacements, &afMatrices[0]);
+  }
+
+  Str_t &strText = env.strText;
+  strText.clear();
+  strText.reserve((size_t)ctPlacements * (ENVELOPE_MATRIX_VALUES * (MaxFloatTextLength(_iFloatDigits) + 2) + 8) + env.strName.size() + 64);
+
+  // Write envelope name
+  strText += "  NAME \"";
+  strText += env.strName;
+  strText += "\"\n";
+
+  // Write default position
+  strText += "  DEFAULT_POSE { ";
+  AppendPlacement(strText, &afMatrices[0], "; ");
+  strText += "}\n";
+
+  // Write frame positions
+  strText += "  {\n";
+
+  for (s32 iPlacement = 1; iPlacement < ctPlacements; ++iPlacement) {
+    strText += "    ";
+    AppendPlacement(strText, &afMatrices[iPlacement * ENVELOPE_MATRIX_VALUES], ";\n");
+  }
+
+  strText += "  }\n";
+};
+
+// Envelopes converted on multiple threads
+struct EnvelopeTasks {
+  std::vector<CEnvelope> *paEnvelopes;
+  bool bBatch;
+};
+
+// Convert one envelope from the group
+static void ConvertEnvelopeTask(s32 iTask, void *pData) {
+  TRACE_SCOPE("ConvertEnvelopeTask");
+
+  EnvelopeTasks &tasks = *(EnvelopeTasks *)pData;
+  std::vector<f64> afMatrices;
+
+  ConvertEnvelope((*tasks.paEnvelopes)[iTask], tasks.bBatch, afMatrices);
+};
+
+// Convert envelopes that have been read and write them in the same order
+static void WriteEnvelopes(COutputFile &file, std::vector<CEnvelope> &aEnvelopes, s32 ctEnvelopes, s32 ctThreads, bool bBatch) {
+  if (ctEnvelopes == 0) {
+    return;
+  }
+
+  if (ctThreads > 1 && ctEnvelopes > 1) {
+    EnvelopeTasks tasks;
+    tasks.paEnvelopes = &aEnvelopes;
+    tasks.bBatch = bBatch;
+
+    CTaskScheduler scheduler;
+
+    for (s32 iTask = 0; iTask < ctEnvelopes; ++iTask) {
+      scheduler.AddTask(aEnvelopes[iTask].afPlacements.size());
+    }
+
+    scheduler.Run(ctThreads < ctEnvelopes ? ctThreads : ctEnvelopes, &ConvertEnvelopeTask, &tasks);
+
+  } else {
+    std::vector<f64> afMatrices;
+
+    for (s32 iEnvelope = 0; iEnvelope < ctEnvelopes; ++iEnvelope) {
+      ConvertEnvelope(aEnvelopes[iEnvelope], bBatch, afMatrices);
     }
+  }
 
-    aBones.push_back(env);
+  for (s32 iEnvelope = 0; iEnvelope < ctEnvelopes; ++iEnvelope) {
+    file << aEnvelopes[iEnvelope].strText;
   }
 };
 
-// Convert SE2+ ASCII animation file (.aaf) into SE1 ASCII animation (.aa)
-extern void ConvertAnimationSE2(CTokenList &aTokens, const CPath &strFile) {
-  // Get animation info
-  Str_t strAnimName = "";
+// Count envelopes before converting them, since their amount is written before them
+static u32 CountEnvelopes(const c8 *pchData, size_t iSize) {
+  CTextScanner scan(pchData, iSize);
+  u32 ctEnvelopes = 0;
 
-  f64 fSpeed = 0.0;
-  s32 iFrames = 0;
-
-  std::vector<CEnvelope> aBones;
-  CTokenList::const_iterator it;
-  
-  try {
-    s32 iFirstFrame = 0;
-    s32 iLastFrame = 0;
-
-    for (it = aTokens.begin(); it != aTokens.end(); ++it)
-    {
-      // Skip non-keyword tokens
-      if (it->GetType() != CParserToken::TKN_IDENTIFIER) {
-        continue;
-      }
+  for (;;) {
+    scan.SkipWhitespace();
 
-      const Str_t str = it->GetValue().ToString();
-
-      // Anim name
-      if (str == "ANIMATION_NAME") {
-        strAnimName = (++it)->GetValue().ToString();
-      
-      // Anim speed
-      } else if (str == "SEC_PER_FRAME") {
-        fSpeed = GetNumber<f64>((++it)->GetValue());
-      
-      // First frame
-      } else if (str == "FIRST_FRAME") {
-        iFirstFrame = (s32)(++it)->GetValue().ToS64();
-
-      // Last frame
-      } else if (str == "LAST_FRAME") {
-        iLastFrame = (s32)(++it)->GetValue().ToS64();
-      }
+    if (scan.AtEnd()) {
+      break;
     }
 
-    // Count frames
-    iFrames = iLastFrame - iFirstFrame + 1;
+    const c8 ch = *scan.pchCur;
+
+    // Identifiers and numbers
+    if (CTextScanner::IsIdentifierChar(ch)) {
+      ctEnvelopes += scan.SkipIdentifier("ENVELOPE");
+
+      while (!scan.AtEnd() && CTextScanner::IsIdentifierChar(*scan.pchCur)) {
+        ++scan.pchCur;
+      }
 
-    // Create bone envelopes from the animation file
-    CreateBones(aTokens, aBones);
+    // Bone names
+    } else if (ch == '"') {
+      scan.ReadString();
 
-  } catch (CBadAnyCastException &ex) {
-    (void)ex;
-    throw CTokenException(it->GetTokenPos(), "Wrong value type");
+    // Symbols
+    } else {
+      ++scan.pchCur;
+    }
   }
 
-  // Write animation info
-#if !_DEV_STL_IO
-  CFileDevice fileD((strFile.RemoveExt() + ".aa").c_str());
-  CStringStream file(&fileD, IReadWriteDevice::OM_WRITEONLY);
-#else
-  FileOut_t file((strFile.RemoveExt() + ".aa").c_str());
-#endif
+  return ctEnvelopes;
+};
 
+// Write animation info
+static void WriteAnimInfo(COutputFile &file, const Str_t &strAnimName, f64 fSpeed, s32 iFrames, u32 ctEnvelopes) {
   file << "SE_ANIM 0.1;\n\n";
   file << "SEC_PER_FRAME " << fSpeed << ";\n";
   file << "FRAMES " << iFrames << ";\n";
   file << "ANIM_ID \"" << strAnimName << "\";\n\n";
 
   // Envelope count
-  file << "BONEENVELOPES " << aBones.size() << "\n{\n";
+  file << "BONEENVELOPES " << ctEnvelopes << "\n{\n";
+};
 
-  // Go through each bone envelope
-  std::vector<CEnvelope>::const_iterator itBone;
+// Convert SE2+ ASCII animation file (.aaf) into SE1 ASCII animation (.aa)
+// Envelopes are converted in small groups as they are read, so memory doesn't grow with the amount of them
+// Placements are converted by the utilities unless vectorized batches are requested, which may round some numbers differently
+extern void ConvertAnimationSE2(const c8 *pchData, size_t iSize, const CPath &strFile, s32 ctThreads, bool bBatch) {
+  TRACE_SCOPE_DETAIL("ConvertAnimationSE2", strFile);
 
-  for (itBone = aBones.begin(); itBone != aBones.end(); ++itBone)
-  {
-    QuatVecD qv;
-    Mat12D m12;
+  // Get animation info
+  Str_t strAnimName = "";
 
-    // Write envelope name
-    file << "  NAME \"" << itBone->strName << "\"\n";
+  f64 fSpeed = 0.0;
+  s32 iFirstFrame = 0;
+  s32 iLastFrame = 0;
 
-    // Write default position
-    qv._pos = itBone->plDefault.pos;
-    qv._rot.FromEuler(itBone->plDefault.rot);
-    qv.ToMatrix12(m12);
+  // Envelope count is written before the envelopes
+  const u32 ctExpected = CountEnvelopes(pchData, iSize);
+
+  COutputFile file;
+  file.Open(strFile.RemoveExt() + ".aa");
+
+  bool bHeader = false;
+
+  // Envelopes that are converted together
+  if (ctThreads < 1) {
+    ctThreads = GetHardwareThreads();
+  }
+
+  const s32 ctGroup = (ctThreads > 1 ? ctThreads * ENVELOPE_GROUP_PER_THREAD : 1);
+
+  std::vector<CEnvelope> aEnvelopes(ctGroup);
+  s32 ctRead = 0;
+  u32 ctEnvelopes = 0;
+
+  CTextScanner scan(pchData, iSize);
 
-    file << "  DEFAULT_POSE { ";
+  for (;;) {
+    scan.SkipWhitespace();
 
-    for (s32 iDef = 0; iDef < 12; ++iDef) {
-      file << m12(iDef / 4, iDef % 4) << (iDef == 11 ? "; " : ", ");
+    if (scan.AtEnd()) {
+      break;
     }
 
-    file << "}\n";
+    const c8 *pchKeyword = scan.pchCur;
 
-    // Write frame positions
-    file << "  {\n";
+    // Anim name
+    if (scan.SkipIdentifier("ANIMATION_NAME")) {
+      strAnimName = scan.ReadString();
 
-    // Go through each frame
-    std::vector<Placement>::const_iterator itFrame;
-    for (itFrame = itBone->avFrames.begin(); itFrame != itBone->avFrames.end(); ++itFrame)
-    {
-      file << "    ";
+    // Anim speed
+    } else if (scan.SkipIdentifier("SEC_PER_FRAME")) {
+      fSpeed = scan.ReadFloat();
 
-      // Convert placement from XYZHPB to 4x3 matrix
-      const Placement &pl = *itFrame;
+    // First frame
+    } else if (scan.SkipIdentifier("FIRST_FRAME")) {
+      iFirstFrame = (s32)scan.ReadInt();
 
-      qv._pos = pl.pos;
-      qv._rot.FromEuler(pl.rot);
-      qv.ToMatrix12(m12);
+    // Last frame
+    } else if (scan.SkipIdentifier("LAST_FRAME")) {
+      iLastFrame = (s32)scan.ReadInt();
 
-      // Write frame placement
-      for (s32 iPos = 0; iPos < 12; ++iPos) {
-        file << m12(iPos / 4, iPos % 4) << (iPos == 11 ? ";\n" : ", ");
+    // Read bone envelope and convert it with the rest of the group
+    } else if (scan.SkipIdentifier("ENVELOPE")) {
+      if (!bHeader) {
+        WriteAnimInfo(file, strAnimName, fSpeed, iLastFrame - iFirstFrame + 1, ctExpected);
+        bHeader = true;
       }
+
+      ReadEnvelope(scan, aEnvelopes[ctRead++]);
+      ++ctEnvelopes;
+
+      if (ctRead == ctGroup) {
+        WriteEnvelopes(file, aEnvelopes, ctRead, ctThreads, bBatch);
+        ctRead = 0;
+      }
+      continue;
+
+    // Skip other tokens
+    } else {
+      scan.SkipToken();
+      continue;
     }
 
-    file << "  }\n";
+    // Animation info has already been written
+    if (bHeader) {
+      scan.pchCur = pchKeyword;
+      scan.Throw("Animation properties should be specified before the envelopes");
+    }
+  }
+
+  // Rest of the envelopes
+  WriteEnvelopes(file, aEnvelopes, ctRead, ctThreads, bBatch);
+
+  // No envelopes
+  if (!bHeader) {
+    WriteAnimInfo(file, strAnimName, fSpeed, iLastFrame - iFirstFrame + 1, ctExpected);
+  }
+
+  if (ctEnvelopes != ctExpected) {
+    CMessageException::Throw("Expected %u envelopes but converted %u", ctExpected, ctEnvelopes);
   }
 
   file << "}\n\n";
@@ -252,11 +463,7 @@ extern void ConvertAnimationSE2(CTokenList &aTokens, const CPath &strFile) {
   // Close the file
   file << "SE_ANIM_END;\n";
 
-#if !_DEV_STL_IO
-  fileD.Close();
-#else
-  file.close();
-#endif
+  file.Close();
 
-  std::cout << "Successfully converted SE2+ ASCII animation into SE1 ASCII animation!\n";
+  Console() << "Successfully converted SE2+ ASCII animation into SE1 ASCII animation!\n";
 };
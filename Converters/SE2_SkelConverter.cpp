@@ -20,65 +20,46 @@
  */
 
 #include "Main.h"
+#include "SE_Skeleton.h"
 
-// Convert SE2+ ASCII skeleton file (.asf) into SE1 ASCII skeleton (.as)
-extern void ConvertSkeletonSE2(CTokenList &aTokens, const CPath &strFile, Str_t strSkeleton) {
-  // Go through the skeleton file
-  CTokenList::reverse_iterator it;
+#include "Common/OutputFile.h"
+#include "Common/Trace.h"
 
-  for (it = aTokens.rbegin(); it != aTokens.rend(); ++it)
-  {
-    // Skip non-keyword tokens
-    if (it->GetType() != CParserToken::TKN_IDENTIFIER) {
-      continue;
-    }
+// Convert SE2+ ASCII skeleton file (.asf) into SE1 ASCII skeleton (.as)
+extern void ConvertSkeletonSE2(const c8 *pchData, size_t iSize, const CPath &strFile) {
+  TRACE_SCOPE_DETAIL("ConvertSkeletonSE2", strFile);
 
-    const u32 iStart = it->GetTokenPos().iFirst;
-    const Str_t str = it->GetValue().ToString();
+  CSkeletonBones aBones;
+  ReadSkeletonBones(pchData, iSize, aBones);
 
-    // Encountered position keyword
-    if (str == "DEFAULT_POSE") {
-      // Erase it
-      strSkeleton.erase(iStart, 13);
+  COutputFile file;
+  file.Open(strFile.RemoveExt() + ".as");
+  file.Reserve(iSize + aBones.size() * 16 + 64);
 
-    // Encountered limits keyword
-    } else if (str == "LIMITS") {
-      // Erase the whole block
-      CTokenList::reverse_iterator itBlockEnd = it - 29;
-      strSkeleton.erase(iStart, itBlockEnd->GetTokenPos().iLast - iStart + 4);
+  file << "SE_SKELETON 0.1;\n\n";
+  file << "BONES " << (u32)aBones.size() << "\n{\n";
 
-    // Encountered variables
-    } else if (str == "NAME" || str == "PARENT" || str == "LENGTH") {
-      // Add semicolon after the value
-      CTokenList::reverse_iterator itValue = it - 1;
-      strSkeleton.insert(itValue->GetTokenPos().iLast, ";");
+  // Write each bone without limits
+  for (size_t iBone = 0; iBone < aBones.size(); ++iBone) {
+    const CSkeletonBone &bone = aBones[iBone];
 
-    // Encountered version
-    } else if (str == "SE_SKELETON") {
-      // Get version number
-      CTokenList::reverse_iterator itValue = it - 1;
+    file << "  NAME \"" << bone.strName << "\";\n";
+    file << "  PARENT \"" << bone.strParent << "\";\n";
+    file << "  LENGTH " << bone.strLength << ";\n";
 
-      // Erase version
-      strSkeleton.erase(itValue->GetTokenPos().iFirst, itValue->GetTokenPos().Length());
+    file << "  {\n    ";
 
-      // Write new version
-      strSkeleton.insert(itValue->GetTokenPos().iFirst, "0.1;");
+    for (s32 i = 0; i < SE_POSE_VALUES; ++i) {
+      file << bone.astrPose[i] << (i == SE_POSE_VALUES - 1 ? ";" : ", ");
     }
-  }
 
-  strSkeleton += "\nSE_SKELETON_END;\n";
+    file << "\n  }\n";
+  }
 
-#if !_DEV_STL_IO
-  CFileDevice fileD((strFile.RemoveExt() + ".as").c_str());
-  CStringStream file(&fileD, IReadWriteDevice::OM_WRITEONLY);
+  file << "}\n\n";
 
-  file << strSkeleton;
-  fileD.Close();
-#else  
-  FileOut_t file((strFile.RemoveExt() + ".as").c_str());
-  file << strSkeleton;
-  file.close();
-#endif
+  file << "SE_SKELETON_END;\n";
+  file.Close();
   
-  std::cout << "Successfully converted SE2+ ASCII skeleton into SE1 ASCII skeleton!\n";
+  Console() << "Successfully converted SE2+ ASCII skeleton into SE1 ASCII skeleton!\n";
 };
@@ -0,0 +1,180 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "SE_Skeleton.h"
+
+#include "Common/TextScanner.h"
+#include "Common/Trace.h"
+
+// Read a number and return its text as it's written in the file
+static Str_t ReadNumberText(CTextScanner &scan) {
+  scan.SkipWhitespace();
+
+  const c8 *pchStart = scan.pchCur;
+
+  if (!scan.SkipSymbol('-')) {
+    scan.SkipSymbol('+');
+  }
+
+  scan.ReadFloat();
+  return Str_t(pchStart, scan.pchCur);
+};
+
+// Check if the next token is a certain symbol without skipping it
+static bool IsSymbol(CTextScanner &scan, c8 chSymbol) {
+  scan.SkipWhitespace();
+  return !scan.AtEnd() && *scan.pchCur == chSymbol;
+};
+
+// Expect a certain symbol and skip it
+static void ExpectSymbol(CTextScanner &scan, c8 chSymbol) {
+  if (!scan.SkipSymbol(chSymbol)) {
+    scan.Throw("Expected '%c'", chSymbol);
+  }
+};
+
+// Skip a block in curly brackets with all the blocks inside it
+static void SkipBlock(CTextScanner &scan) {
+  ExpectSymbol(scan, '{');
+  s32 iDepth = 1;
+
+  while (iDepth > 0) {
+    scan.SkipWhitespace();
+
+    if (scan.AtEnd()) {
+      scan.Throw("Unexpected end of file inside a block");
+    }
+
+    if (scan.SkipSymbol('{')) {
+      ++iDepth;
+
+    } else if (scan.SkipSymbol('}')) {
+      --iDepth;
+
+    } else {
+      scan.SkipToken();
+    }
+  }
+};
+
+// Read default pose of the bone in curly brackets
+static void ReadBonePose(CTextScanner &scan, CSkeletonBone &bone) {
+  ExpectSymbol(scan, '{');
+
+  bone.astrPose.clear();
+  bone.astrPose.reserve(SE_POSE_VALUES);
+
+  while (!scan.SkipSymbol('}')) {
+    if (scan.AtEnd()) {
+      scan.Throw("Unexpected end of file in the default pose of bone '%s'", bone.strName.c_str());
+    }
+
+    bone.astrPose.push_back(ReadNumberText(scan));
+
+    // Values are separated by commas and end with a semicolon
+    if (!scan.SkipSymbol(',')) {
+      scan.SkipSymbol(';');
+    }
+  }
+
+  if (bone.astrPose.size() != SE_POSE_VALUES) {
+    scan.Throw("Expected %d values in the default pose of bone '%s' but got %u",
+      SE_POSE_VALUES, bone.strName.c_str(), (u32)bone.astrPose.size());
+  }
+};
+
+// Read bones from an SE1 (.as) or SE2+ (.asf) ASCII skeleton
+void ReadSkeletonBones(const c8 *pchData, size_t iSize, CSkeletonBones &aBones) {
+  TRACE_SCOPE("ReadSkeletonBones");
+
+  CTextScanner scan(pchData, iSize);
+
+  // Version of either format
+  if (!scan.SkipIdentifier("SE_SKELETON")) {
+    scan.Throw("Expected 'SE_SKELETON' keyword");
+  }
+
+  ReadNumberText(scan);
+  scan.SkipSymbol(';');
+
+  // Amount of bones is only a hint, since all of them are listed in the block
+  if (!scan.SkipIdentifier("BONES")) {
+    scan.Throw("Expected 'BONES' keyword");
+  }
+
+  const s64 ctBones = scan.ReadInt();
+
+  if (ctBones > 0) {
+    aBones.reserve((size_t)ctBones);
+  }
+
+  ExpectSymbol(scan, '{');
+
+  // Go until the block end
+  while (!scan.SkipSymbol('}')) {
+    if (scan.AtEnd()) {
+      scan.Throw("Expected the end of the bone list");
+    }
+
+    // Each bone starts with its name
+    if (scan.SkipIdentifier("NAME")) {
+      aBones.push_back(CSkeletonBone(scan.ReadString()));
+      scan.SkipSymbol(';');
+      continue;
+    }
+
+    if (aBones.empty()) {
+      scan.Throw("Expected 'NAME' of the first bone");
+    }
+
+    CSkeletonBone &bone = aBones.back();
+
+    // Parent bone name
+    if (scan.SkipIdentifier("PARENT")) {
+      bone.strParent = scan.ReadString();
+      scan.SkipSymbol(';');
+
+    // Bone length
+    } else if (scan.SkipIdentifier("LENGTH")) {
+      bone.strLength = ReadNumberText(scan);
+      scan.SkipSymbol(';');
+
+    // Rotation limits that only SE2+ skeletons have
+    } else if (scan.SkipIdentifier("LIMITS")) {
+      SkipBlock(scan);
+
+    // Default pose with a keyword in SE2+ and without it in SE1
+    } else if (scan.SkipIdentifier("DEFAULT_POSE") || IsSymbol(scan, '{')) {
+      ReadBonePose(scan, bone);
+
+    } else {
+      scan.Throw("Unexpected '%s' in bone '%s'", Str_t(scan.pchCur, scan.WordLength()).c_str(), bone.strName.c_str());
+    }
+  }
+
+  // Every bone needs a pose
+  for (size_t iBone = 0; iBone < aBones.size(); ++iBone) {
+    if (aBones[iBone].astrPose.empty()) {
+      CMessageException::Throw("Bone '%s' has no default pose", aBones[iBone].strName.c_str());
+    }
+  }
+};
@@ -0,0 +1,50 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _SE_SKELETON_H
+#define _SE_SKELETON_H
+
+// Values in the default pose of a bone (3x4 matrix)
+#define SE_POSE_VALUES 12
+
+// Bone of an SE1 or SE2+ ASCII skeleton
+// Numbers are kept as they are written in the file, so they're copied into the other format without changes
+class CSkeletonBone {
+  public:
+    Str_t strName;
+    Str_t strParent;
+    Str_t strLength;
+    Strings_t astrPose;
+
+  public:
+    CSkeletonBone(const Str_t &strSetName) : strName(strSetName), strLength("0")
+    {
+    };
+};
+
+// Bones of an SE1 or SE2+ ASCII skeleton
+typedef std::vector<CSkeletonBone> CSkeletonBones;
+
+// Read bones from an SE1 (.as) or SE2+ (.asf) ASCII skeleton
+// Both formats share the same layout besides optional semicolons, limits and the pose keyword
+void ReadSkeletonBones(const c8 *pchData, size_t iSize, CSkeletonBones &aBones);
+
+#endif
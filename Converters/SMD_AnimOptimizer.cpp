@@ -0,0 +1,262 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "SMD_Structures.h"
+
+#include "Common/Trace.h"
+
+// Rotation of a converted placement
+static void GetPlacementRotation(const Mat12D &m, QuatD &q) {
+  Mat3D m3D;
+
+  for (s32 i = 0; i < 9; ++i) {
+    m3D(i / 3, i % 3) = m(i / 3, i % 3);
+  }
+
+  q.FromMatrix(m3D);
+};
+
+// Dot product of two rotations
+static inline f64 QuatDot(const QuatD &q1, const QuatD &q2) {
+  return q1._w * q2._w + q1._x * q2._x + q1._y * q2._y + q1._z * q2._z;
+};
+
+// Spherical interpolation between two rotations
+static QuatD QuatSlerp(const QuatD &q1, const QuatD &q2In, f64 fRatio) {
+  QuatD q2 = q2In;
+  f64 fCos = QuatDot(q1, q2);
+
+  // Take the shortest path
+  if (fCos < 0.0) {
+    q2 = QuatD(-q2._w, -q2._x, -q2._y, -q2._z);
+    fCos = -fCos;
+  }
+
+  f64 f1 = 1.0 - fRatio;
+  f64 f2 = fRatio;
+
+  // Interpolate linearly between nearly the same rotations
+  if (fCos < 0.9999) {
+    const f64 fAngle = acos(fCos);
+    const f64 fSin = sin(fAngle);
+    f1 = sin(f1 * fAngle) / fSin;
+    f2 = sin(f2 * fAngle) / fSin;
+  }
+
+  QuatD q(f1 * q1._w + f2 * q2._w, f1 * q1._x + f2 * q2._x, f1 * q1._y + f2 * q2._y, f1 * q1._z + f2 * q2._z);
+  const f64 fLength = sqrt(QuatDot(q, q));
+
+  return QuatD(q._w / fLength, q._x / fLength, q._y / fLength, q._z / fLength);
+};
+
+// Angle between two rotations in degrees
+static f64 RotationDifference(const QuatD &q1, const QuatD &q2) {
+  const f64 fSign = (QuatDot(q1, q2) < 0.0 ? -1.0 : 1.0);
+
+  const f64 fW = q1._w - fSign * q2._w;
+  const f64 fX = q1._x - fSign * q2._x;
+  const f64 fY = q1._y - fSign * q2._y;
+  const f64 fZ = q1._z - fSign * q2._z;
+
+  // Chord between unit quaternions is 2*sin(angle/4), which stays precise for tiny angles
+  f64 fHalfChord = sqrt(fW * fW + fX * fX + fY * fY + fZ * fZ) * 0.5;
+
+  if (fHalfChord > 1.0) {
+    fHalfChord = 1.0;
+  }
+
+  return 4.0 * asin(fHalfChord) * 180.0 / 3.14159265358979323846;
+};
+
+// Distance between two positions
+static f64 PositionDifference(const Vec3D &v1, const Vec3D &v2) {
+  const f64 fX = v1[0] - v2[0];
+  const f64 fY = v1[1] - v2[1];
+  const f64 fZ = v1[2] - v2[2];
+  return sqrt(fX * fX + fY * fY + fZ * fZ);
+};
+
+// Placements of one bone in each written frame (frames without keys repeat the last placement)
+static void GetWrittenTrack(const CAnimTracks &tracks, s32 iBone, s32 iFirstFrame, std::vector<Vec3D> &avPos, std::vector<QuatD> &aqRot) {
+  avPos.clear();
+  aqRot.clear();
+
+  size_t iKey = tracks.FirstKey(iBone);
+
+  for (s32 iFrame = iFirstFrame; iFrame < tracks.iFrames; ++iFrame) {
+    tracks.SeekKey(iBone, iKey, iFrame);
+
+    const Mat12D &m = tracks.amConverted[iKey];
+    QuatD q;
+    GetPlacementRotation(m, q);
+
+    avPos.push_back(Vec3D(m(0, 3), m(1, 3), m(2, 3)));
+    aqRot.push_back(q);
+  }
+};
+
+// Measure how far the placement is from the interpolation between two kept frames
+static void MeasureFrameError(const std::vector<Vec3D> &avPos, const std::vector<QuatD> &aqRot,
+  s32 iFrame, s32 iKey1, s32 iKey2, f64 fRatio, f64 &fPosError, f64 &fRotError)
+{
+  const Vec3D &v1 = avPos[iKey1];
+  const Vec3D &v2 = avPos[iKey2];
+  const Vec3D vPos(v1[0] + (v2[0] - v1[0]) * fRatio, v1[1] + (v2[1] - v1[1]) * fRatio, v1[2] + (v2[2] - v1[2]) * fRatio);
+  const QuatD qRot = QuatSlerp(aqRot[iKey1], aqRot[iKey2], fRatio);
+
+  const f64 fPos = PositionDifference(vPos, avPos[iFrame]);
+  const f64 fRot = RotationDifference(qRot, aqRot[iFrame]);
+
+  if (fPos > fPosError) fPosError = fPos;
+  if (fRot > fRotError) fRotError = fRot;
+};
+
+// Find the longest frame step that every bone can reconstruct by interpolating between kept frames
+// Looping: 1 - loops back to the first frame, 0 - stays on the last frame, -1 - unknown (must work for both)
+// Returns the step (1 if no frames can be removed)
+extern s32 ReduceAnimationFrames(const SmdOptions &opts, const SmdStructure &smd, const Ints_t &aiBones, s32 iFirstFrame, s32 iLooping) {
+  TRACE_SCOPE("ReduceAnimationFrames");
+
+  const CAnimTracks &tracks = smd.aTracks;
+  const s32 ctFrames = tracks.iFrames - iFirstFrame;
+
+  // Steps that keep the same animation length (with uniform time between frames)
+  Ints_t aiSteps;
+
+  for (s32 iStep = 2; iStep <= ctFrames; ++iStep) {
+    if (ctFrames % iStep == 0) {
+      aiSteps.push_back(iStep);
+    }
+  }
+
+  const s32 ctSteps = (s32)aiSteps.size();
+  std::vector<f64> afPosError(ctSteps, 0.0);
+  std::vector<f64> afRotError(ctSteps, 0.0);
+  Bits_t aFailed(ctSteps, false);
+
+  std::vector<Vec3D> avPos;
+  std::vector<QuatD> aqRot;
+
+  for (size_t iBone = 0; iBone < aiBones.size(); ++iBone) {
+    GetWrittenTrack(tracks, aiBones[iBone], iFirstFrame, avPos, aqRot);
+
+    for (s32 iCheck = 0; iCheck < ctSteps; ++iCheck) {
+      if (aFailed[iCheck]) continue;
+
+      const s32 iStep = aiSteps[iCheck];
+      f64 &fPosError = afPosError[iCheck];
+      f64 &fRotError = afRotError[iCheck];
+
+      for (s32 iFrame = 0; iFrame < ctFrames; ++iFrame) {
+        const s32 iOffset = iFrame % iStep;
+        if (iOffset == 0) continue;
+
+        const s32 iKey = iFrame - iOffset;
+        const f64 fRatio = f64(iOffset) / f64(iStep);
+
+        if (iKey + iStep < ctFrames) {
+          MeasureFrameError(avPos, aqRot, iFrame, iKey, iKey + iStep, fRatio, fPosError, fRotError);
+
+        // After the last kept frame the animation either loops back to the first one or stays on the last one
+        } else {
+          if (iLooping != 0) MeasureFrameError(avPos, aqRot, iFrame, iKey, 0, fRatio, fPosError, fRotError);
+          if (iLooping != 1) MeasureFrameError(avPos, aqRot, iFrame, iKey, iKey, 0.0, fPosError, fRotError);
+        }
+      }
+
+      // Don't check this step for other bones
+      if (fPosError > opts.fReducePos || fRotError > opts.fReduceRot) {
+        aFailed[iCheck] = true;
+      }
+    }
+  }
+
+  // Pick the longest step within tolerance
+  for (s32 iCheck = ctSteps - 1; iCheck >= 0; --iCheck) {
+    if (aFailed[iCheck]) continue;
+
+    const s32 iStep = aiSteps[iCheck];
+
+    Console() << "Reduced animation from " << ctFrames << " to " << (ctFrames / iStep) << " frames with a step of " << iStep
+      << " frames, max error: " << afPosError[iCheck] << " position, " << afRotError[iCheck] << " degrees...\n";
+    return iStep;
+  }
+
+  Console() << "Animation frames cannot be reduced within the tolerance...\n";
+  return 1;
+};
+
+// Check if the bone stays in its default pose throughout the animation
+static bool IsConstantTrack(const CAnimTracks &tracks, s32 iBone, s32 iFirstFrame, f64 fEpsilon) {
+  const Mat12D &mDefault = tracks.amConverted[tracks.FirstKey(iBone)];
+
+  // Frames without keys repeat the last placement
+  for (size_t iKey = tracks.FirstKey(iBone); iKey < tracks.EndKey(iBone); ++iKey) {
+    if (tracks.aiFrames[iKey] < iFirstFrame) continue;
+
+    const Mat12D &m = tracks.amConverted[iKey];
+
+    for (s32 i = 0; i < 12; ++i) {
+      if (fabs(m(i / 4, i % 4) - mDefault(i / 4, i % 4)) > fEpsilon) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+};
+
+// Remove bones that don't move from the written envelopes, so they stay in the default pose of the skeleton
+extern void RemoveConstantTracks(const SmdOptions &opts, const SmdStructure &smd, std::map<s32, const CBoneInfo *> &mapUsed, s32 iFirstFrame) {
+  TRACE_SCOPE("RemoveConstantTracks");
+
+  // Default pose of the animation doesn't come from the model
+  if (!smd.bSkeletonPose) {
+    Console() << "Cannot omit bones that don't move without the base model...\n";
+    return;
+  }
+
+  const CAnimTracks &tracks = smd.aTracks;
+  const size_t ctTracks = mapUsed.size();
+  const s32 ctFrames = tracks.iFrames - iFirstFrame;
+
+  std::map<s32, const CBoneInfo *>::iterator it = mapUsed.begin();
+
+  while (it != mapUsed.end()) {
+    const s32 iBone = it->first;
+
+    // Root bones are placed differently in models and animations
+    if (it->second->iParent == -1 || !IsConstantTrack(tracks, iBone, iFirstFrame, opts.fConstEpsilon)) {
+      ++it;
+      continue;
+    }
+
+    mapUsed.erase(it++);
+  }
+
+  const size_t ctRemoved = ctTracks - mapUsed.size();
+  const size_t ctPlacements = ctRemoved * (ctFrames + 1);
+  const f64 fRatio = (ctTracks == 0 ? 0.0 : f64(ctRemoved) / f64(ctTracks) * 100.0);
+
+  Console() << "Omitted " << ctRemoved << " out of " << ctTracks << " bone tracks that don't move ("
+    << ctPlacements << " placements, " << fRatio << "% of the animation)...\n";
+};
@@ -21,104 +21,234 @@
 
 #include "Main.h"
 #include "SMD_Structures.h"
+#include "SE1_Binary.h"
+
+#include "Common/OutputFile.h"
+#include "Common/Trace.h"
+
+// Go through written placements of one bone envelope
+template<class Writer>
+static void ForEachEnvelopeFrame(const SmdOptions &opts, const SmdStructure &smd, const SmdAnimation &anim, s32 iBone, Writer &writer) {
+  const CAnimTracks &tracks = smd.aTracks;
+  Mat12D mPlacement = tracks.amConverted[tracks.FirstKey(iBone)];
+
+  // Load keys from the scratch file block by block
+  if (smd.spill.IsUsed()) {
+    extern void ConvertBoneTrack(const SmdOptions &opts, bool bAnimFile, bool bRoot, CAnimTracks &tracks, s32 iBone);
+
+    CTrackSpill &spill = const_cast<CTrackSpill &>(smd.spill);
+    const bool bRoot = (smd.aSkeleton[iBone].iParent == -1);
+
+    CAnimTracks block;
+    s32 iFrame = anim.iFirstFrame;
+
+    for (s32 iBlock = 0; iBlock < (s32)spill.aiBlockStart.size(); ++iBlock) {
+      spill.LoadBone(iBlock, iBone, block);
+      ConvertBoneTrack(opts, smd.bAnimFile, bRoot, block, 0);
+
+      for (size_t iKey = 0; iKey < block.aiFrames.size(); ++iKey) {
+        // Copy last placement until the frame of this key
+        for (; iFrame < block.aiFrames[iKey]; ++iFrame) {
+          writer(mPlacement);
+        }
+
+        mPlacement = block.amConverted[iKey];
+      }
+    }
+
+    // Copy last placement after the last key
+    for (; iFrame < smd.iFrames; ++iFrame) {
+      writer(mPlacement);
+    }
+    return;
+  }
+
+  // Go through each frame (without the first one if more than 1)
+  size_t iKey = tracks.FirstKey(iBone);
+
+  for (s32 iFrame = anim.iFirstFrame; iFrame < tracks.iFrames; ++iFrame) {
+    // Skip removed frames
+    if ((iFrame - anim.iFirstFrame) % anim.iFrameStep != 0) continue;
+
+    // Copy last placement if there's no key on this frame
+    tracks.SeekKey(iBone, iKey, iFrame);
+    writer(tracks.amConverted[iKey]);
+  }
+};
+
+// Get animation properties from its info entry (properties that aren't specified stay the same)
+extern void GetAnimInfo(const CVariant &valInfo, Str_t &strName, f64 &fFPS, s32 &iLooping) {
+  if (valInfo.GetType() == CVariant::VAL_INVALID) {
+    return;
+  }
+
+  const CValObject &oInfo = valInfo.ToObject();
+
+  // Animation name
+  CValObject::const_iterator it = oInfo.find("name");
+
+  if (it != oInfo.end()) {
+    strName = it->second.ToString();
+  }
+
+  // Animation FPS
+  it = oInfo.find("fps");
+
+  if (it != oInfo.end()) {
+    fFPS = GetNumber<f64>(it->second);
+  }
+
+  // Animation looping (only for removing frames)
+  it = oInfo.find("loop");
+
+  if (it != oInfo.end()) {
+    iLooping = (GetNumber<s32>(it->second) != 0);
+  }
+};
+
+// Select animated bones and frames for writing the animation
+extern void PrepareAnimation(const SmdOptions &opts, const SmdStructure &smd, SmdAnimation &anim) {
+  TRACE_SCOPE("PrepareAnimation");
 
-// Write SMD animation in SE1 ASCII format
-extern void WriteAnimation(const SmdOptions &opts, const SmdStructure &smd) {
   // Get animation file name if needed
-  Str_t strAnimation = (smd.bAnimFile ? _strFileName : "Default");
+  anim.strName = (smd.bAnimFile ? smd.strFileName : "Default");
   f64 fFPS = 24.0; // Consistent 24 FPS
+  s32 iLooping = -1; // Unknown playback
 
   // Retrieve animation info if possible
-  if (opts.valAnimInfo.GetType() != CVariant::VAL_INVALID) {
-    const CValObject &oInfo = opts.valAnimInfo.ToObject();
+  GetAnimInfo(opts.valAnimInfo, anim.strName, fFPS, iLooping);
+
+  const s32 iWriteFrames = smd.iFrames - (smd.iFrames > 1);
+
+  // Get affected bones in the entire animation
+  std::map<s32, const CBoneInfo *> &mapUsed = anim.mapBones;
+  mapUsed.clear();
+
+  const CAnimTracks &tracks = smd.aTracks;
+  const s32 iFirstFrame = (smd.iFrames > 1);
+  anim.iFirstFrame = iFirstFrame;
 
-    // Animation name
-    CValObject::const_iterator it = oInfo.find("name");
+  // Frames may be moved into the scratch file instead
+  const bool bWholeTracks = !smd.spill.IsUsed();
 
-    if (it != oInfo.end()) {
-      strAnimation = it->second.ToString();
+  // Bones in the scratch file have been checked while moving them there
+  if (!bWholeTracks) {
+    for (s32 iBoneCheck = 0; iBoneCheck < tracks.iBones; ++iBoneCheck) {
+      if (smd.spill.aAnimated[iBoneCheck] || smd.iFrames == 1) {
+        const CBoneInfo &info = smd.aSkeleton[iBoneCheck];
+        mapUsed[info.iID] = &info;
+      }
     }
+  }
 
-    // Animation FPS
-    it = oInfo.find("fps");
+  // Go through the track of each bone (without the first frame if more than 1)
+  for (s32 iBoneCheck = 0; iBoneCheck < tracks.iBones && bWholeTracks; ++iBoneCheck) {
+    const size_t iEndKey = tracks.EndKey(iBoneCheck);
 
-    if (it != oInfo.end()) {
-      fFPS = GetNumber<f64>(it->second);
+    // Add this bone to the used envelopes list if its last key is written
+    if (iEndKey != tracks.FirstKey(iBoneCheck) && tracks.aiFrames[iEndKey - 1] >= iFirstFrame) {
+      const CBoneInfo &info = smd.aSkeleton[iBoneCheck];
+      mapUsed[info.iID] = &info;
     }
   }
 
-#if !_DEV_STL_IO
-  CFileDevice fileD((_strFilePath + ".aa").c_str());
-  CStringStream file(&fileD, IReadWriteDevice::OM_WRITEONLY);
-#else
-  FileOut_t file((_strFilePath + ".aa").c_str());
-#endif
+  // Passes over whole tracks need all frames in memory
+  if (!bWholeTracks && (opts.fConstEpsilon >= 0.0 || opts.fReducePos >= 0.0)) {
+    Console() << "Skipping bone and frame removal for the animation in the scratch file...\n";
+  }
 
-  file << "SE_ANIM 0.1;\n\n";
+  // Leave bones that don't move in the default pose
+  if (opts.fConstEpsilon >= 0.0 && bWholeTracks) {
+    extern void RemoveConstantTracks(const SmdOptions &opts, const SmdStructure &smd, std::map<s32, const CBoneInfo *> &mapUsed, s32 iFirstFrame);
+    RemoveConstantTracks(opts, smd, mapUsed, iFirstFrame);
+  }
 
-  const s32 iWriteFrames = smd.iFrames - (smd.iFrames > 1);
+  // Keep only frames that can't be interpolated from their neighbours
+  anim.iFrameStep = 1;
 
-  file << "SEC_PER_FRAME " << (1.0/fFPS) << ";\n"; // Seconds per one frame
-  file << "FRAMES " << iWriteFrames << ";\n";
-  file << "ANIM_ID \"" << strAnimation << "\";\n\n";
+  if (opts.fReducePos >= 0.0 && bWholeTracks) {
+    Ints_t aiBones;
+    std::map<s32, const CBoneInfo *>::const_iterator it;
 
-  // Get affected bones in the entire animation
-  std::map<s32, CBoneInfo *> mapUsed;
-  
-  // Go through each frame (without the first one if more than 1)
-  for (s32 iFrameCheck = (smd.iFrames > 1); iFrameCheck < smd.iFrames; ++iFrameCheck)
-  {
-    const CEnvelopes &aFrameEnvelopes = smd.aFrames[iFrameCheck].aBones;
-
-    // Go through each bone envelope in the frame
-    for (size_t iEnv = 0; iEnv < aFrameEnvelopes.size(); ++iEnv) {
-      // Not used
-      if (!smd.aFrames[iFrameCheck].aUsed[iEnv]) {
-        continue;
-      }
-      
-      // Add this bone to the used envelopes list
-      const CBoneEnvelope &env = aFrameEnvelopes[iEnv];
-      mapUsed[env.pInfo->iID] = env.pInfo;
+    for (it = mapUsed.begin(); it != mapUsed.end(); ++it) {
+      aiBones.push_back(it->first);
     }
+
+    extern s32 ReduceAnimationFrames(const SmdOptions &opts, const SmdStructure &smd, const Ints_t &aiBones, s32 iFirstFrame, s32 iLooping);
+    anim.iFrameStep = ReduceAnimationFrames(opts, smd, aiBones, iFirstFrame, iLooping);
   }
 
-  file << "BONEENVELOPES " << mapUsed.size() << "\n{\n";
+  anim.ctFrames = iWriteFrames / anim.iFrameStep;
+  anim.fSecPerFrame = f64(anim.iFrameStep) / fFPS; // Seconds per one frame
+};
+
+// Write placements of envelope frames as text
+class CAsciiFrameWriter {
+  public:
+    COutputFile &file;
+
+  public:
+    CAsciiFrameWriter(COutputFile &fileSet) : file(fileSet)
+    {
+    };
+
+    inline void operator()(const Mat12D &mPlacement) {
+      file << "\n    ";
+      PrintPlacement(mPlacement, file);
+    };
+};
+
+// Write SMD animation in SE1 ASCII format
+extern void WriteAnimation(const SmdOptions &opts, const SmdStructure &smd, const SmdAnimation &anim) {
+  TRACE_SCOPE("WriteAnimation");
+
+  const CAnimTracks &tracks = smd.aTracks;
+  const bool bWholeTracks = !smd.spill.IsUsed();
 
   // Go through each affected envelope
-  std::map<s32, CBoneInfo *>::const_iterator it;
+  std::map<s32, const CBoneInfo *>::const_iterator it;
 
-  for (it = mapUsed.begin(); it != mapUsed.end(); ++it) {
-    const s32 iBoneIndex = it->first;
+  // Longest possible text of the animation (placement per frame and the default one)
+  const size_t iPlacement = 12 * (MaxFloatTextLength(_iFloatDigits) + 2) + 8;
+  size_t iExpectedSize = 256 + anim.strName.size();
+
+  for (it = anim.mapBones.begin(); it != anim.mapBones.end(); ++it) {
+    iExpectedSize += it->second->strName.size() + 64 + (anim.ctFrames + 1) * iPlacement;
+  }
+
+  // Don't buffer the whole animation if it doesn't fit into memory
+  if (!bWholeTracks && iExpectedSize > smd.iMemoryLimit / 4) {
+    iExpectedSize = (size_t)(smd.iMemoryLimit / 4);
+  }
+
+  COutputFile file;
+  file.Open(smd.strFilePath + ".aa");
+  file.Reserve(iExpectedSize);
+
+  file << "SE_ANIM 0.1;\n\n";
+
+  file << "SEC_PER_FRAME " << anim.fSecPerFrame << ";\n";
+  file << "FRAMES " << anim.ctFrames << ";\n";
+  file << "ANIM_ID \"" << anim.strName << "\";\n\n";
+
+  file << "BONEENVELOPES " << anim.mapBones.size() << "\n{\n";
+
+  CAsciiFrameWriter writer(file);
 
+  for (it = anim.mapBones.begin(); it != anim.mapBones.end(); ++it) {
+    const s32 iBoneIndex = it->first;
     const CBoneInfo &info = *it->second;
-    const CBoneEnvelope &boneDef = smd.aFrames[0].aBones[iBoneIndex];
-    Mat12D mPlacement = boneDef.mConverted;
 
     file << "  NAME \"" << info.strName << "\"\n";
 
     // Default bone position
     file << "  DEFAULT_POSE { ";
-    PrintPlacement(mPlacement, file);
+    PrintPlacement(tracks.amConverted[tracks.FirstKey(iBoneIndex)], file);
     file << " }\n";
 
     // Bone envelope frames
     file << "  {";
-    
-    // Go through each frame (without the first one if more than 1)
-    for (s32 iFrame = (smd.iFrames > 1); iFrame < smd.iFrames; ++iFrame) {
-      file << "\n    ";
-
-      // Set this frame's bone placement if it's used
-      if (smd.aFrames[iFrame].aUsed[iBoneIndex]) {
-        const CBoneEnvelope &boneEnv = smd.aFrames[iFrame].aBones[iBoneIndex];
-        mPlacement = boneEnv.mConverted;
-      }
-
-      // Copy last placement if unused
-      PrintPlacement(mPlacement, file);
-    }
-
+    ForEachEnvelopeFrame(opts, smd, anim, iBoneIndex, writer);
     file << "\n  }\n";
   }
 
@@ -128,11 +258,102 @@ extern void WriteAnimation(const SmdOptions &opts, const SmdStructure &smd) {
     
   file << "SE_ANIM_END;\n";
 
-#if !_DEV_STL_IO
-  fileD.Close();
-#else
-  file.close();
-#endif
+  file.Close();
     
-  std::cout << "Converted animation...\n";
+  Console() << "Converted animation...\n";
+};
+
+// Collect placements of envelope frames as positions and rotations
+class CBinaryFrameWriter {
+  public:
+    std::vector<Vec3D> avPos;
+    std::vector<QuatD> aqRot;
+
+  public:
+    inline void operator()(const Mat12D &mPlacement) {
+      QuatD q;
+      PlacementToQuat(mPlacement, q);
+
+      avPos.push_back(Vec3D(mPlacement(0, 3), mPlacement(1, 3), mPlacement(2, 3)));
+      aqRot.push_back(q);
+    };
+};
+
+// Write SMD animation in SE1 binary format (animation set with a single uncompressed animation)
+extern void WriteAnimationBinary(const SmdOptions &opts, const SmdStructure &smd, const SmdAnimation &anim) {
+  TRACE_SCOPE("WriteAnimationBinary");
+
+  if (anim.ctFrames > SE1_MAX_ANIM_FRAMES) {
+    CMessageException::Throw("Binary animations can't have more than %d frames", SE1_MAX_ANIM_FRAMES);
+  }
+
+  const CAnimTracks &tracks = smd.aTracks;
+
+  COutputFile file;
+  file.Open(smd.strFilePath + ".ba");
+
+  file.Write(SE1_ANIMSET_ID, 4);
+  file.WriteLong(SE1_ANIMSET_VERSION);
+  file.WriteLong(1); // Animations
+
+  file.WriteString(smd.strFileName + ".aa"); // Source file
+  file.WriteString(anim.strName);
+  file.WriteFloat(anim.fSecPerFrame);
+  file.WriteLong(anim.ctFrames);
+  file.WriteFloat(0.0); // Compression threshold
+  file.WriteLong(0); // Compressed
+  file.WriteLong(0); // Custom speed
+
+  file.WriteLong((u32)anim.mapBones.size());
+
+  CBinaryFrameWriter writer;
+  std::map<s32, const CBoneInfo *>::const_iterator it;
+
+  for (it = anim.mapBones.begin(); it != anim.mapBones.end(); ++it) {
+    const s32 iBoneIndex = it->first;
+    const Mat12D &mDefault = tracks.amConverted[tracks.FirstKey(iBoneIndex)];
+
+    file.WriteString(it->second->strName);
+
+    // Default bone position
+    for (s32 i = 0; i < 12; ++i) {
+      file.WriteFloat(mDefault(i / 4, i % 4));
+    }
+
+    writer.avPos.clear();
+    writer.aqRot.clear();
+    ForEachEnvelopeFrame(opts, smd, anim, iBoneIndex, writer);
+
+    const s32 ctFrames = (s32)writer.avPos.size();
+
+    // Positions in each frame
+    file.WriteLong(ctFrames);
+
+    for (s32 iPos = 0; iPos < ctFrames; ++iPos) {
+      file.WriteShort((u16)iPos);
+      file.WriteShort(0);
+      file.WriteFloat(writer.avPos[iPos][0]);
+      file.WriteFloat(writer.avPos[iPos][1]);
+      file.WriteFloat(writer.avPos[iPos][2]);
+    }
+
+    // Rotations in each frame
+    file.WriteLong(ctFrames);
+
+    for (s32 iRot = 0; iRot < ctFrames; ++iRot) {
+      file.WriteShort((u16)iRot);
+      file.WriteShort(0);
+      WriteQuat(file, writer.aqRot[iRot]);
+    }
+
+    // Offset length of the default position
+    const Vec3D vOffset(mDefault(0, 3), mDefault(1, 3), mDefault(2, 3));
+    file.WriteFloat(sqrt(vOffset[0] * vOffset[0] + vOffset[1] * vOffset[1] + vOffset[2] * vOffset[2]));
+  }
+
+  file.WriteLong(0); // Morph envelopes
+
+  file.Close();
+
+  Console() << "Converted binary animation...\n";
 };
@@ -0,0 +1,299 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "SMD_Structures.h"
+
+#include "Common/FileSystem.h"
+#include "Common/Platform.h"
+#include "Common/Trace.h"
+
+// Cache file format
+#define BASE_CACHE_MAGIC   "SKABASE"
+#define BASE_CACHE_VERSION 1
+#define BASE_CACHE_ENDIAN  0x01020304
+
+// Cached skeleton of one base model
+struct BaseCacheEntry {
+  CMutex mxLoad;
+  bool bLoaded;
+  CBaseSkeleton skel;
+
+  BaseCacheEntry(void) : bLoaded(false) {};
+};
+
+// Cached skeletons by file state
+typedef std::map<Str_t, BaseCacheEntry *> CBaseCache;
+
+static CBaseCache _mapBaseCache;
+static CMutex _mxBaseCache;
+
+// Free cached skeletons on exit
+static struct BaseCacheCleanup {
+  ~BaseCacheCleanup(void) {
+    for (CBaseCache::iterator it = _mapBaseCache.begin(); it != _mapBaseCache.end(); ++it) {
+      delete it->second;
+    }
+  };
+} _baseCacheCleanup;
+
+// Append a number as a hexadecimal string
+static void AppendHex(Str_t &str, u64 iValue) {
+  static const c8 *strDigits = "0123456789abcdef";
+
+  for (s32 iShift = 60; iShift >= 0; iShift -= 4) {
+    str += strDigits[(iValue >> iShift) & 0xF];
+  }
+};
+
+// Make a key that changes together with the file (returns false if there's no file)
+extern bool GetFileCacheKey(const Str_t &strFile, Str_t &strKey) {
+  FileInfo info;
+
+  if (!GetFileInfo(strFile, info) || info.bDir) {
+    return false;
+  }
+
+  strKey = GetCanonicalPath(strFile) + '|';
+  AppendHex(strKey, info.iSize);
+  strKey += '|';
+  AppendHex(strKey, info.iModified);
+  return true;
+};
+
+// Get cache file with a certain extension for the file key in the cache directory
+extern Str_t GetCacheFile(const Str_t &strCacheDir, const Str_t &strKey, const Str_t &strExt) {
+  // FNV-1a hash of the file key
+  u64 iHash = U64_C(14695981039346656037);
+
+  for (size_t iChar = 0; iChar < strKey.size(); ++iChar) {
+    iHash = (iHash ^ (u8)strKey[iChar]) * U64_C(1099511628211);
+  }
+
+  Str_t strFile = strCacheDir;
+
+  if (!strFile.empty() && strFile[strFile.size() - 1] != '/' && strFile[strFile.size() - 1] != '\\') {
+    strFile += '/';
+  }
+
+  AppendHex(strFile, iHash);
+  return strFile + strExt;
+};
+
+// Read a value from the cache file
+template<class Type> inline
+bool ReadCacheValue(FILE *file, Type &val) {
+  return fread(&val, sizeof(Type), 1, file) == 1;
+};
+
+// Read a string from the cache file
+static bool ReadCacheString(FILE *file, Str_t &str) {
+  u32 iLength;
+
+  if (!ReadCacheValue(file, iLength) || iLength > 0xFFFF) {
+    return false;
+  }
+
+  str.resize(iLength);
+  return iLength == 0 || fread(&str[0], 1, iLength, file) == iLength;
+};
+
+// Write a string into the cache file
+static void WriteCacheString(FILE *file, const Str_t &str) {
+  const u32 iLength = (u32)str.size();
+  fwrite(&iLength, sizeof(u32), 1, file);
+  fwrite(str.c_str(), 1, iLength, file);
+};
+
+// Load skeleton from the cache file if it matches the base model
+static bool LoadBaseCacheFile(const Str_t &strCacheFile, const Str_t &strKey, CBaseSkeleton &skel) {
+  FILE *file = fopen(strCacheFile.c_str(), "rb");
+
+  if (file == nullptr) {
+    return false;
+  }
+
+  c8 strMagic[8];
+  u32 iVersion = 0, iEndian = 0, ctBones = 0;
+  Str_t strFileKey;
+
+  bool bValid = fread(strMagic, 1, 8, file) == 8 && memcmp(strMagic, BASE_CACHE_MAGIC, 8) == 0
+    && ReadCacheValue(file, iVersion) && iVersion == BASE_CACHE_VERSION
+    && ReadCacheValue(file, iEndian) && iEndian == BASE_CACHE_ENDIAN
+    && ReadCacheString(file, strFileKey) && strFileKey == strKey
+    && ReadCacheValue(file, ctBones);
+
+  // Read bones
+  skel.aSkeleton.clear();
+
+  for (u32 iBone = 0; bValid && iBone < ctBones; ++iBone) {
+    s32 iID, iParent;
+    Str_t strName;
+
+    bValid = ReadCacheValue(file, iID) && ReadCacheValue(file, iParent) && ReadCacheString(file, strName);
+    skel.aSkeleton.push_back(CBoneInfo(iID, iParent, strName));
+  }
+
+  // Read default pose
+  skel.ResetPose();
+
+  for (u32 iPlace = 0; bValid && iPlace < ctBones; ++iPlace) {
+    CBonePlacement &place = skel.aPose[iPlace];
+
+    for (s32 i = 0; bValid && i < 3; ++i) {
+      bValid = ReadCacheValue(file, place.vPos[i]) && ReadCacheValue(file, place.vRot[i]);
+    }
+  }
+
+  fclose(file);
+  return bValid;
+};
+
+// Save skeleton of the base model into the cache file
+static void SaveBaseCacheFile(const Str_t &strCacheFile, const Str_t &strKey, const CBaseSkeleton &skel) {
+  MakeDirectory(GetFileDir(strCacheFile));
+
+  // Write into a temporary file first to not leave broken files behind
+  const Str_t strTemp = strCacheFile + ".tmp";
+  FILE *file = fopen(strTemp.c_str(), "wb");
+
+  if (file == nullptr) {
+    return;
+  }
+
+  const u32 iVersion = BASE_CACHE_VERSION;
+  const u32 iEndian = BASE_CACHE_ENDIAN;
+  const u32 ctBones = (u32)skel.aSkeleton.size();
+
+  fwrite(BASE_CACHE_MAGIC, 1, 8, file);
+  fwrite(&iVersion, sizeof(u32), 1, file);
+  fwrite(&iEndian, sizeof(u32), 1, file);
+  WriteCacheString(file, strKey);
+  fwrite(&ctBones, sizeof(u32), 1, file);
+
+  for (u32 iBone = 0; iBone < ctBones; ++iBone) {
+    const CBoneInfo &info = skel.aSkeleton[iBone];
+
+    fwrite(&info.iID, sizeof(s32), 1, file);
+    fwrite(&info.iParent, sizeof(s32), 1, file);
+    WriteCacheString(file, info.strName);
+  }
+
+  for (u32 iPlace = 0; iPlace < ctBones; ++iPlace) {
+    const CBonePlacement &place = skel.aPose[iPlace];
+
+    for (s32 i = 0; i < 3; ++i) {
+      fwrite(&place.vPos[i], sizeof(f64), 1, file);
+      fwrite(&place.vRot[i], sizeof(f64), 1, file);
+    }
+  }
+
+  const bool bWritten = (ferror(file) == 0);
+  fclose(file);
+
+  if (!bWritten) {
+    remove(strTemp.c_str());
+    return;
+  }
+
+  remove(strCacheFile.c_str());
+  rename(strTemp.c_str(), strCacheFile.c_str());
+};
+
+// Find or create cache entry for the file state
+static BaseCacheEntry &GetBaseCacheEntry(const Str_t &strKey) {
+  CMutexLock lock(_mxBaseCache);
+  BaseCacheEntry *&pEntry = _mapBaseCache[strKey];
+
+  if (pEntry == nullptr) {
+    pEntry = new BaseCacheEntry;
+  }
+
+  return *pEntry;
+};
+
+// Get default skeleton pose of the base model (returns nullptr if there's no file)
+extern const CBaseSkeleton *GetBaseSkeleton(const Str_t &strFile, const Str_t &strCacheDir) {
+  TRACE_SCOPE_DETAIL("GetBaseSkeleton", strFile);
+
+  Str_t strKey;
+
+  if (!GetFileCacheKey(strFile, strKey)) {
+    return nullptr;
+  }
+
+  BaseCacheEntry &entry = GetBaseCacheEntry(strKey);
+
+  // Other conversions wait until the skeleton is loaded once
+  CMutexLock lock(entry.mxLoad);
+
+  if (entry.bLoaded) {
+    return &entry.skel;
+  }
+
+  // Try loading it from the disk
+  const Str_t strCacheFile = (strCacheDir.empty() ? "" : GetCacheFile(strCacheDir, strKey, ".skel"));
+
+  if (strCacheFile != "" && LoadBaseCacheFile(strCacheFile, strKey, entry.skel)) {
+    Console() << "Loaded base skeleton from " << strCacheFile << "...\n";
+    entry.bLoaded = true;
+    return &entry.skel;
+  }
+
+  // Build only the skeleton from the model
+  SmdStructure smdSkeleton;
+  smdSkeleton.bOnlySkeleton = true;
+
+  extern void ReadSMD(const CPath &strFile, SmdStructure &smd);
+  ReadSMD(strFile, smdSkeleton);
+
+  entry.skel.FromSMD(smdSkeleton);
+  entry.bLoaded = true;
+
+  if (strCacheFile != "") {
+    SaveBaseCacheFile(strCacheFile, strKey, entry.skel);
+  }
+
+  return &entry.skel;
+};
+
+// Remember skeleton of the converted model for animations that use it as a base
+extern void CacheBaseSkeleton(const Str_t &strFile, const Str_t &strCacheDir, const SmdStructure &smd) {
+  Str_t strKey;
+
+  if (smd.iFrames == 0 || !GetFileCacheKey(strFile, strKey)) {
+    return;
+  }
+
+  BaseCacheEntry &entry = GetBaseCacheEntry(strKey);
+  CMutexLock lock(entry.mxLoad);
+
+  if (entry.bLoaded) {
+    return;
+  }
+
+  entry.skel.FromSMD(smd);
+  entry.bLoaded = true;
+
+  if (!strCacheDir.empty()) {
+    SaveBaseCacheFile(GetCacheFile(strCacheDir, strKey, ".skel"), strKey, entry.skel);
+  }
+};
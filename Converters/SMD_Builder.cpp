@@ -22,319 +22,374 @@
 #include "Main.h"
 #include "SMD_Structures.h"
 
-// SMD building
-static CTokenList *paTokens = nullptr;
-static CTokenList::const_iterator it;
-
-// Expect a certain identifier
-bool ExpectKeyword(const Str_t &strID, bool bThrowException) {
-  // At the end
-  if (it == paTokens->end()) {
-    return false;
-  }
+#include "Common/MemoryStats.h"
+#include "Common/TextScanner.h"
+#include "Common/Trace.h"
 
-  // Invalid keyword
-  if (it->GetType() != Tkn_t::TKN_IDENTIFIER || it->GetValue().ToString() != strID)
-  {
-    if (bThrowException) {
-      CTokenException::Throw(it->GetTokenPos(), "Expected '%s' keyword", strID.c_str());
-    }
+#include <algorithm>
+
+// Read bone index and check its bounds
+static s32 ReadBoneIndex(CTextScanner &scan, const SmdStructure &smd) {
+  scan.SkipWhitespace();
 
-    return false;
+  const c8 *pchIndex = scan.pchCur;
+  const s32 iBone = (s32)scan.ReadInt();
+
+  // Invalid bone
+  if (iBone < 0 || iBone >= smd.iBones) {
+    scan.pchCur = pchIndex;
+    scan.Throw("Bone index %d is out of bounds [0, %d]", iBone, smd.iBones - 1);
   }
 
-  return true;
+  return iBone;
 };
 
-// Build from the tokenized SMD file
-extern void BuildSMD(CTokenList &aTokens, SmdStructure &smd) {
-  paTokens = &aTokens;
-  it = aTokens.begin();
-  
-  try {
-    // Expect version and skip it
-    ExpectKeyword("version", true);
-    it += 2;
-
-    // Past the nodes
-    ExpectKeyword("nodes", true);
-    ++it;
-
-    // Parse until the block end
-    bool bEnd = false;
-    s32 iNegative = 1;
-
-    while (!bEnd) {
-      // Get ID and go to the name
-      s32 iID = (s32)(*it)(Tkn_t::TKN_VALUE).GetValue().ToS64();
-      ++it;
-
-      // Get name and go to parent ID
-      Str_t strName = (*it)(Tkn_t::TKN_VALUE).GetValue().ToString();
-      ++it;
-
-      iNegative = 1;
-
-      // Skip unary operators
-      if (it->GetType() == Tkn_t::TKN_SUB) {
-        iNegative = -1;
-        ++it;
-      }
+// Keys in the order they have been read from the file
+struct ParsedKeys {
+  Ints_t aiBones;
+  Ints_t aiFrames;
+  std::vector<f64> aValues; // XYZHPB of each key
+
+  inline size_t Count(void) const {
+    return aiBones.size();
+  };
+
+  void Clear(void) {
+    aiBones.clear();
+    aiFrames.clear();
+    aValues.clear();
+  };
+};
+
+// Order of keys of one bone by their frames
+struct KeyFrameOrder {
+  const Ints_t *paiFrames;
+
+  inline bool operator()(size_t iKey1, size_t iKey2) const {
+    return (*paiFrames)[iKey1] < (*paiFrames)[iKey2];
+  };
+};
+
+// Sort keys that have been read frame by frame into bone tracks
+// Keys of each bone go in the order of their frames and only the last key read for the same frame is kept
+static void SortKeysIntoTracks(const ParsedKeys &keys, s32 iBones, s32 iFrames, CAnimTracks &tracks) {
+  TRACE_SCOPE("SortKeysIntoTracks");
+
+  const size_t ctKeys = keys.Count();
+
+  // Count keys of each bone
+  std::vector<size_t> aiFirst(iBones + 1, 0);
+
+  for (size_t iKey = 0; iKey < ctKeys; ++iKey) {
+    ++aiFirst[keys.aiBones[iKey] + 1];
+  }
+
+  for (s32 iBone = 0; iBone < iBones; ++iBone) {
+    aiFirst[iBone + 1] += aiFirst[iBone];
+  }
+
+  // Group keys by bones while keeping the order they have been read in
+  std::vector<size_t> aiOrder(ctKeys);
+  std::vector<size_t> aiNext(aiFirst.begin(), aiFirst.end() - 1);
+
+  for (size_t iKey = 0; iKey < ctKeys; ++iKey) {
+    aiOrder[aiNext[keys.aiBones[iKey]]++] = iKey;
+  }
 
-      // Get parent ID and go further
-      s32 iParent = (s32)(*it)(Tkn_t::TKN_VALUE).GetValue().ToS64() * iNegative;
-      ++it;
+  KeyFrameOrder order;
+  order.paiFrames = &keys.aiFrames;
 
-      smd.aSkeleton.push_back(CBoneInfo(iID, iParent, strName));
+  tracks.Reset(iBones, iFrames, ctKeys);
 
-      // Check for next bone
-      bEnd = ExpectKeyword("end", false);
+  for (s32 iBone = 0; iBone < iBones; ++iBone) {
+    const std::vector<size_t>::iterator itBegin = aiOrder.begin() + aiFirst[iBone];
+    const std::vector<size_t>::iterator itEnd = aiOrder.begin() + aiFirst[iBone + 1];
+
+    // Times in the file don't have to go in order
+    bool bSorted = true;
+
+    for (std::vector<size_t>::iterator it = itBegin; it != itEnd && it + 1 != itEnd && bSorted; ++it) {
+      bSorted = (keys.aiFrames[*it] <= keys.aiFrames[*(it + 1)]);
     }
 
-    // Count bones in the skeleton
-    smd.iBones = (s32)smd.aSkeleton.size();
+    if (!bSorted) {
+      std::stable_sort(itBegin, itEnd, order);
+    }
 
-    // Skip block end
-    ++it;
+    for (std::vector<size_t>::iterator it = itBegin; it != itEnd; ++it) {
+      // Replaced by a later key on the same frame
+      if (it + 1 != itEnd && keys.aiFrames[*(it + 1)] == keys.aiFrames[*it]) continue;
 
-    // Expect skeleton
-    ExpectKeyword("skeleton", true);
-    ++it;
+      const f64 *pValues = &keys.aValues[*it * SMD_PLACEMENT_VALUES];
+      tracks.AddKey(keys.aiFrames[*it], Vec3D(pValues[0], pValues[1], pValues[2]), Ang3D(pValues[3], pValues[4], pValues[5]));
+    }
 
-    // Expect animation frame
-    ExpectKeyword("time", true);
+    tracks.EndBone();
+  }
+};
 
-    // Parse bone positions for each frame
-    bool bNextBlock = false;
-    bEnd = false;
-  
-    // Go until the block end
-    do {
-      // Skip 'time'
-      ++it;
+// Build directly from the SMD file contents
+extern void BuildSMD(const c8 *pchData, size_t iSize, SmdStructure &smd) {
+  TRACE_SCOPE("BuildSMD");
 
-      // Get time frame
-      s32 iFrame = (s32)(*it)(Tkn_t::TKN_VALUE).GetValue().ToS64();
-      ++it;
+  // Skip end-line comments that start with '#' or ';'
+  CTextScanner scan(pchData, iSize, "#;");
 
-      // Create new frame
-      CAnimFrame frame(smd.iBones);
+  // Expect version and skip it
+  scan.ExpectWord("version");
+  scan.ReadInt();
 
-      // It only sets to true if there are no bones in the current frame (safety check)
-      bNextBlock = ExpectKeyword("time", false);
+  // Past the nodes
+  scan.ExpectWord("nodes");
 
-      // Parsed bones
-      s32 iBonePositions = 0;
+  // Parse until the block end
+  do {
+    // Get ID, name and parent ID
+    const s32 iID = (s32)scan.ReadInt();
+    const Str_t strName = scan.ReadString();
+    const s32 iParent = (s32)scan.ReadInt();
 
-      // Go until the next frame or block end
-      while (!bNextBlock && !bEnd) {
-        // NOTE: If for some reason the frame doesn't contain any bone positions, this will fail
+    smd.aSkeleton.push_back(CBoneInfo(iID, iParent, strName));
 
-        // Get bone index
-        s32 iBone = (s32)(*it)(Tkn_t::TKN_VALUE).GetValue().ToS64();
+  // Check for next bone
+  } while (!scan.SkipWord("end"));
 
-        // Invalid bone
-        if (iBone < 0 || iBone >= smd.iBones) {
-          CTokenException::Throw(it->GetTokenPos(), "Bone index %d is out of bounds [0, %d]", iBone, smd.iBones - 1);
-        }
+  // Count bones in the skeleton
+  smd.iBones = (s32)smd.aSkeleton.size();
 
-        // Bone envelope in this frame
-        CBoneEnvelope env(&smd.aSkeleton[iBone]);
-        
-        // Go to the bone positions
-        ++it;
-
-        // Parse XYZHPB bone positions
-        for (s32 iPos = 0; iPos < 6; ++iPos) {
-          iNegative = 1;
-
-          // Skip unary operators
-          if (it->GetType() == Tkn_t::TKN_SUB) {
-            iNegative = -1;
-            ++it;
-          }
-
-          if (iPos < 3) {
-            env.vPos[iPos] = GetNumber<f64>(it->GetValue()) * (f64)iNegative;
-          } else {
-            env.vRot[iPos - 3] = GetNumber<f64>(it->GetValue()) * (f64)iNegative;
-          }
-
-          ++it;
-        }
+  // Expect skeleton
+  scan.ExpectWord("skeleton");
 
-        // Assign bone envelope to the frame
-        frame.aBones[iBone] = env;
-        frame.aUsed[iBone] = true;
+  // Expect animation frame
+  scan.ExpectWord("time");
 
-        // Next frame or block end
-        bEnd = ExpectKeyword("end", false);
-        bNextBlock = ExpectKeyword("time", false);
+  // Keys are read frame by frame and sorted into bone tracks afterwards
+  ParsedKeys keys;
 
-        ++iBonePositions;
-      }
+  // Keys of the first frame if other frames are moved into the scratch file
+  ParsedKeys keysFirst;
+
+  // Keys that fit into the memory limit
+  const u64 ctMaxKeys = smd.GetMaxKeys();
+
+  // Frames are numbered from the time of the first one
+  s32 iFirstTime = 0;
+  s32 iLastFrame = -1;
+  s32 iSpilledFrame = -1; // Last frame that has been moved into the scratch file
+  s32 ctTimes = 0;
+
+  // Bones listed on the first frame
+  Bits_t aFirstFrameBones(smd.iBones, false);
+  s32 ctFirstFrameBones = 0;
+
+  // Parse bone positions for each frame
+  do {
+    // Get time frame
+    scan.SkipWhitespace();
+
+    const c8 *pchTime = scan.pchCur;
+    const s32 iTime = (s32)scan.ReadInt();
+
+    if (ctTimes == 0) {
+      iFirstTime = iTime;
+    }
+
+    const s32 iFrame = iTime - iFirstTime;
+
+    // Bones are only guaranteed to have keys on the first frame
+    if (iFrame < 0) {
+      scan.pchCur = pchTime;
+      scan.Throw("Frame time %d comes before the first frame time %d", iTime, iFirstTime);
+    }
+
+    // Move parsed keys into the scratch file if there are too many
+    if (ctMaxKeys != 0 && keys.Count() >= ctMaxKeys) {
+      if (!smd.spill.IsUsed()) {
+        for (size_t iKey = 0; iKey < keys.Count(); ++iKey) {
+          if (keys.aiFrames[iKey] != 0) continue;
 
-      // Should go through all bones in the first frame
-      if (iFrame == 0 && iBonePositions < smd.iBones) {
-        CMessageException::Throw("Expected positions for all bones on the first frame but got %d/%d", iBonePositions, smd.iBones);
+          keysFirst.aiBones.push_back(keys.aiBones[iKey]);
+          keysFirst.aiFrames.push_back(0);
+          keysFirst.aValues.insert(keysFirst.aValues.end(), keys.aValues.begin() + iKey * SMD_PLACEMENT_VALUES,
+            keys.aValues.begin() + (iKey + 1) * SMD_PLACEMENT_VALUES);
+        }
       }
 
-      // Add animation frame
-      smd.aFrames.push_back(frame);
+      CAnimTracks block;
+      SortKeysIntoTracks(keys, smd.iBones, iLastFrame + 1, block);
+      smd.spill.AddBlock(smd.strFilePath + ".spill", block);
+
+      keys.Clear();
+      iSpilledFrame = iLastFrame;
+    }
+
+    // Keys in the scratch file cannot be sorted together with the new ones
+    if (iFrame <= iSpilledFrame) {
+      scan.pchCur = pchTime;
+      scan.Throw("Frame time %d is out of order with frames that have been moved into the scratch file", iTime);
+    }
 
-      std::cout << "Added animation frame " << smd.aFrames.size() << "...\n";
+    ++ctTimes;
+    if (iFrame > iLastFrame) iLastFrame = iFrame;
 
-    // Go again if there's another frame
-    } while (bNextBlock && !bEnd);
+    // Go until the next frame or block end
+    while (!scan.IsWord("time") && !scan.IsWord("end")) {
+      // Get bone index
+      const s32 iBone = ReadBoneIndex(scan, smd);
 
-    // Skip block end
-    ++it;
+      // Parse XYZHPB bone positions
+      keys.aiBones.push_back(iBone);
+      keys.aiFrames.push_back(iFrame);
 
-    // Count animation frames
-    smd.iFrames = (s32)smd.aFrames.size();
+      for (s32 iValue = 0; iValue < SMD_PLACEMENT_VALUES; ++iValue) {
+        keys.aValues.push_back(scan.ReadFloat());
+      }
 
-    if (smd.iFrames > 0) {
-      std::cout << '\n';
+      if (ctTimes == 1 && !aFirstFrameBones[iBone]) {
+        aFirstFrameBones[iBone] = true;
+        ++ctFirstFrameBones;
+      }
     }
 
-    // Only build the skeleton
-    if (smd.bOnlySkeleton) {
-      return;
+    // Should go through all bones in the first frame
+    if (ctTimes == 1 && ctFirstFrameBones < smd.iBones) {
+      s32 iMissing = 0;
+      while (aFirstFrameBones[iMissing]) ++iMissing;
+
+      CMessageException::Throw("Expected positions for all bones on the first frame but got %d/%d (bone %d is missing)",
+        ctFirstFrameBones, smd.iBones, iMissing);
     }
-    
-    // Expect triangles block, if it's present
-    if (ExpectKeyword("triangles", false) && !smd.bVtxAnim) {
-      smd.bAnimFile = false;
-
-      // Go to the material of the first triangle
-      ++it;
-
-      // Parse vertices of each triangle
-      bNextBlock = false;
-      bEnd = false;
-
-      // Go until the block end
-      do {
-        bNextBlock = false;
-
-        // Get material name
-        Str_t strMaterial = (*it)(Tkn_t::TKN_IDENTIFIER).GetValue().ToString();
-        ++it;
-
-        // New polygon
-        CPolygon pol(strMaterial);
-
-        // Go through three vertices
-        for (s32 iVtx = 0; iVtx < 3; ++iVtx) {
-          // Get parent bone index
-          s32 iParentBone = (s32)(*it)(Tkn_t::TKN_VALUE).GetValue().ToS64();
-
-          // Invalid bone
-          if (iParentBone < 0 || iParentBone >= smd.iBones) {
-            CTokenException::Throw(it->GetTokenPos(), "Bone index %d is out of bounds [0, %d]", iParentBone, smd.iBones - 1);
-          }
-
-          // New vertex
-          CVertex vertex;
-          vertex.iBone = iParentBone;
-
-          s32 iVertexIndex = (s32)smd.aVertices.size();
-        
-          // Go to the positions
-          ++it;
-
-          // Parse XYZ vertex positions and normals
-          for (s32 iPos = 0; iPos < 6; ++iPos) {
-            iNegative = 1;
-
-            // Skip unary operators
-            if (it->GetType() == Tkn_t::TKN_SUB) {
-              iNegative = -1;
-              ++it;
-            }
-
-            if (iPos < 3) {
-              vertex.vPos[iPos] = GetNumber<f64>(it->GetValue()) * (f64)iNegative;
-            } else {
-              vertex.vNormal[iPos - 3] = GetNumber<f64>(it->GetValue()) * (f64)iNegative;
-            }
-
-            ++it;
-          }
-
-          // Parse UV coordinates
-          for (s32 iUV = 0; iUV < 2; ++iUV) {
-            iNegative = 1;
-
-            // Skip unary operators
-            if (it->GetType() == Tkn_t::TKN_SUB) {
-              iNegative = -1;
-              ++it;
-            }
-
-            vertex.vUV[iUV] = GetNumber<f64>(it->GetValue()) * (f64)iNegative;
-            ++it;
-          }
-
-          // Get amount of weights for this vertex
-          s32 iWeights = (s32)(it++)->GetValue().ToS64();
-
-          for (s32 iWeight = 0; iWeight < iWeights; ++iWeight) {
-            // Get this weight's bone
-            s32 iWeightBone = (s32)(*it)(Tkn_t::TKN_VALUE).GetValue().ToS64();
-            ++it;
-
-            // Get weight
-            f64 fWeight = GetNumber<f64>(it->GetValue());
-            ++it;
-
-            // Add weight to the vertex
-            smd.aSkeleton[iWeightBone].aWeights.push_back(CWeight(iVertexIndex, fWeight));
-          }
-
-          // Add vertex
-          smd.aVertices.push_back(vertex);
-          pol.aiVertices.push_back(iVertexIndex);
-        }
-          
-        // Add new surface if it doesn't exist yet
-        if (smd.aSurfaces.find(strMaterial) == smd.aSurfaces.end()) {
-          smd.aSurfaces[strMaterial] = CPolygons();
-        }
 
-        // Add polygon to the surface
-        smd.aSurfaces[strMaterial].push_back(pol);
+  // Go again if there's another frame (the skeleton only needs the first one)
+  } while (!smd.bOnlySkeleton && scan.SkipWord("time"));
+
+  // Skip block end
+  if (!smd.bOnlySkeleton) {
+    scan.ExpectWord("end");
+  }
+
+  // Frames between the keyed ones are filled in when the animation is written
+  smd.iFrames = iLastFrame + 1;
+
+  Console() << "Added " << ctTimes << " animation frames...\n";
+
+  // Store animation keys bone by bone
+  if (!smd.spill.IsUsed()) {
+    SortKeysIntoTracks(keys, smd.iBones, smd.iFrames, smd.aTracks);
+
+  // Keep only the first frame in memory
+  } else {
+    CAnimTracks block;
+    SortKeysIntoTracks(keys, smd.iBones, smd.iFrames, block);
+    smd.spill.AddBlock(smd.strFilePath + ".spill", block);
+
+    SortKeysIntoTracks(keysFirst, smd.iBones, 1, smd.aTracks);
 
-        // Next triangle or block end
-        if (ExpectKeyword("end", false)) {
-          bEnd = true;
+    Console() << "Moved " << smd.iFrames << " animation frames into a scratch file ("
+      << (f64)smd.spill.file.GetSize() / (1024.0 * 1024.0) << " MB)...\n";
+  }
+
+  // Free parsed keys before the rest of the file
+  AddMemoryStructure("Parsed animation keys", GetArrayBytes(keys.aiBones) + GetArrayBytes(keys.aiFrames) + GetArrayBytes(keys.aValues));
+
+  Ints_t().swap(keys.aiBones);
+  Ints_t().swap(keys.aiFrames);
+  std::vector<f64>().swap(keys.aValues);
+
+  if (smd.iFrames > 0) {
+    Console() << '\n';
+  }
 
-        } else if (it->GetType() == Tkn_t::TKN_IDENTIFIER) {
-          bNextBlock = true;
+  // Only build the skeleton
+  if (smd.bOnlySkeleton) {
+    return;
+  }
+
+  // Expect triangles block, if it's present
+  if (!smd.bVtxAnim && scan.SkipWord("triangles")) {
+    smd.bAnimFile = false;
+
+    // Go until the block end
+    while (!scan.SkipWord("end")) {
+      if (scan.AtEnd()) {
+        scan.Throw("Expected a block end or material name of another polygon after the mesh triangle");
+      }
 
-        } else {
-          throw CTokenException(it->GetTokenPos(), "Expected a block end or material name of another polygon after the mesh triangle");
+      // Get material name from the whole line
+      Str_t strMaterial = scan.ReadLine();
+
+      if (strMaterial.size() > 1 && strMaterial[0] == '"' && strMaterial[strMaterial.size() - 1] == '"') {
+        strMaterial = strMaterial.substr(1, strMaterial.size() - 2);
+      }
+
+      // New polygon in the surface
+      CPolygons &aPolygons = smd.aSurfaces[strMaterial];
+      aPolygons.push_back(CPolygon(strMaterial));
+      CPolygon &pol = aPolygons.back();
+
+      // Go through three vertices
+      for (s32 iVtx = 0; iVtx < 3; ++iVtx) {
+        // New vertex with a parent bone
+        CVertex vertex;
+        vertex.iBone = ReadBoneIndex(scan, smd);
+
+        const s32 iVertexIndex = (s32)smd.aVertices.size();
+
+        // Parse XYZ vertex positions and normals
+        vertex.vPos[0] = scan.ReadFloat();
+        vertex.vPos[1] = scan.ReadFloat();
+        vertex.vPos[2] = scan.ReadFloat();
+        vertex.vNormal[0] = scan.ReadFloat();
+        vertex.vNormal[1] = scan.ReadFloat();
+        vertex.vNormal[2] = scan.ReadFloat();
+
+        // Parse UV coordinates
+        vertex.vUV[0] = scan.ReadFloat();
+        vertex.vUV[1] = scan.ReadFloat();
+
+        // Get amount of weights for this vertex, if there are any
+        const s32 iWeights = (scan.AtLineEnd() ? 0 : (s32)scan.ReadInt());
+        vertex.iFirstWeight = (s32)smd.aVertexWeights.size();
+
+        for (s32 iWeight = 0; iWeight < iWeights; ++iWeight) {
+          // Get this weight's bone and its weight
+          CVertexWeight weight;
+          weight.iBone = ReadBoneIndex(scan, smd);
+          weight.fWeight = scan.ReadFloat();
+
+          smd.aVertexWeights.push_back(weight);
         }
 
-      // Go again if there's another frame
-      } while (bNextBlock && !bEnd);
+        vertex.ctWeights = (s32)smd.aVertexWeights.size() - vertex.iFirstWeight;
 
-    // Always expect vertex animation block if it's required
-    } else if (smd.bVtxAnim) {
-      if (ExpectKeyword("vertexanimation", false)) {
-        // TODO: Implement vertex animations
-        
-      } else {
-        throw CTokenException(it->GetTokenPos(), "Expected 'vertexanimation' block");
+        // Add vertex
+        smd.aVertices.push_back(vertex);
+        pol.aiVertices.push_back(iVertexIndex);
       }
     }
 
-  // Errors
-  } catch (CBadAnyCastException &ex) {
-    (void)ex;
-    throw CTokenException(it->GetTokenPos(), "Wrong value type");
+    // Merge shared triangle corners
+    if (smd.fWeldEpsilon >= 0.0) {
+      extern void WeldVertices(SmdStructure &smd);
+      WeldVertices(smd);
+    }
 
-  } catch (CException &ex) {
-    throw ex;
+    // Reorder triangles and vertices for the vertex cache
+    if (smd.bVertexCache) {
+      extern void OptimizeVertexCache(SmdStructure &smd);
+      OptimizeVertexCache(smd);
+    }
+
+    extern void AssignBoneWeights(SmdStructure &smd);
+    AssignBoneWeights(smd);
+
+  // Always expect vertex animation block if it's required
+  } else if (smd.bVtxAnim) {
+    if (scan.SkipWord("vertexanimation")) {
+      // TODO: Implement vertex animations
+
+    } else {
+      scan.Throw("Expected 'vertexanimation' block");
+    }
   }
 };
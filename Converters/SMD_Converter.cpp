@@ -20,93 +20,65 @@
  */
 
 #include "Main.h"
+#include "Manifest.h"
 #include "SMD_Structures.h"
 
-// Tokenize SMD file contents
-static void TokenizeSMD(CTokenList &aTokens, const Str_t &str, bool bVtxAnimation) {
-  CParserData data(str);
-    
-  while (data.CanParse()) {
-    switch (*data.pchCur) {
-      // Skip spaces
-      case ' ': case '\t': case '\r': break;
-      
-      // Line break
-      case '\n': data.CountLine(); break;
-
-      // End-line comments
-      case '#': case ';': {
-        // Skip until the line break
-        while (!data.AtEnd()) {
-          data.SetToCurrent();
-
-          if (*data.pchCur == '\r'
-           || *data.pchCur == '\n') {
-            break;
-          }
-
-          data.Advance(1);
-        }
-      } break;
-
-      default: {
-        // Special tokenizers
-        bool bTokenized = data.ParseComments(aTokens, false)
-          || data.ParseIdentifiers(aTokens)
-          || data.ParseOperators(aTokens)
-          || data.ParseNumbers(aTokens)
-          || data.ParseCharSequences(aTokens, '"', '\'');
-
-        if (!bTokenized) {
-          throw CTokenException(data.pos, "Invalid character for tokenization");
-        }
-      }
-    }
-  }
-};
+#include "Common/FileSystem.h"
+#include "Common/InputFile.h"
+#include "Common/MemoryStats.h"
+#include "Common/Trace.h"
 
-// Current SMD file
-Str_t _strFilePath = "";
-Str_t _strFileName = "";
+// Read and build SMD file
+extern void ReadSMD(const CPath &strFile, SmdStructure &smd) {
+  TRACE_SCOPE_DETAIL("ReadSMD", strFile);
+
+  CInputFile file;
+  file.Open(strFile);
+
+  extern void BuildSMD(const c8 *pchData, size_t iSize, SmdStructure &smd);
+  BuildSMD(file.GetData(), file.GetSize(), smd);
+};
 
 #define ANIM_BASE_SMD Str_t("!Base.smd")
 #define BASE_SMD_ARGS Str_t("!Converter.txt")
 #define ANIM_INFOS Str_t("!AnimInfo.json")
 
-extern void ConvertSourceMesh(const CPath &strFile, bool bVtxAnimation, Strings_t &aArguments) {
-  // [Cecil] NOTE: Not yet implemented
-  if (bVtxAnimation) {
-    CMessageException::Throw("VTA support is not yet implemented, try SMD with skeletal animation");
+// Append converter arguments from the file near the SMD file
+extern bool ReadConverterArguments(const CPath &strFile, Strings_t &aArguments) {
+  Str_t strArgs;
+
+  if (!ReadTextFileIfPossible(GetNearbyFile(strFile, BASE_SMD_ARGS), strArgs)) {
+    return false;
   }
 
-  _strFilePath = strFile.RemoveExt();
-  _strFileName = strFile.GetFileName();
+  Strings_t aFileArgs;
+  CharSplit<Str_t>(strArgs, ' ', aFileArgs);
+
+  for (size_t iArg = 0; iArg < aFileArgs.size(); ++iArg) {
+    Str_t strArg = aFileArgs[iArg];
 
-  {
-    // Override converter arguments
-    Str_t strArgs;
+    // Trim line breaks and tabs around the argument
+    const size_t iFirst = strArg.find_first_not_of(" \t\r\n");
 
-    if (ReadTextFileIfPossible(BASE_SMD_ARGS, strArgs)) {
-      std::cout << "Read converted arguments from " << BASE_SMD_ARGS << "...\n";
-      CharSplit<Str_t>(strArgs, ' ', aArguments);
+    if (iFirst == Str_t::npos) {
+      continue;
     }
-  }
 
-  CTokenList aTokens;
-  {
-    // Read and tokenize SMD data
-    Str_t strData = ReadTextFile(strFile);
-    TokenizeSMD(aTokens, strData, bVtxAnimation);
+    strArg = strArg.substr(iFirst, strArg.find_last_not_of(" \t\r\n") - iFirst + 1);
+
+    // Base model is specified relative to the arguments file
+    if (!aArguments.empty() && aArguments.back() == "-base") {
+      strArg = GetNearbyFile(strFile, strArg);
+    }
+
+    aArguments.push_back(strArg);
   }
-  
-  // Current SMD file structure
-  SmdStructure smd;
-  smd.bVtxAnim = bVtxAnimation;
 
-  // Conversion options
-  SmdOptions opts;
+  return true;
+};
 
-  // Set from arguments
+// Set converter options from arguments
+extern void ParseSmdOptions(const Strings_t &aArguments, SmdOptions &opts) {
   Strings_t::const_iterator itOption;
   const Strings_t::const_iterator itArgEnd = aArguments.end();
 
@@ -162,8 +134,273 @@ extern void ConvertSourceMesh(const CPath &strFile, bool bVtxAnimation, Strings_
       }
 
       opts.strBaseSMD = *itOption;
+
+    // Directory for caching parsed base models
+    } else if (strOption == "-basecache") {
+      ++itOption;
+
+      // No directory specified
+      if (itOption == itArgEnd) {
+        CMessageException::Throw("Please specify cache directory after the 'basecache' argument");
+      }
+
+      opts.strBaseCache = *itOption;
+
+    // Cache built SMD files next to them
+    } else if (strOption == "-smdcache") {
+      opts.bSmdCache = true;
+
+    // Cache built SMD files in a directory
+    } else if (strOption == "-smdcachedir") {
+      ++itOption;
+
+      // No directory specified
+      if (itOption == itArgEnd) {
+        CMessageException::Throw("Please specify cache directory after the 'smdcachedir' argument");
+      }
+
+      opts.bSmdCache = true;
+      opts.strSmdCache = *itOption;
+
+    // Tolerance for merging mesh vertices
+    } else if (strOption == "-weld") {
+      ++itOption;
+
+      // No tolerance specified
+      if (itOption == itArgEnd) {
+        CMessageException::Throw("Please specify vertex welding tolerance after the 'weld' argument");
+      }
+
+      opts.fWeldEpsilon = fabs(atof(itOption->c_str()));
+
+    // Keep every triangle corner as a separate vertex
+    } else if (strOption == "-noweld") {
+      opts.fWeldEpsilon = -1.0;
+
+    // Reorder mesh triangles and vertices for the vertex cache
+    } else if (strOption == "-vcache") {
+      opts.bVertexCache = true;
+
+    // Remove animation frames that can be interpolated
+    } else if (strOption == "-reduce") {
+      ++itOption;
+
+      // No tolerance specified
+      if (itOption == itArgEnd) {
+        CMessageException::Throw("Please specify position tolerance after the 'reduce' argument");
+      }
+
+      opts.fReducePos = fabs(atof(itOption->c_str()));
+
+    // Rotation tolerance for removing animation frames
+    } else if (strOption == "-reducerot") {
+      ++itOption;
+
+      // No tolerance specified
+      if (itOption == itArgEnd) {
+        CMessageException::Throw("Please specify rotation tolerance in degrees after the 'reducerot' argument");
+      }
+
+      opts.fReduceRot = fabs(atof(itOption->c_str()));
+
+    // Omit bones that don't move in animations
+    } else if (strOption == "-constbones") {
+      ++itOption;
+
+      // No tolerance specified
+      if (itOption == itArgEnd) {
+        CMessageException::Throw("Please specify placement tolerance after the 'constbones' argument");
+      }
+
+      opts.fConstEpsilon = fabs(atof(itOption->c_str()));
+
+    // Memory for animation frames before moving them into a scratch file
+    } else if (strOption == "-memlimit") {
+      ++itOption;
+
+      // No size specified
+      if (itOption == itArgEnd) {
+        CMessageException::Throw("Please specify memory limit in megabytes after the 'memlimit' argument");
+      }
+
+      const f64 fMegabytes = fabs(atof(itOption->c_str()));
+      opts.iMemoryLimit = (u64)(fMegabytes * 1024.0 * 1024.0);
+
+    // Write SE1 binary files as well
+    } else if (strOption == "-binary") {
+      opts.bBinaryFiles = true;
+
+    // Write only SE1 binary files
+    } else if (strOption == "-binaryonly") {
+      opts.bBinaryFiles = true;
+      opts.bAsciiFiles = false;
+
+    // Threads for converting bone placements
+    } else if (strOption == "-threads") {
+      ++itOption;
+
+      // No amount specified
+      if (itOption == itArgEnd) {
+        CMessageException::Throw("Please specify amount of threads after the 'threads' argument");
+      }
+
+      opts.ctThreads = atoi(itOption->c_str());
+
+      if (opts.ctThreads < 1) {
+        opts.ctThreads = 1;
+      }
+    }
+  }
+};
+
+// Get path to the base SMD model for the animation
+extern Str_t GetBaseSmdPath(const CPath &strFile, const SmdOptions &opts) {
+  // Default model near the animation
+  if (!opts.bArgSet[3] || opts.strBaseSMD == ANIM_BASE_SMD) {
+    return GetNearbyFile(strFile, ANIM_BASE_SMD);
+  }
+
+  return opts.strBaseSMD;
+};
+
+// Find info about the animation in the config near it (returns false if there's no config)
+static bool ReadAnimInfo(const CPath &strFile, CVariant &valEntry) {
+  Str_t strJSON;
+
+  if (!ReadTextFileIfPossible(GetNearbyFile(strFile, ANIM_INFOS), strJSON)) {
+    return false;
+  }
+
+  // Build JSON object
+  CVariant valInfo;
+  ParseJSON(valInfo, nullptr, strJSON);
+
+  // Find entry about the current file
+  CValObject &oInfo = valInfo.ToObject();
+  CValObject::const_iterator it = oInfo.find(strFile.RemoveDir());
+
+  if (it != oInfo.end()) {
+    valEntry = it->second;
+  }
+
+  return true;
+};
+
+// Hash of the SMD file and everything else that affects its conversion
+static u64 GetSmdFingerprint(const CPath &strFile, const SmdOptions &opts) {
+  TRACE_SCOPE("GetSmdFingerprint");
+
+  CFingerprint fp("smd");
+  fp.AddFile(strFile);
+
+  // Resolved options, including the ones from the arguments file (animation options are resolved like in batch mode)
+  fp.AddNumber(opts.fScale);
+  fp.AddInteger(opts.bFixFaceDir);
+  fp.AddInteger(opts.bArgSet[2] ? opts.bFixAnimNorth : true);
+  fp.AddNumber(opts.fWeldEpsilon);
+  fp.AddInteger(opts.bVertexCache);
+  fp.AddNumber(opts.fReducePos);
+  fp.AddNumber(opts.fReduceRot);
+  fp.AddNumber(opts.fConstEpsilon);
+  fp.AddInteger(opts.iMemoryLimit);
+  fp.AddInteger(opts.bAsciiFiles);
+  fp.AddInteger(opts.bBinaryFiles);
+
+  // Base model of the animation
+  const Str_t strBase = GetBaseSmdPath(strFile, opts);
+  fp.AddString(GetCanonicalPath(strBase));
+  fp.AddFile(strBase);
+
+  // Only the entry about this animation matters
+  Str_t strName = "";
+  f64 fFPS = 24.0;
+  s32 iLooping = -1;
+
+  try {
+    extern void GetAnimInfo(const CVariant &valInfo, Str_t &strName, f64 &fFPS, s32 &iLooping);
+
+    CVariant valEntry;
+    ReadAnimInfo(strFile, valEntry);
+    GetAnimInfo(valEntry, strName, fFPS, iLooping);
+
+  // Broken config will cause an error only if the file turns out to be an animation
+  } catch (CException &ex) {
+    (void)ex;
+    fp.AddFile(GetNearbyFile(strFile, ANIM_INFOS));
+  }
+
+  fp.AddString(strName);
+  fp.AddNumber(fFPS);
+  fp.AddInteger((u64)(s64)iLooping);
+
+  return fp.Get();
+};
+
+// Add sizes of the built SMD file to the memory report
+static void AddSmdMemory(const SmdStructure &smd) {
+  u64 iSkeleton = GetArrayBytes(smd.aSkeleton);
+  u64 iWeights = 0;
+
+  for (size_t iBone = 0; iBone < smd.aSkeleton.size(); ++iBone) {
+    const CBoneInfo &info = smd.aSkeleton[iBone];
+    iSkeleton += info.strName.capacity();
+    iWeights += GetArrayBytes(info.aWeights);
+  }
+
+  u64 iSurfaces = 0;
+  CSurfaces::const_iterator itSurface;
+
+  for (itSurface = smd.aSurfaces.begin(); itSurface != smd.aSurfaces.end(); ++itSurface) {
+    const CPolygons &aPolygons = itSurface->second;
+    iSurfaces += itSurface->first.capacity() + GetArrayBytes(aPolygons);
+
+    for (size_t iPolygon = 0; iPolygon < aPolygons.size(); ++iPolygon) {
+      iSurfaces += aPolygons[iPolygon].strMaterial.capacity() + GetArrayBytes(aPolygons[iPolygon].aiVertices);
     }
   }
+
+  const CAnimTracks &tracks = smd.aTracks;
+
+  AddMemoryStructure("Skeleton bones", iSkeleton);
+  AddMemoryStructure("Bone weights", iWeights);
+  AddMemoryStructure("Mesh vertices", GetArrayBytes(smd.aVertices));
+  AddMemoryStructure("Mesh vertex weights", GetArrayBytes(smd.aVertexWeights));
+  AddMemoryStructure("Mesh surfaces", iSurfaces);
+  AddMemoryStructure("Track positions", GetArrayBytes(tracks.avPos));
+  AddMemoryStructure("Track rotations", GetArrayBytes(tracks.avRot));
+  AddMemoryStructure("Track matrices", GetArrayBytes(tracks.amConverted));
+  AddMemoryStructure("Track key frames", GetArrayBytes(tracks.aiFrames) + GetArrayBytes(tracks.aiFirstKey));
+};
+
+extern bool ConvertSourceMesh(const CPath &strFile, bool bVtxAnimation, Strings_t &aArguments) {
+  TRACE_SCOPE_DETAIL("ConvertSourceMesh", strFile);
+
+  // [Cecil] NOTE: Not yet implemented
+  if (bVtxAnimation) {
+    CMessageException::Throw("VTA support is not yet implemented, try SMD with skeletal animation");
+  }
+
+  // Override converter arguments
+  if (ReadConverterArguments(strFile, aArguments)) {
+    Console() << "Read converted arguments from " << BASE_SMD_ARGS << "...\n";
+  }
+
+  // Current SMD file structure
+  SmdStructure smd;
+  smd.strFilePath = strFile.RemoveExt();
+  smd.strFileName = strFile.GetFileName();
+  smd.bVtxAnim = bVtxAnimation;
+
+  // Conversion options
+  SmdOptions opts;
+
+  // Set from arguments
+  ParseSmdOptions(aArguments, opts);
+
+  // Files are already converted in parallel, which '-threads' from the arguments file cannot override
+  if (_ctBatchJobThreads > 0) {
+    opts.ctThreads = _ctBatchJobThreads;
+  }
   
   // Apply default options for the SMD converter
   #if 0
@@ -174,37 +411,70 @@ extern void ConvertSourceMesh(const CPath &strFile, bool bVtxAnimation, Strings_
     opts.SetAll(true);
   #endif
 
-  // Get scale multiplier
+  // Get scale multiplier (batch mode always picks default answers)
   if (!opts.bArgSet[0]) {
-    if (ConsoleYN("Convert Source units to Serious Engine meters?", true)) {
+    if (_bBatchMode || ConsoleYN("Convert Source units to Serious Engine meters?", true)) {
       opts.fScale = 1.0/64.0;
     }
   }
 
   // Fix facing direction
   if (!opts.bArgSet[1]) {
-    opts.bFixFaceDir = ConsoleYN("Fix facing direction?", true);
+    opts.bFixFaceDir = (_bBatchMode || ConsoleYN("Fix facing direction?", true));
+  }
+
+  Console() << '\n';
+
+  // Skip the conversion if nothing that affects it has changed since the last one
+  // Animation options are only known beforehand if they won't be asked about
+  const bool bManifest = (_bManifest && (_bBatchMode || (opts.bArgSet[2] && opts.bArgSet[3])));
+  u64 iFingerprint = 0;
+
+  if (bManifest) {
+    iFingerprint = GetSmdFingerprint(strFile, opts);
+
+    if (IsConversionUpToDate(strFile, iFingerprint)) {
+      Console() << "Converted files are up to date\n";
+      return false;
+    }
   }
 
-  std::cout << '\n';
+  // Read and build SMD file
+  smd.fWeldEpsilon = opts.fWeldEpsilon;
+  smd.bVertexCache = opts.bVertexCache;
+  smd.iMemoryLimit = opts.iMemoryLimit;
 
-  // Build SMD file
-  extern void BuildSMD(CTokenList &aTokens, SmdStructure &smd);
-  BuildSMD(aTokens, smd);
+  // Reuse the built file from the previous run
+  extern bool LoadSmdCache(const CPath &strFile, const Str_t &strCacheDir, SmdStructure &smd);
+  extern void SaveSmdCache(const CPath &strFile, const Str_t &strCacheDir, const SmdStructure &smd);
+
+  if (!opts.bSmdCache || !LoadSmdCache(strFile, opts.strSmdCache, smd)) {
+    ReadSMD(strFile, smd);
+
+    if (opts.bSmdCache) {
+      SaveSmdCache(strFile, opts.strSmdCache, smd);
+    }
+  }
   
-  std::cout << "Built skeletal " << (smd.bAnimFile ? "animation" : "mesh") << " file...\n";
+  Console() << "Built skeletal " << (smd.bAnimFile ? "animation" : "mesh") << " file...\n";
+
+  if (_bMemoryStats) {
+    AddSmdMemory(smd);
+  }
 
   // Animation SMD options
   if (smd.bAnimFile) {
     // Fix forward direction for animations
     if (!opts.bArgSet[2]) {
-      opts.bFixAnimNorth = ConsoleYN("Fix forward direction for animations from east to north?", true);
+      opts.bFixAnimNorth = (_bBatchMode || ConsoleYN("Fix forward direction for animations from east to north?", true));
     }
 
     // Retrieve default skeleton
     if (!opts.bArgSet[3]) {
-      std::cout << "Specify SMD model file that this animation is for: ";
-      std::getline(std::cin, opts.strBaseSMD);
+      if (!_bBatchMode) {
+        std::cout << "Specify SMD model file that this animation is for: ";
+        std::getline(std::cin, opts.strBaseSMD);
+      }
 
       // Set to default
       if (opts.strBaseSMD.empty()) {
@@ -212,42 +482,29 @@ extern void ConvertSourceMesh(const CPath &strFile, bool bVtxAnimation, Strings_
       }
     }
 
-    std::cout << '\n';
+    Console() << '\n';
 
     // Open config with info about animations
-    Str_t strJSON;
-    
-    if (ReadTextFileIfPossible(ANIM_INFOS, strJSON)) {
-      std::cout << "Reading infos about animations...\n";
-
-      // Build JSON object
-      CVariant valInfo;
-      ParseJSON(valInfo, nullptr, strJSON);
-
-      // Find entry about the current file
-      CValObject &oInfo = valInfo.ToObject();
-
+    if (ReadAnimInfo(strFile, opts.valAnimInfo)) {
+      Console() << "Reading infos about animations...\n";
       const Str_t strAnimFile = strFile.RemoveDir();
-      CValObject::const_iterator it = oInfo.find(strAnimFile);
-
-      // Save info in the options
-      if (it != oInfo.end()) {
-        opts.valAnimInfo = it->second;
-        std::cout << "Retrieved information about " << strAnimFile << "...\n\n";
 
+      if (opts.valAnimInfo.GetType() != CVariant::VAL_INVALID) {
+        Console() << "Retrieved information about " << strAnimFile << "...\n\n";
       } else {
-        std::cout << "No information found about " << strAnimFile << "...\n\n";
+        Console() << "No information found about " << strAnimFile << "...\n\n";
       }
     }
   }
 
   // Take default positions for bones from the external skeleton
   if (smd.bAnimFile && !opts.strBaseSMD.empty()) {
-    // Read SMD skeleton
-    Str_t strSkelData;
+    // Get parsed skeleton of the base model
+    extern const CBaseSkeleton *GetBaseSkeleton(const Str_t &strFile, const Str_t &strCacheDir);
+    const CBaseSkeleton *pBase = GetBaseSkeleton(GetBaseSmdPath(strFile, opts), opts.strBaseCache);
     
     // Couldn't open the base model file
-    if (!ReadTextFileIfPossible(opts.strBaseSMD, strSkelData)) {
+    if (pBase == nullptr) {
       // Throw exception if couldn't open the specified file
       if (opts.strBaseSMD != ANIM_BASE_SMD) {
         CMessageException::Throw("Cannot open the base SMD file (most likely doesn't exist)");
@@ -255,130 +512,78 @@ extern void ConvertSourceMesh(const CPath &strFile, bool bVtxAnimation, Strings_
 
     // Opened the base model file
     } else {
-      // Tokenize the skeleton
-      CTokenList aSkelTokens;
-      TokenizeSMD(aSkelTokens, strSkelData, false);
-    
-      // Build the skeleton
-      SmdStructure smdSkeleton;
-      smdSkeleton.bOnlySkeleton = true;
-      BuildSMD(aSkelTokens, smdSkeleton);
-
-      const CEnvelopes &skelDefault = smdSkeleton.aFrames[0].aBones;
-      CEnvelopes &skelAnim = smd.aFrames[0].aBones;
+      const CPlacements &aDefault = pBase->aPose;
+      CAnimTracks &tracks = smd.aTracks;
 
       // Mismatching bone amount
-      if (skelAnim.size() != skelDefault.size()) {
+      if ((size_t)tracks.iBones != aDefault.size()) {
         CMessageException::Throw("Base bone count of the animation differs from the bone count of the external skeleton");
       }
     
-      // Copy bone envelopes
-      for (size_t iBone = 0; iBone < skelAnim.size(); ++iBone) {
-        skelAnim[iBone].CopyPlacement(skelDefault[iBone]);
+      // Copy bone placements into the first frame
+      for (s32 iBone = 0; iBone < tracks.iBones; ++iBone) {
+        const size_t iKey = tracks.FirstKey(iBone);
+        tracks.avPos[iKey] = aDefault[iBone].vPos;
+        tracks.avRot[iKey] = aDefault[iBone].vRot;
       }
+
+      smd.bSkeletonPose = true;
     }
+
+  // Let animations reuse the skeleton of this model as their base
+  } else if (!smd.bAnimFile) {
+    smd.bSkeletonPose = true;
+
+    extern void CacheBaseSkeleton(const Str_t &strFile, const Str_t &strCacheDir, const SmdStructure &smd);
+    CacheBaseSkeleton(strFile, opts.strBaseCache, smd);
   }
 
   // Calculate proper positions for every bone
-  {
-    // First frame contains default positions of every skeleton bone
-    for (s32 iFrame = 0; iFrame < smd.iFrames; ++iFrame) {
-      CEnvelopes &aEnvelopes = smd.aFrames[iFrame].aBones;
-
-      for (size_t iEnv = 0; iEnv < aEnvelopes.size(); ++iEnv) {
-        if (!smd.aFrames[iFrame].aUsed[iEnv]) {
-          continue;
-        }
-
-        CBoneEnvelope &env = aEnvelopes[iEnv];
-        const CBoneInfo &info = *env.pInfo;
-
-        // Scale the bone
-        env.vPos *= opts.fScale;
-
-        // Resulting placement
-        Vec3D vBonePos = env.vPos;
-        Ang3D vBoneRot = env.vRot;
-
-        // Convert to matrix
-        Mat3D m3D;
-        Mat3DFromAngles(m3D, vBoneRot);
-
-        // Convert rotation angles to SE1
-        QuatD q;
-        q.FromMatrix(m3D);
-        q = QuatD(-q._w, -q._y, -q._x, -q._z); // Swap X and Y
-        q.ToMatrix(m3D);
-        
-        // Quaternion swap and negation is equal to this
-        /*Mat3D mInvert = m3D;
-        mInvert(0, 0) = m3D(1, 1);
-        mInvert(0, 1) = m3D(0, 1);
-        mInvert(0, 2) = m3D(2, 1);
-        mInvert(1, 0) = m3D(1, 0);
-        mInvert(1, 1) = m3D(0, 0);
-        mInvert(1, 2) = m3D(2, 0);
-        mInvert(2, 0) = m3D(1, 2);
-        mInvert(2, 1) = m3D(0, 2);
-        mInvert(2, 2) = m3D(2, 2);*/
-
-        // Fixed angles
-        Mat3DToAngles(m3D, vBoneRot);
-        
-        // Fix facing and forward direction for root bones
-        if (info.iParent == -1) {
-          // Axis changes correlate with RotateTrackBall angle application in the opposite order
-          if (smd.bAnimFile) {
-            // Fix facing from SMD to SE1
-            if (opts.bFixFaceDir && opts.bFixAnimNorth) {
-              // +X+Y+Z -> -Y+X+Z -> -Y+Z-X
-              SwapAxes(vBonePos, AXIS_mY, AXIS__Z, AXIS_mX);
-              vBoneRot.RotateTrackball(Ang3D(0.0, -90.0, 90.0).DegToRad());
-              
-            // Fix facing from Source to SE1
-            } else if (opts.bFixFaceDir) {
-              // +X+Y+Z -> +X+Z-Y -> -X+Z+Y
-              SwapAxes(vBonePos, AXIS_mX, AXIS__Z, AXIS__Y);
-              vBoneRot.RotateTrackball(Ang3D(180.0, -90.0, 0.0).DegToRad());
-
-            // Fix facing from SMD to Source
-            } else if (opts.bFixAnimNorth) {
-              // +X+Y -> +Y-X
-              SwapAxes(vBonePos, AXIS__Y, AXIS_mX, AXIS__Z);
-              vBoneRot.RotateTrackball(Ang3D(0.0, 0.0, -90.0).DegToRad());
-            }
-
-          } else {
-            // Fix facing from Source to SE1
-            if (opts.bFixFaceDir) {
-              // +X+Y+Z -> +X+Z-Y -> -X+Z+Y
-              SwapAxes(vBonePos, AXIS_mX, AXIS__Z, AXIS__Y);
-              vBoneRot.RotateTrackball(Ang3D(180.0, -90.0, 0.0).DegToRad());
-            }
-          }
-        }
-
-        // Make bone placement matrix
-        Mat3DFromAngles(m3D, vBoneRot);
-        Mat3DtoMat12(env.mConverted, m3D, vBonePos);
-      }
-    }
-  }
+  extern void ConvertPoses(const SmdOptions &opts, SmdStructure &smd);
+  ConvertPoses(opts, smd);
   
   extern void WriteMesh(const SmdOptions &opts, const SmdStructure &smd);
   extern void WriteSkeleton(const SmdOptions &opts, const SmdStructure &smd);
-  extern void WriteAnimation(const SmdOptions &opts, const SmdStructure &smd);
+  extern void WriteAnimation(const SmdOptions &opts, const SmdStructure &smd, const SmdAnimation &anim);
+  extern void WriteMeshBinary(const SmdOptions &opts, const SmdStructure &smd);
+  extern void WriteSkeletonBinary(const SmdOptions &opts, const SmdStructure &smd);
+  extern void WriteAnimationBinary(const SmdOptions &opts, const SmdStructure &smd, const SmdAnimation &anim);
 
   // Write mesh
   if (!smd.bAnimFile) {
-    WriteMesh(opts, smd);
+    if (opts.bAsciiFiles) WriteMesh(opts, smd);
+    if (opts.bBinaryFiles) WriteMeshBinary(opts, smd);
   }
 
   // Write skeleton
-  WriteSkeleton(opts, smd);
+  if (opts.bAsciiFiles) WriteSkeleton(opts, smd);
+  if (opts.bBinaryFiles) WriteSkeletonBinary(opts, smd);
+
+  // Select bones and frames for the animation once for both formats
+  extern void PrepareAnimation(const SmdOptions &opts, const SmdStructure &smd, SmdAnimation &anim);
+
+  SmdAnimation anim;
+  PrepareAnimation(opts, smd, anim);
 
   // Write animation
-  WriteAnimation(opts, smd);
+  if (opts.bAsciiFiles) WriteAnimation(opts, smd, anim);
+  if (opts.bBinaryFiles) WriteAnimationBinary(opts, smd, anim);
   
-  std::cout << "\nSuccessfully converted Valve SMD model into SE1 ASCII model!\n";
+  // Remember produced files for skipping the same conversion next time
+  if (bManifest) {
+    Strings_t aOutputs;
+
+    // Meshes and skeletons are only made out of models
+    if (!smd.bAnimFile && opts.bAsciiFiles) aOutputs.push_back(smd.strFilePath + ".am");
+    if (!smd.bAnimFile && opts.bBinaryFiles) aOutputs.push_back(smd.strFilePath + ".bm");
+    if (!smd.bAnimFile && opts.bAsciiFiles) aOutputs.push_back(smd.strFilePath + ".as");
+    if (!smd.bAnimFile && opts.bBinaryFiles) aOutputs.push_back(smd.strFilePath + ".bs");
+    if (opts.bAsciiFiles) aOutputs.push_back(smd.strFilePath + ".aa");
+    if (opts.bBinaryFiles) aOutputs.push_back(smd.strFilePath + ".ba");
+
+    RecordConversion(strFile, iFingerprint, aOutputs);
+  }
+
+  Console() << "\nSuccessfully converted Valve SMD model into SE1 ASCII model!\n";
+  return true;
 };
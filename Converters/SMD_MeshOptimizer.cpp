@@ -0,0 +1,615 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "SMD_Structures.h"
+
+#include "Common/Platform.h"
+#include "Common/Trace.h"
+
+#include <set>
+
+// Cell of a coordinate in the welding grid
+static s64 GetWeldCell(f64 fValue, f64 fEpsilon) {
+  // Exact bits of the value (with both zeros being the same)
+  if (fEpsilon <= 0.0) {
+    if (fValue == 0.0) {
+      return 0;
+    }
+
+    s64 iBits;
+    memcpy(&iBits, &fValue, sizeof(iBits));
+    return iBits;
+  }
+
+  return (s64)floor(fValue / fEpsilon);
+};
+
+// Hash of a welding grid cell
+static u32 HashWeldCell(s64 iX, s64 iY, s64 iZ) {
+  u64 iHash = (u64)iX * U64_C(0x9E3779B97F4A7C15);
+  iHash = (iHash ^ (iHash >> 29) ^ (u64)iY) * U64_C(0xBF58476D1CE4E5B9);
+  iHash = (iHash ^ (iHash >> 29) ^ (u64)iZ) * U64_C(0x94D049BB133111EB);
+  return (u32)(iHash ^ (iHash >> 32));
+};
+
+// Check if two values differ by no more than the epsilon
+static inline bool WeldEqual(f64 f1, f64 f2, f64 fEpsilon) {
+  return fabs(f1 - f2) <= fEpsilon;
+};
+
+// Check if two vertices can be merged
+static bool CanWeldVertices(const SmdStructure &smd, const CVertex &vtx1, const CVertex &vtx2, f64 fEpsilon) {
+  if (vtx1.iBone != vtx2.iBone || vtx1.ctWeights != vtx2.ctWeights) {
+    return false;
+  }
+
+  for (s32 i = 0; i < 3; ++i) {
+    if (!WeldEqual(vtx1.vPos[i], vtx2.vPos[i], fEpsilon) || !WeldEqual(vtx1.vNormal[i], vtx2.vNormal[i], fEpsilon)) {
+      return false;
+    }
+  }
+
+  if (!WeldEqual(vtx1.vUV[0], vtx2.vUV[0], fEpsilon) || !WeldEqual(vtx1.vUV[1], vtx2.vUV[1], fEpsilon)) {
+    return false;
+  }
+
+  // Weights are sorted by bones
+  for (s32 iWeight = 0; iWeight < vtx1.ctWeights; ++iWeight) {
+    const CVertexWeight &weight1 = smd.aVertexWeights[vtx1.iFirstWeight + iWeight];
+    const CVertexWeight &weight2 = smd.aVertexWeights[vtx2.iFirstWeight + iWeight];
+
+    if (weight1.iBone != weight2.iBone || !WeldEqual(weight1.fWeight, weight2.fWeight, fEpsilon)) {
+      return false;
+    }
+  }
+
+  return true;
+};
+
+// Check if two vertices are in the same place
+static inline bool SamePosition(const CVertex &vtx1, const CVertex &vtx2) {
+  return vtx1.vPos[0] == vtx2.vPos[0] && vtx1.vPos[1] == vtx2.vPos[1] && vtx1.vPos[2] == vtx2.vPos[2];
+};
+
+// Sort weights of each vertex by bones (keeping the order of weights for the same bone)
+static void SortVertexWeights(SmdStructure &smd) {
+  for (size_t iVtx = 0; iVtx < smd.aVertices.size(); ++iVtx) {
+    const CVertex &vtx = smd.aVertices[iVtx];
+    CVertexWeight *aWeights = (vtx.ctWeights > 0 ? &smd.aVertexWeights[vtx.iFirstWeight] : nullptr);
+
+    for (s32 iWeight = 1; iWeight < vtx.ctWeights; ++iWeight) {
+      const CVertexWeight weight = aWeights[iWeight];
+      s32 iInsert = iWeight;
+
+      for (; iInsert > 0 && aWeights[iInsert - 1].iBone > weight.iBone; --iInsert) {
+        aWeights[iInsert] = aWeights[iInsert - 1];
+      }
+
+      aWeights[iInsert] = weight;
+    }
+  }
+};
+
+// Triangle with vertex indices rotated to start from the smallest one
+struct WeldTriangle {
+  s32 aiVertices[3];
+
+  WeldTriangle(const Ints_t &aiPolygon) {
+    const s32 iFirst = (aiPolygon[1] < aiPolygon[0] ? (aiPolygon[2] < aiPolygon[1] ? 2 : 1) : (aiPolygon[2] < aiPolygon[0] ? 2 : 0));
+
+    for (s32 i = 0; i < 3; ++i) {
+      aiVertices[i] = aiPolygon[(iFirst + i) % 3];
+    }
+  };
+
+  bool operator<(const WeldTriangle &tri) const {
+    for (s32 i = 0; i < 3; ++i) {
+      if (aiVertices[i] != tri.aiVertices[i]) {
+        return aiVertices[i] < tri.aiVertices[i];
+      }
+    }
+
+    return false;
+  };
+};
+
+// Append a vertex with its weights to new lists
+static void CopyVertex(const SmdStructure &smd, s32 iVtx, CVertices &aVertices, std::vector<CVertexWeight> &aWeights) {
+  CVertex vtx = smd.aVertices[iVtx];
+  vtx.iFirstWeight = (s32)aWeights.size();
+
+  for (s32 iWeight = 0; iWeight < vtx.ctWeights; ++iWeight) {
+    aWeights.push_back(smd.aVertexWeights[smd.aVertices[iVtx].iFirstWeight + iWeight]);
+  }
+
+  aVertices.push_back(vtx);
+};
+
+// Keep only vertices that are used by polygons and the weights of these vertices
+static void RemoveUnusedVertices(SmdStructure &smd) {
+  Ints_t aiRemap(smd.aVertices.size(), -1);
+  CVertices aVertices;
+  std::vector<CVertexWeight> aWeights;
+
+  // Keep the original order of vertices
+  CSurfaces::iterator it;
+
+  for (it = smd.aSurfaces.begin(); it != smd.aSurfaces.end(); ++it) {
+    CPolygons &aPolygons = it->second;
+
+    for (size_t iPol = 0; iPol < aPolygons.size(); ++iPol) {
+      Ints_t &aiPolygon = aPolygons[iPol].aiVertices;
+
+      for (size_t iCorner = 0; iCorner < aiPolygon.size(); ++iCorner) {
+        aiRemap[aiPolygon[iCorner]] = 0;
+      }
+    }
+  }
+
+  for (size_t iVtx = 0; iVtx < smd.aVertices.size(); ++iVtx) {
+    if (aiRemap[iVtx] == -1) {
+      continue;
+    }
+
+    aiRemap[iVtx] = (s32)aVertices.size();
+
+    CopyVertex(smd, (s32)iVtx, aVertices, aWeights);
+  }
+
+  for (it = smd.aSurfaces.begin(); it != smd.aSurfaces.end(); ++it) {
+    CPolygons &aPolygons = it->second;
+
+    for (size_t iPol = 0; iPol < aPolygons.size(); ++iPol) {
+      Ints_t &aiPolygon = aPolygons[iPol].aiVertices;
+
+      for (size_t iCorner = 0; iCorner < aiPolygon.size(); ++iCorner) {
+        aiPolygon[iCorner] = aiRemap[aiPolygon[iCorner]];
+      }
+    }
+  }
+
+  smd.aVertices.swap(aVertices);
+  smd.aVertexWeights.swap(aWeights);
+};
+
+// Merge vertices with the same position, normal, texture coordinates and weights
+extern void WeldVertices(SmdStructure &smd) {
+  TRACE_SCOPE("WeldVertices");
+
+  const f64 fEpsilon = smd.fWeldEpsilon;
+  const s32 ctVertices = (s32)smd.aVertices.size();
+
+  SortVertexWeights(smd);
+
+  // Hash table of vertices that are kept, chained through the list of next vertices in the same bucket
+  u32 ctBuckets = 1024;
+
+  while (ctBuckets < (u32)ctVertices * 2) {
+    ctBuckets *= 2;
+  }
+
+  Ints_t aiBuckets(ctBuckets, -1);
+  Ints_t aiNext(ctVertices, -1);
+  Ints_t aiRemap(ctVertices, -1);
+
+  // Vertices within the epsilon may be in neighboring cells
+  const s64 iReach = (fEpsilon > 0.0 ? 1 : 0);
+
+  for (s32 iVtx = 0; iVtx < ctVertices; ++iVtx) {
+    const CVertex &vtx = smd.aVertices[iVtx];
+
+    const s64 iX = GetWeldCell(vtx.vPos[0], fEpsilon);
+    const s64 iY = GetWeldCell(vtx.vPos[1], fEpsilon);
+    const s64 iZ = GetWeldCell(vtx.vPos[2], fEpsilon);
+
+    // Find the same vertex among the ones before it
+    for (s64 iCellX = iX - iReach; iCellX <= iX + iReach && aiRemap[iVtx] == -1; ++iCellX) {
+      for (s64 iCellY = iY - iReach; iCellY <= iY + iReach && aiRemap[iVtx] == -1; ++iCellY) {
+        for (s64 iCellZ = iZ - iReach; iCellZ <= iZ + iReach && aiRemap[iVtx] == -1; ++iCellZ) {
+          s32 iOther = aiBuckets[HashWeldCell(iCellX, iCellY, iCellZ) & (ctBuckets - 1)];
+
+          for (; iOther != -1; iOther = aiNext[iOther]) {
+            if (CanWeldVertices(smd, smd.aVertices[iOther], vtx, fEpsilon)) {
+              aiRemap[iVtx] = iOther;
+              break;
+            }
+          }
+        }
+      }
+    }
+
+    // Keep a new vertex
+    if (aiRemap[iVtx] == -1) {
+      aiRemap[iVtx] = iVtx;
+
+      s32 &iBucket = aiBuckets[HashWeldCell(iX, iY, iZ) & (ctBuckets - 1)];
+      aiNext[iVtx] = iBucket;
+      iBucket = iVtx;
+    }
+  }
+
+  // Remap triangles and drop the ones that don't have any area or are repeated
+  s32 ctDegenerate = 0;
+  s32 ctDuplicate = 0;
+  s32 ctTriangles = 0;
+
+  CSurfaces::iterator it;
+
+  for (it = smd.aSurfaces.begin(); it != smd.aSurfaces.end(); ++it) {
+    CPolygons &aPolygons = it->second;
+    std::set<WeldTriangle> setTriangles;
+    size_t iKept = 0;
+
+    for (size_t iPol = 0; iPol < aPolygons.size(); ++iPol) {
+      Ints_t &aiPolygon = aPolygons[iPol].aiVertices;
+
+      for (s32 iCorner = 0; iCorner < 3; ++iCorner) {
+        aiPolygon[iCorner] = aiRemap[aiPolygon[iCorner]];
+      }
+
+      // Corners in the same place
+      const CVertex &vtx0 = smd.aVertices[aiPolygon[0]];
+      const CVertex &vtx1 = smd.aVertices[aiPolygon[1]];
+      const CVertex &vtx2 = smd.aVertices[aiPolygon[2]];
+
+      if (SamePosition(vtx0, vtx1) || SamePosition(vtx1, vtx2) || SamePosition(vtx2, vtx0)) {
+        ++ctDegenerate;
+        continue;
+      }
+
+      // Same triangle facing the same way
+      if (!setTriangles.insert(WeldTriangle(aiPolygon)).second) {
+        ++ctDuplicate;
+        continue;
+      }
+
+      if (iKept != iPol) {
+        aPolygons[iKept] = aPolygons[iPol];
+      }
+
+      ++iKept;
+    }
+
+    aPolygons.erase(aPolygons.begin() + iKept, aPolygons.end());
+    ctTriangles += (s32)iKept;
+  }
+
+  RemoveUnusedVertices(smd);
+
+  Console() << "Welded " << ctVertices << " vertices into " << smd.aVertices.size() << " and kept " << ctTriangles
+    << " triangles (" << ctDegenerate << " degenerate and " << ctDuplicate << " duplicate removed)...\n";
+};
+
+// Size of the simulated vertex cache for measuring its efficiency
+#define VCACHE_FIFO_SIZE 32
+
+// Size of the modeled vertex cache for ordering triangles
+#define VCACHE_LRU_SIZE 32
+
+// Average amount of vertex cache misses per triangle in all surfaces
+static f64 MeasureACMR(const SmdStructure &smd) {
+  Ints_t aiCacheTime(smd.aVertices.size(), -VCACHE_FIFO_SIZE - 1);
+  s32 ctMisses = 0;
+  s32 ctTriangles = 0;
+
+  CSurfaces::const_iterator it;
+
+  for (it = smd.aSurfaces.begin(); it != smd.aSurfaces.end(); ++it) {
+    const CPolygons &aPolygons = it->second;
+
+    // Every surface starts with an empty cache
+    s32 iTime = 0;
+    Ints_t aiSurface;
+
+    for (size_t iPol = 0; iPol < aPolygons.size(); ++iPol) {
+      for (s32 iCorner = 0; iCorner < 3; ++iCorner) {
+        const s32 iVtx = aPolygons[iPol].aiVertices[iCorner];
+
+        // Vertex has left the FIFO cache
+        if (iTime - aiCacheTime[iVtx] > VCACHE_FIFO_SIZE) {
+          aiCacheTime[iVtx] = iTime++;
+          aiSurface.push_back(iVtx);
+          ++ctMisses;
+        }
+      }
+    }
+
+    for (size_t iUsed = 0; iUsed < aiSurface.size(); ++iUsed) {
+      aiCacheTime[aiSurface[iUsed]] = -VCACHE_FIFO_SIZE - 1;
+    }
+
+    ctTriangles += (s32)aPolygons.size();
+  }
+
+  return (ctTriangles > 0 ? (f64)ctMisses / ctTriangles : 0.0);
+};
+
+// Vertex state while ordering triangles
+struct VCacheVertex {
+  s32 iCachePos;     // Position in the modeled cache (-1 if not there)
+  s32 ctRemaining;   // Triangles that haven't been added yet
+  s32 iFirstTri;     // Range in the list of adjacent triangles
+  f32 fScore;
+};
+
+// Score of a vertex for being used next (Forsyth's linear-speed vertex cache optimization)
+static f32 GetVertexScore(const VCacheVertex &vtx) {
+  // Not needed anymore
+  if (vtx.ctRemaining == 0) {
+    return -1.0f;
+  }
+
+  f32 fScore = 0.0f;
+
+  if (vtx.iCachePos >= 0) {
+    // Vertices of the last triangle get a fixed score to avoid reusing them right away
+    if (vtx.iCachePos < 3) {
+      fScore = 0.75f;
+
+    } else {
+      const f32 fScale = 1.0f / (VCACHE_LRU_SIZE - 3);
+      fScore = (f32)pow(1.0f - (vtx.iCachePos - 3) * fScale, 1.5f);
+    }
+  }
+
+  // Prefer finishing vertices with few triangles left
+  return fScore + 2.0f / (f32)sqrt((f32)vtx.ctRemaining);
+};
+
+// Reorder triangles of one surface for the vertex cache
+static void OrderSurfaceTriangles(CPolygons &aPolygons, Ints_t &aiLocal) {
+  const s32 ctTriangles = (s32)aPolygons.size();
+
+  // Number vertices of this surface
+  Ints_t aiGlobal;
+  s32 iTri;
+
+  for (iTri = 0; iTri < ctTriangles; ++iTri) {
+    for (s32 iCorner = 0; iCorner < 3; ++iCorner) {
+      const s32 iVtx = aPolygons[iTri].aiVertices[iCorner];
+
+      if (aiLocal[iVtx] == -1) {
+        aiLocal[iVtx] = (s32)aiGlobal.size();
+        aiGlobal.push_back(iVtx);
+      }
+    }
+  }
+
+  const s32 ctVertices = (s32)aiGlobal.size();
+  std::vector<VCacheVertex> aVertices(ctVertices);
+  s32 iVtx;
+
+  for (iVtx = 0; iVtx < ctVertices; ++iVtx) {
+    aVertices[iVtx].iCachePos = -1;
+    aVertices[iVtx].ctRemaining = 0;
+  }
+
+  // Triangles of each vertex
+  Ints_t aiTriangles(ctTriangles * 3);
+  Ints_t aiCorners(ctTriangles * 3);
+
+  for (iTri = 0; iTri < ctTriangles; ++iTri) {
+    for (s32 iCorner = 0; iCorner < 3; ++iCorner) {
+      aiCorners[iTri * 3 + iCorner] = aiLocal[aPolygons[iTri].aiVertices[iCorner]];
+      aVertices[aiCorners[iTri * 3 + iCorner]].ctRemaining++;
+    }
+  }
+
+  s32 iOffset = 0;
+
+  for (iVtx = 0; iVtx < ctVertices; ++iVtx) {
+    aVertices[iVtx].iFirstTri = iOffset;
+    iOffset += aVertices[iVtx].ctRemaining;
+    aVertices[iVtx].ctRemaining = 0;
+  }
+
+  for (iTri = 0; iTri < ctTriangles * 3; ++iTri) {
+    VCacheVertex &vtx = aVertices[aiCorners[iTri]];
+    aiTriangles[vtx.iFirstTri + vtx.ctRemaining++] = iTri / 3;
+  }
+
+  for (iVtx = 0; iVtx < ctVertices; ++iVtx) {
+    aVertices[iVtx].fScore = GetVertexScore(aVertices[iVtx]);
+  }
+
+  // Triangle scores
+  std::vector<f32> afTriScores(ctTriangles);
+  Bits_t abAdded(ctTriangles, false);
+
+  for (iTri = 0; iTri < ctTriangles; ++iTri) {
+    afTriScores[iTri] = aVertices[aiCorners[iTri * 3]].fScore + aVertices[aiCorners[iTri * 3 + 1]].fScore + aVertices[aiCorners[iTri * 3 + 2]].fScore;
+  }
+
+  // Modeled cache with room for vertices of a new triangle
+  Ints_t aiCache;
+  aiCache.reserve(VCACHE_LRU_SIZE + 3);
+
+  CPolygons aOrdered;
+  aOrdered.reserve(ctTriangles);
+
+  s32 iBestTri = -1;
+  s32 iScanFrom = 0;
+
+  while ((s32)aOrdered.size() < ctTriangles) {
+    // Look through all remaining triangles if there are no candidates in the cache
+    if (iBestTri == -1) {
+      f32 fBest = -1.0f;
+
+      for (; iScanFrom < ctTriangles && abAdded[iScanFrom]; ++iScanFrom);
+
+      for (iTri = iScanFrom; iTri < ctTriangles; ++iTri) {
+        if (!abAdded[iTri] && afTriScores[iTri] > fBest) {
+          fBest = afTriScores[iTri];
+          iBestTri = iTri;
+        }
+      }
+    }
+
+    // Add the triangle
+    abAdded[iBestTri] = true;
+    aOrdered.push_back(aPolygons[iBestTri]);
+
+    Ints_t aiNewCache;
+    aiNewCache.reserve(VCACHE_LRU_SIZE + 3);
+
+    s32 iCorner;
+
+    for (iCorner = 0; iCorner < 3; ++iCorner) {
+      const s32 iCornerVtx = aiCorners[iBestTri * 3 + iCorner];
+      VCacheVertex &vtx = aVertices[iCornerVtx];
+
+      // Remove the triangle from the vertex
+      s32 *piTriangles = &aiTriangles[vtx.iFirstTri];
+
+      for (s32 iAdj = 0; iAdj < vtx.ctRemaining; ++iAdj) {
+        if (piTriangles[iAdj] == iBestTri) {
+          piTriangles[iAdj] = piTriangles[--vtx.ctRemaining];
+          break;
+        }
+      }
+
+      aiNewCache.push_back(iCornerVtx);
+    }
+
+    // Move the rest of the cache behind vertices of the triangle
+    for (size_t iCached = 0; iCached < aiCache.size(); ++iCached) {
+      const s32 iCachedVtx = aiCache[iCached];
+
+      if (iCachedVtx != aiNewCache[0] && iCachedVtx != aiNewCache[1] && iCachedVtx != aiNewCache[2]) {
+        aiNewCache.push_back(iCachedVtx);
+      }
+    }
+
+    // Update scores of the cached vertices and their triangles
+    for (size_t iCached = 0; iCached < aiNewCache.size(); ++iCached) {
+      VCacheVertex &vtx = aVertices[aiNewCache[iCached]];
+      vtx.iCachePos = (iCached < VCACHE_LRU_SIZE ? (s32)iCached : -1);
+
+      const f32 fOldScore = vtx.fScore;
+      vtx.fScore = GetVertexScore(vtx);
+
+      for (s32 iAdj = 0; iAdj < vtx.ctRemaining; ++iAdj) {
+        afTriScores[aiTriangles[vtx.iFirstTri + iAdj]] += vtx.fScore - fOldScore;
+      }
+    }
+
+    if (aiNewCache.size() > VCACHE_LRU_SIZE) {
+      aiNewCache.resize(VCACHE_LRU_SIZE);
+    }
+
+    aiCache.swap(aiNewCache);
+
+    // Pick the best triangle around the cached vertices
+    iBestTri = -1;
+    f32 fBest = -1.0f;
+
+    for (size_t iCached = 0; iCached < aiCache.size(); ++iCached) {
+      const VCacheVertex &vtx = aVertices[aiCache[iCached]];
+
+      for (s32 iAdj = 0; iAdj < vtx.ctRemaining; ++iAdj) {
+        const s32 iAdjTri = aiTriangles[vtx.iFirstTri + iAdj];
+
+        if (afTriScores[iAdjTri] > fBest) {
+          fBest = afTriScores[iAdjTri];
+          iBestTri = iAdjTri;
+        }
+      }
+    }
+  }
+
+  aPolygons.swap(aOrdered);
+
+  // Clear vertex numbers for the next surface
+  for (iVtx = 0; iVtx < ctVertices; ++iVtx) {
+    aiLocal[aiGlobal[iVtx]] = -1;
+  }
+};
+
+// Reorder triangles for the vertex cache and vertices in the order of their first use
+extern void OptimizeVertexCache(SmdStructure &smd) {
+  TRACE_SCOPE("OptimizeVertexCache");
+
+  const f64 fBefore = MeasureACMR(smd);
+
+  // Reorder triangles within each surface
+  Ints_t aiLocal(smd.aVertices.size(), -1);
+  CSurfaces::iterator it;
+
+  for (it = smd.aSurfaces.begin(); it != smd.aSurfaces.end(); ++it) {
+    OrderSurfaceTriangles(it->second, aiLocal);
+  }
+
+  // Number vertices in the order they are first used by the triangles
+  Ints_t &aiRemap = aiLocal;
+  CVertices aVertices;
+  std::vector<CVertexWeight> aWeights;
+
+  aVertices.reserve(smd.aVertices.size());
+  aWeights.reserve(smd.aVertexWeights.size());
+
+  for (it = smd.aSurfaces.begin(); it != smd.aSurfaces.end(); ++it) {
+    CPolygons &aPolygons = it->second;
+
+    for (size_t iPol = 0; iPol < aPolygons.size(); ++iPol) {
+      Ints_t &aiPolygon = aPolygons[iPol].aiVertices;
+
+      for (s32 iCorner = 0; iCorner < 3; ++iCorner) {
+        s32 &iNew = aiRemap[aiPolygon[iCorner]];
+
+        if (iNew == -1) {
+          iNew = (s32)aVertices.size();
+
+          CopyVertex(smd, aiPolygon[iCorner], aVertices, aWeights);
+        }
+
+        aiPolygon[iCorner] = iNew;
+      }
+    }
+  }
+
+  // Keep vertices that aren't used by any triangle at the end
+  for (size_t iVtx = 0; iVtx < smd.aVertices.size(); ++iVtx) {
+    if (aiRemap[iVtx] == -1) {
+      CopyVertex(smd, (s32)iVtx, aVertices, aWeights);
+    }
+  }
+
+  smd.aVertices.swap(aVertices);
+  smd.aVertexWeights.swap(aWeights);
+
+  Console() << "Optimized vertex cache: ACMR " << fBefore << " -> " << MeasureACMR(smd)
+    << " (" << VCACHE_FIFO_SIZE << "-entry FIFO)...\n";
+};
+
+// Add vertex weights to the bones
+extern void AssignBoneWeights(SmdStructure &smd) {
+  TRACE_SCOPE("AssignBoneWeights");
+
+  for (s32 iVtx = 0; iVtx < (s32)smd.aVertices.size(); ++iVtx) {
+    const CVertex &vtx = smd.aVertices[iVtx];
+
+    for (s32 iWeight = 0; iWeight < vtx.ctWeights; ++iWeight) {
+      const CVertexWeight &weight = smd.aVertexWeights[vtx.iFirstWeight + iWeight];
+      smd.aSkeleton[weight.iBone].aWeights.push_back(CWeight(iVtx, weight.fWeight));
+    }
+  }
+};
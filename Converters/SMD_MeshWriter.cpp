@@ -21,15 +21,60 @@
 
 #include "Main.h"
 #include "SMD_Structures.h"
+#include "SE1_Binary.h"
+
+#include "Common/OutputFile.h"
+#include "Common/Trace.h"
+
+// Vertex position in SE1 space
+static inline Vec3D GetVertexPosition(const SmdOptions &opts, const CVertex &vertex) {
+  Vec3D vPos = vertex.vPos;
+
+  // Scale the position
+  vPos *= opts.fScale;
+
+  // Proper placement
+  if (opts.bFixFaceDir) {
+    SwapAxes(vPos, AXIS_mX, AXIS__Z, AXIS__Y);
+  }
+
+  return vPos;
+};
+
+// Vertex normal in SE1 space
+static inline Vec3D GetVertexNormal(const SmdOptions &opts, const CVertex &vertex) {
+  Vec3D vNormal = vertex.vNormal;
+
+  // Proper placement
+  if (opts.bFixFaceDir) {
+    SwapAxes(vNormal, AXIS_mX, AXIS__Z, AXIS__Y);
+  }
+
+  return vNormal;
+};
 
 // Write SMD mesh in SE1 ASCII format
 extern void WriteMesh(const SmdOptions &opts, const SmdStructure &smd) {
-#if !_DEV_STL_IO
-  CFileDevice fileD((_strFilePath + ".am").c_str());
-  CStringStream file(&fileD, IReadWriteDevice::OM_WRITEONLY);
-#else
-  FileOut_t file((_strFilePath + ".am").c_str());
-#endif
+  TRACE_SCOPE("WriteMesh");
+
+  // Longest possible text of the mesh
+  const size_t iNumber = MaxFloatTextLength(_iFloatDigits);
+  size_t iExpectedSize = 1024 + smd.strFileName.size() + smd.aVertices.size() * (8 * iNumber + 24);
+
+  std::map<Str_t, CPolygons>::const_iterator it;
+
+  for (it = smd.aSurfaces.begin(); it != smd.aSurfaces.end(); ++it) {
+    iExpectedSize += it->first.size() + 64 + it->second.size() * 42;
+  }
+
+  for (s32 iWeightBone = 0; iWeightBone < smd.iBones; ++iWeightBone) {
+    const CBoneInfo &bone = smd.aSkeleton[iWeightBone];
+    iExpectedSize += bone.strName.size() + 64 + bone.aWeights.size() * (iNumber + 24);
+  }
+
+  COutputFile file;
+  file.Open(smd.strFilePath + ".am");
+  file.Reserve(iExpectedSize);
 
   file << "SE_MESH 0.1;\n\n";
     
@@ -37,17 +82,7 @@ extern void WriteMesh(const SmdOptions &opts, const SmdStructure &smd) {
   file << "VERTICES " << smd.aVertices.size() << "\n{\n";
 
   for (size_t iVtxPos = 0; iVtxPos < smd.aVertices.size(); ++iVtxPos) {
-    const CVertex &vertex = smd.aVertices[iVtxPos];
-    Vec3D vPos = vertex.vPos;
-    
-    // Scale the position
-    vPos *= opts.fScale;
-
-    // Proper placement
-    if (opts.bFixFaceDir) {
-      SwapAxes(vPos, AXIS_mX, AXIS__Z, AXIS__Y);
-    }
-      
+    const Vec3D vPos = GetVertexPosition(opts, smd.aVertices[iVtxPos]);
     file << "  " << vPos[0] << ", " << vPos[1] << ", " << vPos[2] << ";\n";
   }
     
@@ -55,14 +90,7 @@ extern void WriteMesh(const SmdOptions &opts, const SmdStructure &smd) {
   file << "}\n\nNORMALS " << smd.aVertices.size() << "\n{\n";
 
   for (size_t iVtxNormal = 0; iVtxNormal < smd.aVertices.size(); ++iVtxNormal) {
-    const CVertex &vertex = smd.aVertices[iVtxNormal];
-    Vec3D vNormal = vertex.vNormal;
-      
-    // Proper placement
-    if (opts.bFixFaceDir) {
-      SwapAxes(vNormal, AXIS_mX, AXIS__Z, AXIS__Y);
-    }
-
+    const Vec3D vNormal = GetVertexNormal(opts, smd.aVertices[iVtxNormal]);
     file << "  " << vNormal[0] << ", " << vNormal[1] << ", " << vNormal[2] << ";\n";
   }
 
@@ -73,7 +101,7 @@ extern void WriteMesh(const SmdOptions &opts, const SmdStructure &smd) {
   file << "  {\n";
 
   // UV map name
-  file << "    NAME \"" << _strFileName << "\";\n";
+  file << "    NAME \"" << smd.strFileName << "\";\n";
 
   // Texture coordinates
   file << "    TEXCOORDS " << smd.aVertices.size() << "\n    {\n";
@@ -91,8 +119,6 @@ extern void WriteMesh(const SmdOptions &opts, const SmdStructure &smd) {
   // Surfaces
   file << "SURFACES " << smd.aSurfaces.size() << "\n{\n";
 
-  std::map<Str_t, CPolygons>::const_iterator it;
-
   for (it = smd.aSurfaces.begin(); it != smd.aSurfaces.end(); ++it) {
     file << "  {\n";
 
@@ -163,11 +189,136 @@ extern void WriteMesh(const SmdOptions &opts, const SmdStructure &smd) {
 
   file << "SE_MESH_END;";
 
-#if !_DEV_STL_IO
-  fileD.Close();
-#else
-  file.close();
-#endif
+  file.Close();
+
+  Console() << "Converted mesh...\n";
+};
+
+// Write SMD mesh in SE1 binary format (single LOD without shaders)
+extern void WriteMeshBinary(const SmdOptions &opts, const SmdStructure &smd) {
+  TRACE_SCOPE("WriteMeshBinary");
+
+  const u32 ctVertices = (u32)smd.aVertices.size();
+
+  COutputFile file;
+  file.Open(smd.strFilePath + ".bm");
+  file.Reserve(1024 + ctVertices * 40 + smd.aVertexWeights.size() * 8);
+
+  file.Write(SE1_MESH_ID, 4);
+  file.WriteLong(SE1_MESH_VERSION);
+  file.WriteLong(1); // LODs
+
+  file.WriteString(smd.strFileName + ".am"); // Source file
+  file.WriteFloat(SE1_LOD_MAX_DISTANCE);
+  file.WriteLong(0); // Flags
+
+  // Vertex positions
+  file.WriteLong(ctVertices);
+
+  for (u32 iVtxPos = 0; iVtxPos < ctVertices; ++iVtxPos) {
+    const Vec3D vPos = GetVertexPosition(opts, smd.aVertices[iVtxPos]);
+    file.WriteFloat(vPos[0]);
+    file.WriteFloat(vPos[1]);
+    file.WriteFloat(vPos[2]);
+    file.WriteLong(0); // Alignment
+  }
+
+  // Vertex normals
+  for (u32 iVtxNormal = 0; iVtxNormal < ctVertices; ++iVtxNormal) {
+    const Vec3D vNormal = GetVertexNormal(opts, smd.aVertices[iVtxNormal]);
+    file.WriteFloat(vNormal[0]);
+    file.WriteFloat(vNormal[1]);
+    file.WriteFloat(vNormal[2]);
+    file.WriteLong(0); // Alignment
+  }
+
+  // UV maps
+  file.WriteLong(1);
+  file.WriteString(smd.strFileName);
+
+  for (u32 iTexCoord = 0; iTexCoord < ctVertices; ++iTexCoord) {
+    const CVertex &vertex = smd.aVertices[iTexCoord];
+    // Mirror vertically (e.g 0.35 becomes 0.65)
+    file.WriteFloat(vertex.vUV[0]);
+    file.WriteFloat(1.0 - vertex.vUV[1]);
+  }
+
+  // Surfaces
+  file.WriteLong((u32)smd.aSurfaces.size());
+
+  std::map<Str_t, CPolygons>::const_iterator it;
+
+  for (it = smd.aSurfaces.begin(); it != smd.aSurfaces.end(); ++it) {
+    const CPolygons &aPolygons = it->second;
+
+    // Range of vertices used by the surface
+    s32 iFirstVertex = 0;
+    s32 iLastVertex = -1;
+
+    for (size_t iRangePol = 0; iRangePol < aPolygons.size(); ++iRangePol) {
+      const Ints_t &aiVertices = aPolygons[iRangePol].aiVertices;
+
+      for (s32 iCorner = 0; iCorner < 3; ++iCorner) {
+        const s32 iVertex = aiVertices[iCorner];
+
+        if (iLastVertex < iFirstVertex) {
+          iFirstVertex = iLastVertex = iVertex;
+        } else if (iVertex < iFirstVertex) {
+          iFirstVertex = iVertex;
+        } else if (iVertex > iLastVertex) {
+          iLastVertex = iVertex;
+        }
+      }
+    }
+
+    file.WriteString(it->first);
+    file.WriteLong(iFirstVertex);
+    file.WriteLong(iLastVertex - iFirstVertex + 1);
+    file.WriteLong((u32)aPolygons.size());
+
+    for (size_t iPol = 0; iPol < aPolygons.size(); ++iPol) {
+      const CPolygon &pol = aPolygons[iPol];
+      file.WriteLong(pol.aiVertices[0]);
+      file.WriteLong(pol.aiVertices[1]);
+      file.WriteLong(pol.aiVertices[2]);
+    }
+
+    file.WriteLong(0); // No shader
+  }
+
+  // Count bones with weights
+  s32 iWeights = 0;
+  s32 iBone;
+
+  for (iBone = 0; iBone < smd.iBones; ++iBone) {
+    iWeights += (smd.aSkeleton[iBone].aWeights.size() > 0);
+  }
+
+  // Vertex weights
+  file.WriteLong(iWeights);
+
+  for (iBone = 0; iBone < smd.iBones; ++iBone) {
+    const CBoneInfo &bone = smd.aSkeleton[iBone];
+
+    // No weights
+    if (bone.aWeights.size() == 0) {
+      continue;
+    }
+
+    file.WriteString(bone.strName);
+    file.WriteLong((u32)bone.aWeights.size());
+
+    for (size_t iWeight = 0; iWeight < bone.aWeights.size(); ++iWeight) {
+      const CWeight &weight = bone.aWeights[iWeight];
+      file.WriteLong(weight.iVertex);
+      file.WriteFloat(weight.fWeight);
+    }
+  }
+
+  // Morphs
+  file.WriteLong(0);
+
+  file.Close();
 
-  std::cout << "Converted mesh...\n";
+  Console() << "Converted binary mesh...\n";
 };
@@ -0,0 +1,575 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "SMD_Structures.h"
+
+#include "Common/FileSystem.h"
+#include "Common/InputFile.h"
+#include "Common/OutputFile.h"
+#include "Common/Platform.h"
+#include "Common/Trace.h"
+
+// Cache file format
+// Every value takes 8 bytes and strings are padded to 8 bytes, so the contents can be checked word by word
+#define SMD_CACHE_MAGIC   "SKASMDC"
+#define SMD_CACHE_VERSION 2
+#define SMD_CACHE_ENDIAN  0x01020304
+
+// Extension of cache files
+#define SMD_CACHE_EXT ".smdcache"
+
+// Add 8 bytes to the checksum
+static inline u64 MixCacheChecksum(u64 iHash, u64 iWord) {
+  iHash ^= iWord * U64_C(0x9E3779B97F4A7C15);
+  iHash = (iHash << 31) | (iHash >> 33);
+  return iHash * U64_C(0xBF58476D1CE4E5B9);
+};
+
+// Checksum of the cache contents
+static u64 GetCacheChecksum(const c8 *pchData, size_t iSize) {
+  u64 iHash = SMD_CACHE_ENDIAN;
+
+  for (size_t iOffset = 0; iOffset + 8 <= iSize; iOffset += 8) {
+    u64 iWord;
+    memcpy(&iWord, pchData + iOffset, 8);
+    iHash = MixCacheChecksum(iHash, iWord);
+  }
+
+  return iHash;
+};
+
+// Writer of cache contents
+class CSmdCacheWriter {
+  public:
+    COutputFile &file;
+    u64 iChecksum;
+
+  public:
+    CSmdCacheWriter(COutputFile &fileSet) : file(fileSet), iChecksum(SMD_CACHE_ENDIAN)
+    {
+    };
+
+    inline void Word(u64 iWord) {
+      file.Write((const c8 *)&iWord, 8);
+      iChecksum = MixCacheChecksum(iChecksum, iWord);
+    };
+
+    inline void Int(s64 iValue) {
+      Word((u64)iValue);
+    };
+
+    inline void Float(f64 fValue) {
+      u64 iWord;
+      memcpy(&iWord, &fValue, 8);
+      Word(iWord);
+    };
+
+    void String(const Str_t &str) {
+      Word(str.size());
+
+      for (size_t iOffset = 0; iOffset < str.size(); iOffset += 8) {
+        u64 iWord = 0;
+        memcpy(&iWord, str.c_str() + iOffset, (str.size() - iOffset < 8 ? str.size() - iOffset : 8));
+        Word(iWord);
+      }
+    };
+};
+
+// Reader of mapped cache contents (data has been checked beforehand)
+class CSmdCacheReader {
+  public:
+    const c8 *pchCur;
+    const c8 *pchEnd;
+
+  public:
+    CSmdCacheReader(const c8 *pchData, size_t iSize) : pchCur(pchData), pchEnd(pchData + iSize)
+    {
+    };
+
+    inline u64 Word(void) {
+      if (pchEnd - pchCur < 8) {
+        CMessageException::Throw("Unexpected end of the SMD cache");
+      }
+
+      u64 iWord;
+      memcpy(&iWord, pchCur, 8);
+      pchCur += 8;
+      return iWord;
+    };
+
+    inline s32 Int(void) {
+      return (s32)(s64)Word();
+    };
+
+    // Index of an element in an array of a certain size
+    inline s32 Index(size_t ctElements) {
+      const u64 iIndex = Word();
+
+      if (iIndex >= (u64)ctElements) {
+        CMessageException::Throw("Invalid element index in the SMD cache");
+      }
+
+      return (s32)iIndex;
+    };
+
+    // Amount of elements that take a certain amount of words each
+    inline size_t Count(size_t ctWords) {
+      const u64 ct = Word();
+
+      if (ct > (u64)(pchEnd - pchCur) / (8 * ctWords)) {
+        CMessageException::Throw("Invalid amount of elements in the SMD cache");
+      }
+
+      return (size_t)ct;
+    };
+
+    inline f64 Float(void) {
+      const u64 iWord = Word();
+      f64 fValue;
+      memcpy(&fValue, &iWord, 8);
+      return fValue;
+    };
+
+    Str_t String(void) {
+      const u64 iLength = Word();
+
+      if (iLength > (u64)(pchEnd - pchCur) || ((iLength + 7) & ~(u64)7) > (u64)(pchEnd - pchCur)) {
+        CMessageException::Throw("Unexpected end of the SMD cache");
+      }
+
+      const size_t iPadded = (size_t)((iLength + 7) & ~(u64)7);
+      const Str_t str(pchCur, (size_t)iLength);
+      pchCur += iPadded;
+      return str;
+    };
+};
+
+// Make a key that changes together with the file and options that affect building it
+static bool GetSmdCacheKey(const CPath &strFile, const SmdStructure &smd, Str_t &strKey) {
+  extern bool GetFileCacheKey(const Str_t &strFile, Str_t &strKey);
+
+  if (!GetFileCacheKey(strFile, strKey)) {
+    return false;
+  }
+
+  c8 strOptions[128];
+  sprintf(strOptions, "|weld=%.17g|vcache=%d|skel=%d|vta=%d", smd.fWeldEpsilon, smd.bVertexCache, smd.bOnlySkeleton, smd.bVtxAnim);
+
+  strKey += strOptions;
+  return true;
+};
+
+// Get cache file for the SMD file
+static Str_t GetSmdCacheFile(const CPath &strFile, const Str_t &strCacheDir, const Str_t &strKey) {
+  // Next to the SMD file
+  if (strCacheDir.empty()) {
+    return strFile + SMD_CACHE_EXT;
+  }
+
+  extern Str_t GetCacheFile(const Str_t &strCacheDir, const Str_t &strKey, const Str_t &strExt);
+  return GetCacheFile(strCacheDir, strKey, SMD_CACHE_EXT);
+};
+
+// Write built SMD structure
+static void WriteSmdContents(CSmdCacheWriter &out, const SmdStructure &smd) {
+  out.Int(smd.bAnimFile);
+
+  // Skeleton
+  out.Int(smd.iBones);
+
+  for (s32 iBone = 0; iBone < smd.iBones; ++iBone) {
+    const CBoneInfo &info = smd.aSkeleton[iBone];
+
+    out.Int(info.iID);
+    out.Int(info.iParent);
+    out.String(info.strName);
+    out.Int(info.aWeights.size());
+
+    for (size_t iWeight = 0; iWeight < info.aWeights.size(); ++iWeight) {
+      out.Int(info.aWeights[iWeight].iVertex);
+      out.Float(info.aWeights[iWeight].fWeight);
+    }
+  }
+
+  // Bone tracks
+  const CAnimTracks &tracks = smd.aTracks;
+  out.Int(smd.iFrames);
+  out.Int(tracks.iBones);
+  out.Int(tracks.iFrames);
+
+  for (s32 iBone = 0; iBone < tracks.iBones; ++iBone) {
+    out.Int(tracks.EndKey(iBone) - tracks.FirstKey(iBone));
+  }
+
+  for (size_t iKey = 0; iKey < tracks.aiFrames.size(); ++iKey) {
+    const Vec3D &vPos = tracks.avPos[iKey];
+    const Ang3D &vRot = tracks.avRot[iKey];
+
+    out.Int(tracks.aiFrames[iKey]);
+    out.Float(vPos[0]);
+    out.Float(vPos[1]);
+    out.Float(vPos[2]);
+    out.Float(vRot[0]);
+    out.Float(vRot[1]);
+    out.Float(vRot[2]);
+  }
+
+  // Vertices
+  out.Int(smd.aVertices.size());
+
+  for (size_t iVertex = 0; iVertex < smd.aVertices.size(); ++iVertex) {
+    const CVertex &vtx = smd.aVertices[iVertex];
+
+    out.Int(vtx.iBone);
+    out.Float(vtx.vPos[0]);
+    out.Float(vtx.vPos[1]);
+    out.Float(vtx.vPos[2]);
+    out.Float(vtx.vNormal[0]);
+    out.Float(vtx.vNormal[1]);
+    out.Float(vtx.vNormal[2]);
+    out.Float(vtx.vUV[0]);
+    out.Float(vtx.vUV[1]);
+    out.Int(vtx.iFirstWeight);
+    out.Int(vtx.ctWeights);
+  }
+
+  // Vertex weights
+  out.Int(smd.aVertexWeights.size());
+
+  for (size_t iWeight = 0; iWeight < smd.aVertexWeights.size(); ++iWeight) {
+    out.Int(smd.aVertexWeights[iWeight].iBone);
+    out.Float(smd.aVertexWeights[iWeight].fWeight);
+  }
+
+  // Surfaces
+  out.Int(smd.aSurfaces.size());
+
+  for (CSurfaces::const_iterator it = smd.aSurfaces.begin(); it != smd.aSurfaces.end(); ++it) {
+    const CPolygons &aPolygons = it->second;
+
+    out.String(it->first);
+    out.Int(aPolygons.size());
+
+    for (size_t iPol = 0; iPol < aPolygons.size(); ++iPol) {
+      const CPolygon &pol = aPolygons[iPol];
+
+      out.String(pol.strMaterial);
+      out.Int(pol.aiVertices.size());
+
+      for (size_t iCorner = 0; iCorner < pol.aiVertices.size(); ++iCorner) {
+        out.Int(pol.aiVertices[iCorner]);
+      }
+    }
+  }
+};
+
+// Read built SMD structure (returns false if its keys don't fit into the memory limit)
+static bool ReadSmdContents(CSmdCacheReader &in, SmdStructure &smd) {
+  smd.bAnimFile = (in.Word() != 0);
+
+  // Skeleton
+  smd.iBones = (s32)in.Count(3);
+  smd.aSkeleton.clear();
+  smd.aSkeleton.reserve(smd.iBones);
+
+  for (s32 iBone = 0; iBone < smd.iBones; ++iBone) {
+    const s32 iID = in.Int();
+    const s32 iParent = in.Int();
+    const Str_t strName = in.String();
+
+    smd.aSkeleton.push_back(CBoneInfo(iID, iParent, strName));
+    CBoneInfo &info = smd.aSkeleton.back();
+
+    const size_t ctWeights = in.Count(2);
+    info.aWeights.reserve(ctWeights);
+
+    for (size_t iWeight = 0; iWeight < ctWeights; ++iWeight) {
+      const s32 iVertex = in.Int();
+      info.aWeights.push_back(CWeight(iVertex, in.Float()));
+    }
+  }
+
+  // Bone tracks
+  CAnimTracks &tracks = smd.aTracks;
+  smd.iFrames = in.Int();
+
+  const s32 iTrackBones = in.Int();
+  const s32 iTrackFrames = in.Int();
+
+  if (iTrackBones != smd.iBones || iTrackFrames < 0 || iTrackFrames > smd.iFrames) {
+    CMessageException::Throw("Invalid bone tracks in the SMD cache");
+  }
+
+  // Keys of each bone
+  std::vector<size_t> actKeys(iTrackBones);
+  size_t ctKeys = 0;
+
+  for (s32 iBone = 0; iBone < iTrackBones; ++iBone) {
+    actKeys[iBone] = in.Count(7);
+    ctKeys += actKeys[iBone];
+
+    // Every bone has a key on the first frame
+    if (actKeys[iBone] == 0 && iTrackFrames > 0) {
+      CMessageException::Throw("Invalid bone tracks in the SMD cache");
+    }
+  }
+
+  if (ctKeys > (size_t)(in.pchEnd - in.pchCur) / (8 * 7)) {
+    CMessageException::Throw("Unexpected end of the SMD cache");
+  }
+
+  // Keys past the limit should be moved into a scratch file by parsing the SMD file instead
+  const u64 ctMaxKeys = smd.GetMaxKeys();
+
+  if (ctMaxKeys != 0 && ctKeys > ctMaxKeys) {
+    return false;
+  }
+
+  tracks.Reset(iTrackBones, iTrackFrames, ctKeys);
+
+  for (s32 iBone = 0; iBone < iTrackBones; ++iBone) {
+    s32 iLastFrame = -1;
+
+    for (size_t iKey = 0; iKey < actKeys[iBone]; ++iKey) {
+      const s32 iFrame = in.Int();
+
+      // First key must be on the first frame and other keys must go after it
+      if ((iKey == 0) != (iFrame == 0) || iFrame <= iLastFrame || iFrame >= iTrackFrames) {
+        CMessageException::Throw("Invalid bone tracks in the SMD cache");
+      }
+
+      iLastFrame = iFrame;
+
+      Vec3D vPos;
+      vPos[0] = in.Float();
+      vPos[1] = in.Float();
+      vPos[2] = in.Float();
+
+      Ang3D vRot;
+      vRot[0] = in.Float();
+      vRot[1] = in.Float();
+      vRot[2] = in.Float();
+
+      tracks.AddKey(iFrame, vPos, vRot);
+    }
+
+    tracks.EndBone();
+  }
+
+  // Vertices
+  const size_t ctVertices = in.Count(11);
+  smd.aVertices.resize(ctVertices);
+
+  for (size_t iVertex = 0; iVertex < ctVertices; ++iVertex) {
+    CVertex &vtx = smd.aVertices[iVertex];
+
+    vtx.iBone = in.Index(smd.iBones);
+    vtx.vPos[0] = in.Float();
+    vtx.vPos[1] = in.Float();
+    vtx.vPos[2] = in.Float();
+    vtx.vNormal[0] = in.Float();
+    vtx.vNormal[1] = in.Float();
+    vtx.vNormal[2] = in.Float();
+    vtx.vUV[0] = in.Float();
+    vtx.vUV[1] = in.Float();
+    vtx.iFirstWeight = in.Int();
+    vtx.ctWeights = in.Int();
+  }
+
+  // Vertex weights
+  const size_t ctWeights = in.Count(2);
+  smd.aVertexWeights.resize(ctWeights);
+
+  for (size_t iWeight = 0; iWeight < ctWeights; ++iWeight) {
+    smd.aVertexWeights[iWeight].iBone = in.Index(smd.iBones);
+    smd.aVertexWeights[iWeight].fWeight = in.Float();
+  }
+
+  // Weight ranges of vertices and vertices of bone weights are only checked once both arrays are known
+  for (size_t iVertex = 0; iVertex < ctVertices; ++iVertex) {
+    const CVertex &vtx = smd.aVertices[iVertex];
+
+    if (vtx.iFirstWeight < 0 || vtx.ctWeights < 0 || (size_t)vtx.iFirstWeight + vtx.ctWeights > ctWeights) {
+      CMessageException::Throw("Invalid vertex weights in the SMD cache");
+    }
+  }
+
+  for (s32 iBone = 0; iBone < smd.iBones; ++iBone) {
+    const std::vector<CWeight> &aWeights = smd.aSkeleton[iBone].aWeights;
+
+    for (size_t iWeight = 0; iWeight < aWeights.size(); ++iWeight) {
+      if (aWeights[iWeight].iVertex < 0 || (size_t)aWeights[iWeight].iVertex >= ctVertices) {
+        CMessageException::Throw("Invalid bone weights in the SMD cache");
+      }
+    }
+  }
+
+  // Surfaces
+  const size_t ctSurfaces = in.Count(2);
+  smd.aSurfaces.clear();
+
+  for (size_t iSurface = 0; iSurface < ctSurfaces; ++iSurface) {
+    CPolygons &aPolygons = smd.aSurfaces[in.String()];
+
+    const size_t ctPolygons = in.Count(2);
+    aPolygons.reserve(ctPolygons);
+
+    for (size_t iPol = 0; iPol < ctPolygons; ++iPol) {
+      aPolygons.push_back(CPolygon(in.String()));
+      Ints_t &aiVertices = aPolygons.back().aiVertices;
+
+      aiVertices.resize(in.Count(1));
+
+      for (size_t iCorner = 0; iCorner < aiVertices.size(); ++iCorner) {
+        aiVertices[iCorner] = in.Index(ctVertices);
+      }
+    }
+  }
+
+  return true;
+};
+
+// Start over with a clean structure that keeps its settings
+static void ResetSmdStructure(SmdStructure &smd) {
+  const Str_t strFilePath = smd.strFilePath;
+  const Str_t strFileName = smd.strFileName;
+  const f64 fWeldEpsilon = smd.fWeldEpsilon;
+  const bool bVertexCache = smd.bVertexCache;
+  const u64 iMemoryLimit = smd.iMemoryLimit;
+  const bool bVtxAnim = smd.bVtxAnim;
+  const bool bOnlySkeleton = smd.bOnlySkeleton;
+
+  smd.Clear();
+  smd.strFilePath = strFilePath;
+  smd.strFileName = strFileName;
+  smd.fWeldEpsilon = fWeldEpsilon;
+  smd.bVertexCache = bVertexCache;
+  smd.iMemoryLimit = iMemoryLimit;
+  smd.bVtxAnim = bVtxAnim;
+  smd.bOnlySkeleton = bOnlySkeleton;
+};
+
+// Load built SMD structure from the cache file if it matches the SMD file (returns false if it needs to be rebuilt)
+extern bool LoadSmdCache(const CPath &strFile, const Str_t &strCacheDir, SmdStructure &smd) {
+  TRACE_SCOPE_DETAIL("LoadSmdCache", strFile);
+
+  Str_t strKey;
+
+  if (!GetSmdCacheKey(strFile, smd, strKey)) {
+    return false;
+  }
+
+  const Str_t strCacheFile = GetSmdCacheFile(strFile, strCacheDir, strKey);
+
+  // Map the whole cache file into memory
+  CInputFile file;
+
+  if (!file.TryOpen(strCacheFile)) {
+    return false;
+  }
+
+  CSmdCacheReader in(file.GetData(), file.GetSize());
+
+  try {
+    // Check the header
+    const u64 iMagic = in.Word();
+
+    if (memcmp(&iMagic, SMD_CACHE_MAGIC, 8) != 0 || in.Word() != SMD_CACHE_VERSION || in.Word() != SMD_CACHE_ENDIAN
+     || in.String() != strKey) {
+      return false;
+    }
+
+    // Check the contents
+    const u64 iSize = in.Word();
+    const u64 iChecksum = in.Word();
+
+    if (iSize != (u64)(in.pchEnd - in.pchCur) || GetCacheChecksum(in.pchCur, (size_t)iSize) != iChecksum) {
+      Console() << "SMD cache " << strCacheFile << " is damaged, rebuilding it...\n";
+      return false;
+    }
+
+    if (!ReadSmdContents(in, smd)) {
+      ResetSmdStructure(smd);
+      Console() << "SMD cache " << strCacheFile << " has more frames than fit into the memory limit, parsing the SMD file...\n";
+      return false;
+    }
+
+  } catch (CException &) {
+    ResetSmdStructure(smd);
+    Console() << "SMD cache " << strCacheFile << " is damaged, rebuilding it...\n";
+    return false;
+  }
+
+  Console() << "Loaded built SMD file from " << strCacheFile << "...\n";
+  return true;
+};
+
+// Save built SMD structure into the cache file
+extern void SaveSmdCache(const CPath &strFile, const Str_t &strCacheDir, const SmdStructure &smd) {
+  TRACE_SCOPE_DETAIL("SaveSmdCache", strFile);
+
+  Str_t strKey;
+
+  // Frames in the scratch file aren't kept
+  if (smd.spill.IsUsed() || !GetSmdCacheKey(strFile, smd, strKey)) {
+    return;
+  }
+
+  const Str_t strCacheFile = GetSmdCacheFile(strFile, strCacheDir, strKey);
+
+  if (!strCacheDir.empty()) {
+    MakeDirectory(GetFileDir(strCacheFile));
+  }
+
+  // Write into a temporary file first to not leave broken files behind
+  const Str_t strTemp = strCacheFile + ".tmp";
+
+  try {
+    COutputFile file;
+    file.Open(strTemp);
+
+    CSmdCacheWriter out(file);
+    file.Write(SMD_CACHE_MAGIC, 8);
+    out.Word(SMD_CACHE_VERSION);
+    out.Word(SMD_CACHE_ENDIAN);
+    out.String(strKey);
+
+    // Size and checksum of the contents are filled in afterwards
+    const u64 iHeaderEnd = file.Tell();
+    out.Word(0);
+    out.Word(0);
+
+    out.iChecksum = SMD_CACHE_ENDIAN;
+    WriteSmdContents(out, smd);
+
+    const u64 aiContents[2] = { file.Tell() - iHeaderEnd - 16, out.iChecksum };
+    file.Overwrite(iHeaderEnd, (const c8 *)aiContents, sizeof(aiContents));
+    file.Close();
+
+  } catch (CException &) {
+    remove(strTemp.c_str());
+    return;
+  }
+
+  remove(strCacheFile.c_str());
+  rename(strTemp.c_str(), strCacheFile.c_str());
+};
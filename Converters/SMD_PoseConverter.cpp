@@ -0,0 +1,311 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "SMD_Structures.h"
+
+#include "Common/SimdMath.h"
+#include "Common/TaskScheduler.h"
+#include "Common/Trace.h"
+
+// Bone placements converted at once
+#define POSE_BATCH 64
+
+// Keys of one bone track converted by one task
+#define POSE_TASK_KEYS 2048
+
+// Convert on multiple threads only when there's enough placements
+#define POSE_MIN_THREADED 16384
+
+// Rotation fix for root bones under one combination of facing options
+struct PoseFix {
+  u8 aiAxes[3];    // Position axes after the swap
+  f64 aAngles[3];  // Trackball rotation in degrees
+};
+
+static const PoseFix _aPoseFixes[4] = {
+  { { AXIS__X, AXIS__Y, AXIS__Z }, {   0.0,   0.0,   0.0 } },
+  { { AXIS_mY, AXIS__Z, AXIS_mX }, {   0.0, -90.0,  90.0 } }, // SMD to SE1: +X+Y+Z -> -Y+X+Z -> -Y+Z-X
+  { { AXIS_mX, AXIS__Z, AXIS__Y }, { 180.0, -90.0,   0.0 } }, // Source to SE1: +X+Y+Z -> +X+Z-Y -> -X+Z+Y
+  { { AXIS__Y, AXIS_mX, AXIS__Z }, {   0.0,   0.0, -90.0 } }, // SMD to Source: +X+Y -> +Y-X
+};
+
+// Pick facing fix of root bones for the options
+static s32 GetPoseFix(const SmdOptions &opts, bool bAnimFile) {
+  // Axis changes correlate with RotateTrackBall angle application in the opposite order
+  if (bAnimFile) {
+    if (opts.bFixFaceDir && opts.bFixAnimNorth) return 1;
+    if (opts.bFixFaceDir) return 2;
+    if (opts.bFixAnimNorth) return 3;
+    return 0;
+  }
+
+  return (opts.bFixFaceDir ? 2 : 0);
+};
+
+// Convert one bone placement step by step (reference for the batched conversion)
+static void ConvertPlacement(const SmdOptions &opts, bool bAnimFile, bool bRoot, Vec3D &vPos, const Ang3D &vRot, Mat12D &mConverted) {
+  // Scale the bone
+  vPos *= opts.fScale;
+
+  // Resulting placement
+  Vec3D vBonePos = vPos;
+  Ang3D vBoneRot = vRot;
+
+  // Convert to matrix
+  Mat3D m3D;
+  Mat3DFromAngles(m3D, vBoneRot);
+
+  // Convert rotation angles to SE1
+  QuatD q;
+  q.FromMatrix(m3D);
+  q = QuatD(-q._w, -q._y, -q._x, -q._z); // Swap X and Y
+  q.ToMatrix(m3D);
+
+  // Fixed angles
+  Mat3DToAngles(m3D, vBoneRot);
+
+  // Fix facing and forward direction for root bones
+  const s32 iFix = GetPoseFix(opts, bAnimFile);
+
+  if (bRoot && iFix != 0) {
+    const PoseFix &fix = _aPoseFixes[iFix];
+    SwapAxes(vBonePos, fix.aiAxes[0], fix.aiAxes[1], fix.aiAxes[2]);
+    vBoneRot.RotateTrackball(Ang3D(fix.aAngles[0], fix.aAngles[1], fix.aAngles[2]).DegToRad());
+  }
+
+  // Make bone placement matrix
+  Mat3DFromAngles(m3D, vBoneRot);
+  Mat3DtoMat12(mConverted, m3D, vBonePos);
+};
+
+// Convert rotations of a whole batch into matrices
+static void ConvertRotations(const f64 *afAngles[3], f64 *afMatrix[9], const Mat3D *pmFix) {
+  typedef SimdLanes L;
+
+  for (s32 iLane = 0; iLane < POSE_BATCH; iLane += L::COUNT) {
+    L::Vec vSinH, vCosH, vSinP, vCosP, vSinB, vCosB;
+    SimdSinCos(L::Load(afAngles[0] + iLane), vSinH, vCosH);
+    SimdSinCos(L::Load(afAngles[1] + iLane), vSinP, vCosP);
+    SimdSinCos(L::Load(afAngles[2] + iLane), vSinB, vCosB);
+
+    // Rotation matrix from angles (same as Mat3DFromAngles)
+    const L::Vec vSinPSinH = L::Mul(vSinP, vSinH);
+    const L::Vec vSinPCosH = L::Mul(vSinP, vCosH);
+
+    L::Vec m[9];
+    m[0] = L::Add(L::Mul(vCosH, vCosB), L::Mul(vSinPSinH, vSinB));
+    m[1] = L::Sub(L::Mul(vSinPSinH, vCosB), L::Mul(vCosH, vSinB));
+    m[2] = L::Mul(vCosP, vSinH);
+    m[3] = L::Mul(vCosP, vSinB);
+    m[4] = L::Mul(vCosP, vCosB);
+    m[5] = L::Sub(L::Set(0.0), vSinP);
+    m[6] = L::Sub(L::Mul(vSinPCosH, vSinB), L::Mul(vSinH, vCosB));
+    m[7] = L::Add(L::Mul(vSinPCosH, vCosB), L::Mul(vSinH, vSinB));
+    m[8] = L::Mul(vCosP, vCosH);
+
+    // Swapping X and Y of the quaternion transposes the rotation with X and Y axes swapped
+    L::Vec r[9] = {
+      m[4], m[1], m[7],
+      m[3], m[0], m[6],
+      m[5], m[2], m[8],
+    };
+
+    // Rotate around the fixed axes
+    if (pmFix != nullptr) {
+      const Mat3D &mFix = *pmFix;
+
+      for (s32 iRow = 0; iRow < 3; ++iRow) {
+        for (s32 iCol = 0; iCol < 3; ++iCol) {
+          L::Vec v = L::Mul(L::Set(mFix(iRow, 0)), r[iCol]);
+          v = L::Add(v, L::Mul(L::Set(mFix(iRow, 1)), r[3 + iCol]));
+          v = L::Add(v, L::Mul(L::Set(mFix(iRow, 2)), r[6 + iCol]));
+          L::Store(afMatrix[iRow * 3 + iCol] + iLane, v);
+        }
+      }
+
+    } else {
+      for (s32 i = 0; i < 9; ++i) {
+        L::Store(afMatrix[i] + iLane, r[i]);
+      }
+    }
+  }
+};
+
+// Convert placements in a range of keys of one bone track
+static void ConvertBoneKeys(const SmdOptions &opts, bool bAnimFile, bool bRoot, CAnimTracks &tracks, size_t iFirstKey, size_t iEndKey) {
+  const s32 iFix = (bRoot ? GetPoseFix(opts, bAnimFile) : 0);
+  const PoseFix &fix = _aPoseFixes[iFix];
+
+  // Trackball rotation is applied on top of the bone rotation
+  Mat3D mFix;
+  Mat3DFromAngles(mFix, Ang3D(fix.aAngles[0], fix.aAngles[1], fix.aAngles[2]).DegToRad());
+  const Mat3D *pmFix = (iFix != 0 ? &mFix : nullptr);
+
+  // Lanes of the batch
+  f64 aafAngles[3][POSE_BATCH];
+  f64 aafMatrix[9][POSE_BATCH];
+  size_t aiKeys[POSE_BATCH];
+
+  const f64 *afAngles[3] = { aafAngles[0], aafAngles[1], aafAngles[2] };
+  f64 *afMatrix[9];
+
+  for (s32 i = 0; i < 9; ++i) {
+    afMatrix[i] = aafMatrix[i];
+  }
+
+  size_t iKey = iFirstKey;
+
+  while (iKey < iEndKey) {
+    // Gather placements of keys
+    s32 ctBatch = 0;
+
+    for (; iKey < iEndKey && ctBatch < POSE_BATCH; ++iKey) {
+      const Ang3D &vRot = tracks.avRot[iKey];
+
+      for (s32 i = 0; i < 3; ++i) {
+        f64 fAngle = vRot[i];
+
+        // Bring huge angles into the range of the vectorized functions
+        if (fAngle > SIMD_SINCOS_MAX || fAngle < -SIMD_SINCOS_MAX) {
+          fAngle = fmod(fAngle, 2.0 * 3.14159265358979323846);
+        }
+
+        aafAngles[i][ctBatch] = fAngle;
+      }
+
+      aiKeys[ctBatch++] = iKey;
+    }
+
+    // Pad the rest of the batch
+    for (s32 iPad = ctBatch; iPad < POSE_BATCH; ++iPad) {
+      aafAngles[0][iPad] = aafAngles[1][iPad] = aafAngles[2][iPad] = 0.0;
+    }
+
+    ConvertRotations(afAngles, afMatrix, pmFix);
+
+    // Scatter placement matrices
+    for (s32 iLane = 0; iLane < ctBatch; ++iLane) {
+      const size_t iOut = aiKeys[iLane];
+
+      // Scale the bone
+      Vec3D &vPos = tracks.avPos[iOut];
+      vPos *= opts.fScale;
+
+      Vec3D vBonePos = vPos;
+      SwapAxes(vBonePos, fix.aiAxes[0], fix.aiAxes[1], fix.aiAxes[2]);
+
+      Mat12D &m = tracks.amConverted[iOut];
+
+      for (s32 i = 0; i < 9; ++i) {
+        m(i / 3, i % 3) = aafMatrix[i][iLane];
+      }
+
+      m(0, 3) = vBonePos[0];
+      m(1, 3) = vBonePos[1];
+      m(2, 3) = vBonePos[2];
+    }
+  }
+};
+
+// Convert all placements in the track of one bone
+extern void ConvertBoneTrack(const SmdOptions &opts, bool bAnimFile, bool bRoot, CAnimTracks &tracks, s32 iBone) {
+  ConvertBoneKeys(opts, bAnimFile, bRoot, tracks, tracks.FirstKey(iBone), tracks.EndKey(iBone));
+};
+
+// Convert all placements in the track of one bone step by step
+extern void ConvertBoneTrackScalar(const SmdOptions &opts, bool bAnimFile, bool bRoot, CAnimTracks &tracks, s32 iBone) {
+  for (size_t iKey = tracks.FirstKey(iBone); iKey < tracks.EndKey(iBone); ++iKey) {
+    ConvertPlacement(opts, bAnimFile, bRoot, tracks.avPos[iKey], tracks.avRot[iKey], tracks.amConverted[iKey]);
+  }
+};
+
+// Pose conversion shared between threads
+struct PoseTasks {
+  const SmdOptions *pOpts;
+  SmdStructure *pSMD;
+  s32 ctChunks; // Tasks per bone track
+};
+
+// Convert one chunk of keys of one bone
+static void ConvertPoseTask(s32 iTask, void *pData) {
+  TRACE_SCOPE("ConvertPoseTask");
+
+  PoseTasks &tasks = *(PoseTasks *)pData;
+  SmdStructure &smd = *tasks.pSMD;
+
+  const CAnimTracks &tracks = smd.aTracks;
+  const s32 iBone = iTask / tasks.ctChunks;
+  const size_t iFirstKey = tracks.FirstKey(iBone) + (size_t)(iTask % tasks.ctChunks) * POSE_TASK_KEYS;
+  const size_t iBoneEnd = tracks.EndKey(iBone);
+
+  // Bone has fewer keys than others
+  if (iFirstKey >= iBoneEnd) return;
+
+  const size_t iEndKey = (iBoneEnd - iFirstKey > POSE_TASK_KEYS ? iFirstKey + POSE_TASK_KEYS : iBoneEnd);
+
+  const bool bRoot = (smd.aSkeleton[iBone].iParent == -1);
+  ConvertBoneKeys(*tasks.pOpts, smd.bAnimFile, bRoot, smd.aTracks, iFirstKey, iEndKey);
+};
+
+// Calculate proper placements for every bone in every frame
+extern void ConvertPoses(const SmdOptions &opts, SmdStructure &smd) {
+  TRACE_SCOPE("ConvertPoses");
+
+  CAnimTracks &tracks = smd.aTracks;
+  const s32 ctThreads = (opts.ctThreads > 0 ? opts.ctThreads : GetHardwareThreads());
+
+  // Every placement is converted independently, so splitting the work doesn't change the results
+  if (ctThreads > 1 && tracks.avPos.size() >= POSE_MIN_THREADED) {
+    PoseTasks tasks;
+    tasks.pOpts = &opts;
+    tasks.pSMD = &smd;
+    // Bones are split into as many chunks as the one with the most keys needs
+    size_t ctMaxKeys = 0;
+
+    for (s32 iBone = 0; iBone < tracks.iBones; ++iBone) {
+      const size_t ctKeys = tracks.EndKey(iBone) - tracks.FirstKey(iBone);
+      if (ctKeys > ctMaxKeys) ctMaxKeys = ctKeys;
+    }
+
+    tasks.ctChunks = (s32)((ctMaxKeys + POSE_TASK_KEYS - 1) / POSE_TASK_KEYS);
+
+    CTaskScheduler scheduler;
+
+    for (s32 iBone = 0; iBone < tracks.iBones; ++iBone) {
+      const size_t ctKeys = tracks.EndKey(iBone) - tracks.FirstKey(iBone);
+
+      for (s32 iChunk = 0; iChunk < tasks.ctChunks; ++iChunk) {
+        const size_t iChunkKey = (size_t)iChunk * POSE_TASK_KEYS;
+        const size_t ctLeft = (ctKeys > iChunkKey ? ctKeys - iChunkKey : 0);
+        scheduler.AddTask(ctLeft < POSE_TASK_KEYS ? ctLeft : POSE_TASK_KEYS);
+      }
+    }
+
+    scheduler.Run(ctThreads, &ConvertPoseTask, &tasks);
+    return;
+  }
+
+  for (s32 iBone = 0; iBone < tracks.iBones; ++iBone) {
+    const bool bRoot = (smd.aSkeleton[iBone].iParent == -1);
+    ConvertBoneTrack(opts, smd.bAnimFile, bRoot, tracks, iBone);
+  }
+};
@@ -21,28 +21,39 @@
 
 #include "Main.h"
 #include "SMD_Structures.h"
+#include "SE1_Binary.h"
+
+#include "Common/OutputFile.h"
+#include "Common/Trace.h"
 
 // Write SMD skeleton in SE1 ASCII format
 extern void WriteSkeleton(const SmdOptions &opts, const SmdStructure &smd) {
+  TRACE_SCOPE("WriteSkeleton");
+
   // Don't make skeletons out of animations
   if (smd.bAnimFile) {
     return;
   }
 
   // Take the first frame for the entire skeleton
-  const CEnvelopes &aEnvelopes = smd.aFrames[0].aBones;
+  const CAnimTracks &tracks = smd.aTracks;
 
-  // Mismatching bone count
-  if (aEnvelopes.size() != (size_t)smd.iBones) {
-    CMessageException::Throw("Expected to have %d bones in the first frame but got %d", smd.iBones, aEnvelopes.size());
+  // No frames with bone placements
+  if (tracks.iFrames == 0) {
+    CMessageException::Throw("Expected to have %d bones in the first frame but got none", smd.iBones);
   }
   
-#if !_DEV_STL_IO
-  CFileDevice fileD((_strFilePath + ".as").c_str());
-  CStringStream file(&fileD, IReadWriteDevice::OM_WRITEONLY);
-#else
-  FileOut_t file((_strFilePath + ".as").c_str());
-#endif
+  // Longest possible text of the skeleton
+  const size_t iNumber = MaxFloatTextLength(_iFloatDigits);
+  size_t iExpectedSize = 256;
+
+  for (s32 iSizeBone = 0; iSizeBone < smd.iBones; ++iSizeBone) {
+    iExpectedSize += 2 * smd.aSkeleton[iSizeBone].strName.size() + 13 * (iNumber + 2) + 64;
+  }
+
+  COutputFile file;
+  file.Open(smd.strFilePath + ".as");
+  file.Reserve(iExpectedSize);
 
   file << "SE_SKELETON 0.1;\n\n";
 
@@ -50,8 +61,7 @@ extern void WriteSkeleton(const SmdOptions &opts, const SmdStructure &smd) {
 
   // Write each bone
   for (s32 iBone = 0; iBone < smd.iBones; ++iBone) {
-    const CBoneEnvelope &bone = aEnvelopes[iBone];
-    CBoneInfo &info = *bone.pInfo;
+    const CBoneInfo &info = smd.aSkeleton[iBone];
 
     // Bone name
     file << "  NAME \"" << info.strName << "\";\n";
@@ -63,9 +73,9 @@ extern void WriteSkeleton(const SmdOptions &opts, const SmdStructure &smd) {
     f64 fLength = 8.0 * opts.fScale;
 
     if (info.iParent != -1) {
-      const CBoneEnvelope &boneParent = aEnvelopes[info.iParent];
+      const CBoneInfo &infoParent = smd.aSkeleton[info.iParent];
 
-      file << "\"" << boneParent.pInfo->strName << "\";\n";
+      file << "\"" << infoParent.strName << "\";\n";
 
       //fLength = (boneParent.vPos - bone.vPos).Length();
 
@@ -77,7 +87,7 @@ extern void WriteSkeleton(const SmdOptions &opts, const SmdStructure &smd) {
     file << "  LENGTH " << fLength << ";\n";
 
     file << "  {\n    ";
-    PrintPlacement(bone.mConverted, file);
+    PrintPlacement(tracks.amConverted[tracks.FirstKey(iBone)], file);
     file << "\n  }\n";
   }
 
@@ -85,11 +95,103 @@ extern void WriteSkeleton(const SmdOptions &opts, const SmdStructure &smd) {
 
   file << "SE_SKELETON_END;\n";
 
-#if !_DEV_STL_IO
-  fileD.Close();
-#else
-  file.close();
-#endif
+  file.Close();
     
-  std::cout << "Converted skeleton...\n";
+  Console() << "Converted skeleton...\n";
+};
+
+// Add bone after its parent into the list
+static void AddBoneAfterParent(const SmdStructure &smd, s32 iBone, Bits_t &aAdded, Ints_t &aiOrder) {
+  if (aAdded[iBone]) {
+    return;
+  }
+
+  aAdded[iBone] = true;
+
+  const s32 iParent = smd.aSkeleton[iBone].iParent;
+
+  if (iParent != -1) {
+    AddBoneAfterParent(smd, iParent, aAdded, aiOrder);
+  }
+
+  aiOrder.push_back(iBone);
+};
+
+// Write SMD skeleton in SE1 binary format (single LOD with parents before their children)
+extern void WriteSkeletonBinary(const SmdOptions &opts, const SmdStructure &smd) {
+  TRACE_SCOPE("WriteSkeletonBinary");
+
+  // Don't make skeletons out of animations
+  if (smd.bAnimFile) {
+    return;
+  }
+
+  const CAnimTracks &tracks = smd.aTracks;
+
+  // No frames with bone placements
+  if (tracks.iFrames == 0) {
+    CMessageException::Throw("Expected to have %d bones in the first frame but got none", smd.iBones);
+  }
+
+  // Binary skeletons store bones sorted by hierarchy
+  Bits_t aAdded(smd.iBones, false);
+  Ints_t aiOrder;
+
+  for (s32 iOrderBone = 0; iOrderBone < smd.iBones; ++iOrderBone) {
+    AddBoneAfterParent(smd, iOrderBone, aAdded, aiOrder);
+  }
+
+  // Placements relative to the whole model
+  std::vector<Mat12D> amAbsolute(smd.iBones);
+
+  COutputFile file;
+  file.Open(smd.strFilePath + ".bs");
+
+  file.Write(SE1_SKELETON_ID, 4);
+  file.WriteLong(SE1_SKELETON_VERSION);
+  file.WriteLong(1); // LODs
+
+  file.WriteString(smd.strFileName + ".as"); // Source file
+  file.WriteFloat(SE1_LOD_MAX_DISTANCE);
+  file.WriteLong(smd.iBones);
+
+  // Same length as in ASCII skeletons
+  const f64 fLength = 8.0 * opts.fScale;
+
+  for (s32 iOrder = 0; iOrder < smd.iBones; ++iOrder) {
+    const s32 iBone = aiOrder[iOrder];
+    const CBoneInfo &info = smd.aSkeleton[iBone];
+    const Mat12D &mRelative = tracks.amConverted[tracks.FirstKey(iBone)];
+
+    if (info.iParent != -1) {
+      CombinePlacements(amAbsolute[info.iParent], mRelative, amAbsolute[iBone]);
+    } else {
+      amAbsolute[iBone] = mRelative;
+    }
+
+    file.WriteString(info.strName);
+    file.WriteString(info.iParent != -1 ? smd.aSkeleton[info.iParent].strName : "");
+
+    // Absolute placement
+    for (s32 i = 0; i < 12; ++i) {
+      file.WriteFloat(amAbsolute[iBone](i / 4, i % 4));
+    }
+
+    // Relative placement as a position and a rotation
+    const Vec3D vOffset(mRelative(0, 3), mRelative(1, 3), mRelative(2, 3));
+    QuatD q;
+    PlacementToQuat(mRelative, q);
+
+    file.WriteFloat(vOffset[0]);
+    file.WriteFloat(vOffset[1]);
+    file.WriteFloat(vOffset[2]);
+    WriteQuat(file, q);
+
+    file.WriteFloat(sqrt(vOffset[0] * vOffset[0] + vOffset[1] * vOffset[1] + vOffset[2] * vOffset[2]));
+    file.WriteFloat(fLength);
+  }
+
+  file.Close();
+
+  Console() << "Converted binary skeleton...\n";
 };
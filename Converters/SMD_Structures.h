@@ -22,6 +22,9 @@
 #ifndef _SMD_STRUCTURES_H
 #define _SMD_STRUCTURES_H
 
+#include "Common/OutputFile.h"
+#include "Common/ScratchFile.h"
+
 #define Tkn_t CParserToken
 
 // SMD vertex weight
@@ -57,40 +60,18 @@ class CBoneInfo {
 // Bone list
 typedef std::vector<CBoneInfo> CBones;
 
-// SMD bone envelope in the animation
-class CBoneEnvelope {
+// SMD bone placement in one frame
+class CBonePlacement {
   public:
-    // Bone info
-    CBoneInfo *pInfo;
-
-    // Bone placement
     Vec3D vPos;
     Ang3D vRot;
-
-    // Converted placement as a matrix with positon
-    Mat12D mConverted;
-
-  public:
-    // Default constructor
-    CBoneEnvelope(CBoneInfo *pSetInfo = nullptr) :
-      pInfo(pSetInfo)
-    {
-    };
-
-    // Copy bone placement
-    void CopyPlacement(const CBoneEnvelope &envOther) {
-      vPos = envOther.vPos;
-      vRot = envOther.vRot;
-      mConverted = envOther.mConverted;
-    };
 };
 
+// Bone placements
+typedef std::vector<CBonePlacement> CPlacements;
+
 // Print out the placement matrix
-#if !_DEV_STL_IO
-inline void PrintPlacement(const Mat12D &m, CStringStream &out) {
-#else
-inline void PrintPlacement(const Mat12D &m, Out_t &out) {
-#endif
+inline void PrintPlacement(const Mat12D &m, COutputFile &out) {
   #if 1
     for (s32 i = 0; i < 12; ++i) {
       out << m(i / 4, i % 4) << (i == 11 ? ";" : ", ");
@@ -113,24 +94,124 @@ inline void PrintPlacement(const Mat12D &m, Out_t &out) {
   #endif
 };
 
-// Bone envelopes
-typedef std::vector<CBoneEnvelope> CEnvelopes;
-
-// One frame with envelope positions
-class CAnimFrame {
+// Bone tracks of the entire animation with keys only on frames where bones are set, stored bone by bone in contiguous arrays
+// The first key of each bone is always on the first frame, and frames without keys repeat the last key
+class CAnimTracks {
   public:
-    CEnvelopes aBones; // Bone envelopes
-    Bits_t aUsed; // Mark used bones
+    s32 iBones;
+    s32 iFrames; // Frames of the whole animation, including ones without keys
+
+    std::vector<size_t> aiFirstKey;  // First key of each bone (and the end of keys after the last bone)
+    Ints_t aiFrames;                 // Frame of each key
+    std::vector<Vec3D> avPos;        // Bone positions
+    std::vector<Ang3D> avRot;        // Bone rotations
+    std::vector<Mat12D> amConverted; // Converted placements as matrices with position
 
   public:
-    // Allocate enough space for all envelopes
-    CAnimFrame(const s32 iBones) : aBones(iBones), aUsed(iBones, false)
+    CAnimTracks(void) : iBones(0), iFrames(0), aiFirstKey(1, 0)
     {
     };
+
+    // Remove all keys before adding them bone by bone
+    void Reset(const s32 iSetBones, const s32 iSetFrames, const size_t ctReserveKeys) {
+      iBones = iSetBones;
+      iFrames = iSetFrames;
+
+      aiFirstKey.assign(1, 0);
+      aiFirstKey.reserve(iBones + 1);
+      aiFrames.clear();
+      avPos.clear();
+      avRot.clear();
+      amConverted.clear();
+
+      aiFrames.reserve(ctReserveKeys);
+      avPos.reserve(ctReserveKeys);
+      avRot.reserve(ctReserveKeys);
+      amConverted.reserve(ctReserveKeys);
+    };
+
+    void Clear(void) {
+      Reset(0, 0, 0);
+    };
+
+    // Add key of the current bone after its previous keys
+    inline void AddKey(const s32 iFrame, const Vec3D &vPos, const Ang3D &vRot) {
+      aiFrames.push_back(iFrame);
+      avPos.push_back(vPos);
+      avRot.push_back(vRot);
+      amConverted.push_back(Mat12D());
+    };
+
+    // Finish keys of the current bone and start the next one
+    inline void EndBone(void) {
+      aiFirstKey.push_back(aiFrames.size());
+    };
+
+    // Range of keys of the bone
+    inline size_t FirstKey(const s32 iBone) const {
+      return aiFirstKey[iBone];
+    };
+
+    inline size_t EndKey(const s32 iBone) const {
+      return aiFirstKey[iBone + 1];
+    };
+
+    // Move from a key of the bone to the one that's in effect on the frame (frames only go forward)
+    inline void SeekKey(const s32 iBone, size_t &iKey, const s32 iFrame) const {
+      const size_t iEnd = aiFirstKey[iBone + 1];
+
+      while (iKey + 1 < iEnd && aiFrames[iKey + 1] <= iFrame) {
+        ++iKey;
+      }
+    };
+};
+
+// Animation keys moved out of memory into a scratch file block by block, with each block stored bone by bone
+class CTrackSpill {
+  public:
+    CScratchFile file;
+    std::vector<u64> aiBlockStart; // Offset of each block in the file
+    std::vector<u64> aiBoneKeys;   // First key of each bone within each block (and the end of keys after the last bone)
+    Bits_t aAnimated;              // Bones that have keys after the first frame
+
+  private:
+    // Not copyable
+    CTrackSpill(const CTrackSpill &);
+    CTrackSpill &operator=(const CTrackSpill &);
+
+  public:
+    CTrackSpill(void) {};
+
+    void Clear(void);
+
+    // Move keys that have been sorted into bone tracks into a new block of the file
+    void AddBlock(const Str_t &strFile, const CAnimTracks &block);
+
+    // Load keys of one bone in a block as the only bone in the tracks
+    void LoadBone(s32 iBlock, s32 iBone, CAnimTracks &tracks);
+
+    inline bool IsUsed(void) const {
+      return !aiBlockStart.empty();
+    };
 };
 
-// Animation frames
-typedef std::vector<CAnimFrame> CAnimation;
+// Values of one bone placement as they appear in the file (XYZHPB)
+#define SMD_PLACEMENT_VALUES 6
+
+// Memory used by one key while it's parsed and after it's sorted into bone tracks
+#define SMD_PARSED_BYTES (SMD_PLACEMENT_VALUES * sizeof(f64) + 2 * sizeof(s32))
+#define SMD_TRACK_BYTES (sizeof(s32) + sizeof(Vec3D) + sizeof(Ang3D) + sizeof(Mat12D))
+
+// Largest difference of converted placement values from the step by step conversion
+// (outside of gimbal lock, where decomposing angles in the step by step conversion loses precision)
+#define POSE_TOLERANCE 1e-9
+
+// Weight of a mesh vertex for one bone
+class CVertexWeight {
+  public:
+    s32 iBone;
+    f64 fWeight;
+};
 
 // SMD mesh vertex
 class CVertex {
@@ -139,6 +220,10 @@ class CVertex {
     Vec3D vPos;
     Vec3D vNormal;
     Vec2D vUV;
+
+    // Range of weights in the vertex weight list
+    s32 iFirstWeight;
+    s32 ctWeights;
 };
 
 // Vertex list
@@ -215,50 +300,143 @@ inline void SwapAxes(Vec3D &v, const u8 x, const u8 y, const u8 z) {
   v = Vec3D(aDirections[x], aDirections[y], aDirections[z]);
 };
 
-// Current SMD file
-extern Str_t _strFilePath;
-extern Str_t _strFileName;
-
 // SMD file structure
 struct SmdStructure {
+  Str_t strFilePath; // Path to the file without the extension
+  Str_t strFileName; // File name without the extension
+
   // Skeleton bones
   CBones aSkeleton;
   s32 iBones;
 
-  // Animation frames
-  CAnimation aFrames;
-  s32 iFrames;
+  // Animation tracks of each bone
+  CAnimTracks aTracks;
+  s32 iFrames; // Frames from the first time to the last one in the file
 
   CVertices aVertices; // Mesh vertices
   CSurfaces aSurfaces; // Mesh surfaces with polygons
+  std::vector<CVertexWeight> aVertexWeights; // Bone weights of all vertices
+
+  // Merge vertices that differ by no more than this (negative to keep all triangle corners separate)
+  f64 fWeldEpsilon;
+
+  // Reorder triangles and vertices for the vertex cache
+  bool bVertexCache;
+
+  // Bytes of parsed animation keys that can be kept in memory before moving them into a scratch file (0 for no limit)
+  u64 iMemoryLimit;
+
+  // Animation keys that didn't fit into memory (the tracks only keep the first frame)
+  CTrackSpill spill;
 
   bool bAnimFile;     // Skeletal animation file
   bool bVtxAnim;      // Vertex animation file
   bool bOnlySkeleton; // Skeleton file
+  bool bSkeletonPose; // First frame is the default pose of the model skeleton
 
   // Default constructor
   SmdStructure(void) {
     iBones = 0;
     iFrames = 0;
+    fWeldEpsilon = 0.0;
+    bVertexCache = false;
+    iMemoryLimit = 0;
     bAnimFile = true;
     bVtxAnim = false;
     bOnlySkeleton = false;
+    bSkeletonPose = false;
+  };
+
+  // Animation keys that fit into the memory limit (0 for no limit)
+  inline u64 GetMaxKeys(void) const {
+    if (iMemoryLimit == 0) {
+      return 0;
+    }
+
+    // Keys of the first frame are always kept
+    const u64 ctMaxKeys = iMemoryLimit / (SMD_PARSED_BYTES + SMD_TRACK_BYTES);
+    return (ctMaxKeys < (u64)iBones ? (u64)iBones : ctMaxKeys);
   };
 
   // Clear the structure
   void Clear(void) {
+    strFilePath = "";
+    strFileName = "";
+
     aSkeleton.clear();
     iBones = 0;
 
-    aFrames.clear();
+    aTracks.Clear();
     iFrames = 0;
 
     aVertices.clear();
     aSurfaces.clear();
+    aVertexWeights.clear();
+    fWeldEpsilon = 0.0;
+    bVertexCache = false;
+    iMemoryLimit = 0;
+    spill.Clear();
 
     bAnimFile = true;
     bVtxAnim = false;
     bOnlySkeleton = false;
+    bSkeletonPose = false;
+  };
+};
+
+// Default skeleton pose from the base SMD model of animations
+class CBaseSkeleton {
+  public:
+    CBones aSkeleton;  // Bones without vertex weights
+    CPlacements aPose; // Bone placements from the first frame
+
+  private:
+    // Not copyable because it's shared between conversions
+    CBaseSkeleton(const CBaseSkeleton &);
+    CBaseSkeleton &operator=(const CBaseSkeleton &);
+
+  public:
+    CBaseSkeleton(void) {};
+
+    // Prepare placements for the current bones
+    void ResetPose(void) {
+      aPose.assign(aSkeleton.size(), CBonePlacement());
+    };
+
+    // Take the skeleton from the first frame of the built SMD file
+    void FromSMD(const SmdStructure &smd) {
+      aSkeleton.clear();
+
+      for (s32 iBone = 0; iBone < smd.iBones; ++iBone) {
+        const CBoneInfo &info = smd.aSkeleton[iBone];
+        aSkeleton.push_back(CBoneInfo(info.iID, info.iParent, info.strName));
+      }
+
+      ResetPose();
+
+      const CAnimTracks &tracks = smd.aTracks;
+
+      for (s32 iBone = 0; iBone < smd.iBones; ++iBone) {
+        const size_t iKey = tracks.FirstKey(iBone);
+        aPose[iBone].vPos = tracks.avPos[iKey];
+        aPose[iBone].vRot = tracks.avRot[iKey];
+      }
+    };
+};
+
+// Animation prepared for writing
+struct SmdAnimation {
+  Str_t strName;
+  f64 fSecPerFrame;
+  s32 ctFrames;    // Frames that are written
+  s32 iFrameStep;  // Frames between the written ones
+  s32 iFirstFrame; // First frame of the tracks that's written
+
+  // Bones with envelopes
+  std::map<s32, const CBoneInfo *> mapBones;
+
+  SmdAnimation(void) : strName(""), fSecPerFrame(0.0), ctFrames(0), iFrameStep(1), iFirstFrame(0)
+  {
   };
 };
 
@@ -269,6 +447,35 @@ struct SmdOptions {
   bool bFixAnimNorth;
   Str_t strBaseSMD;
 
+  // Directory for storing parsed base skeletons between runs
+  Str_t strBaseCache;
+
+  // Store built SMD files between runs in cache files next to them or in a directory
+  bool bSmdCache;
+  Str_t strSmdCache;
+
+  // Threads for converting bone placements (0 for all CPU cores)
+  s32 ctThreads;
+
+  // Tolerance for merging mesh vertices (negative to disable)
+  f64 fWeldEpsilon;
+
+  // Reorder mesh triangles and vertices for the vertex cache
+  bool bVertexCache;
+
+  // Largest position and rotation (in degrees) errors for removing animation frames (negative position to keep all frames)
+  f64 fReducePos;
+  f64 fReduceRot;
+
+  // Largest difference of placement values for omitting bones that don't move (negative to write all bones)
+  f64 fConstEpsilon;
+
+  // Memory for animation frames before moving them into a scratch file (0 for no limit)
+  u64 iMemoryLimit;
+
+  bool bAsciiFiles;  // Write SE1 ASCII files (.am, .as, .aa)
+  bool bBinaryFiles; // Write SE1 binary files (.bm, .bs, .ba)
+
   // Pre-set options
   bool bArgSet[4];
 
@@ -280,6 +487,18 @@ struct SmdOptions {
     bFixFaceDir = false;
     bFixAnimNorth = false;
     strBaseSMD = "";
+    strBaseCache = "";
+    bSmdCache = false;
+    strSmdCache = "";
+    ctThreads = 0;
+    fWeldEpsilon = 0.0;
+    bVertexCache = false;
+    fReducePos = -1.0;
+    fReduceRot = 0.5;
+    fConstEpsilon = -1.0;
+    iMemoryLimit = 0;
+    bAsciiFiles = true;
+    bBinaryFiles = false;
     SetAll(false);
   };
 
@@ -0,0 +1,105 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "SMD_Structures.h"
+
+#include "Common/Trace.h"
+
+// Bytes of one key in the scratch file (frame and XYZHPB values)
+#define SPILL_KEY_VALUES 6
+#define SPILL_KEY_BYTES (sizeof(s32) + SPILL_KEY_VALUES * sizeof(f64))
+
+void CTrackSpill::Clear(void) {
+  file.Close();
+  aiBlockStart.clear();
+  aiBoneKeys.clear();
+  aAnimated.clear();
+};
+
+void CTrackSpill::AddBlock(const Str_t &strFile, const CAnimTracks &block) {
+  TRACE_SCOPE("SpillKeys");
+
+  if (!file.IsOpen()) {
+    file.Create(strFile);
+    aAnimated.assign(block.iBones, false);
+  }
+
+  aiBlockStart.push_back(file.GetSize());
+
+  // Keys of all bones one after another
+  const size_t ctKeys = block.aiFrames.size();
+  std::vector<u8> aKeys(ctKeys * SPILL_KEY_BYTES);
+
+  for (size_t iKey = 0; iKey < ctKeys; ++iKey) {
+    u8 *pKey = &aKeys[iKey * SPILL_KEY_BYTES];
+    const f64 afValues[SPILL_KEY_VALUES] = {
+      block.avPos[iKey][0], block.avPos[iKey][1], block.avPos[iKey][2],
+      block.avRot[iKey][0], block.avRot[iKey][1], block.avRot[iKey][2],
+    };
+
+    memcpy(pKey, &block.aiFrames[iKey], sizeof(s32));
+    memcpy(pKey + sizeof(s32), afValues, sizeof(afValues));
+  }
+
+  for (s32 iBone = 0; iBone < block.iBones; ++iBone) {
+    aiBoneKeys.push_back(block.FirstKey(iBone));
+
+    // Only the first frame of the animation isn't written
+    if (block.EndKey(iBone) != block.FirstKey(iBone) && block.aiFrames[block.EndKey(iBone) - 1] > 0) {
+      aAnimated[iBone] = true;
+    }
+  }
+
+  aiBoneKeys.push_back(ctKeys);
+
+  if (ctKeys != 0) {
+    file.Append(&aKeys[0], aKeys.size());
+  }
+};
+
+void CTrackSpill::LoadBone(s32 iBlock, s32 iBone, CAnimTracks &tracks) {
+  const size_t iBlockKeys = (size_t)iBlock * (aAnimated.size() + 1);
+  const u64 iFirstKey = aiBoneKeys[iBlockKeys + iBone];
+  const size_t ctKeys = (size_t)(aiBoneKeys[iBlockKeys + iBone + 1] - iFirstKey);
+
+  tracks.Reset(1, 0, ctKeys);
+
+  if (ctKeys != 0) {
+    std::vector<u8> aKeys(ctKeys * SPILL_KEY_BYTES);
+    file.Read(aiBlockStart[iBlock] + iFirstKey * SPILL_KEY_BYTES, &aKeys[0], aKeys.size());
+
+    for (size_t iKey = 0; iKey < ctKeys; ++iKey) {
+      const u8 *pKey = &aKeys[iKey * SPILL_KEY_BYTES];
+      s32 iFrame;
+      f64 afValues[SPILL_KEY_VALUES];
+
+      memcpy(&iFrame, pKey, sizeof(s32));
+      memcpy(afValues, pKey + sizeof(s32), sizeof(afValues));
+
+      tracks.AddKey(iFrame, Vec3D(afValues[0], afValues[1], afValues[2]), Ang3D(afValues[3], afValues[4], afValues[5]));
+    }
+
+    tracks.iFrames = tracks.aiFrames.back() + 1;
+  }
+
+  tracks.EndBone();
+};
@@ -20,9 +20,207 @@
  */
 
 #include "Main.h"
+#include "Manifest.h"
+
+#include "Common/InputFile.h"
+#include "Common/MemoryStats.h"
+#include "Common/NumberFormat.h"
+#include "Common/Trace.h"
+
+#include <ctype.h>
+
+// Batch conversion without any user input
+bool _bBatchMode = false;
+s32 _ctBatchJobThreads = 0;
+
+// Stream buffer that discards everything written into it
+class CNullBuffer : public std::streambuf {
+  protected:
+    virtual int overflow(int iChar) {
+      return traits_type::not_eof(iChar);
+    };
+};
+
+static CNullBuffer _bufNull;
+static std::ostream _strmNull(&_bufNull);
+
+// Console output for conversion messages (muted in batch mode)
+std::ostream &Console(void) {
+  if (_bBatchMode) {
+    return _strmNull;
+  }
+
+  return std::cout;
+};
+
+// Declare converters
+extern void ConvertAnimationSE2(const c8 *pchData, size_t iSize, const CPath &strFile, s32 ctThreads, bool bBatch);
+extern void ConvertSkeletonSE2(const c8 *pchData, size_t iSize, const CPath &strFile);
+extern void ConvertSkeletonSE1(const c8 *pchData, size_t iSize, const CPath &strFile);
+extern bool ConvertSourceMesh(const CPath &strFile, bool bVtxAnimation, Strings_t &aArguments);
+
+// Convert one file using the converter for its format
+bool ConvertFile(const CPath &strFile, Strings_t &aArguments) {
+  TRACE_SCOPE_DETAIL("ConvertFile", strFile);
+
+  Str_t strExt = strFile.GetFileExt();
+
+  // Invalid format
+  if (strExt == "") {
+    throw CMessageException("Unknown file extension");
+  }
+
+  // Extensions are case-insensitive
+  for (size_t iChar = 0; iChar < strExt.size(); ++iChar) {
+    strExt[iChar] = (c8)tolower((u8)strExt[iChar]);
+  }
+
+  // Valve SMD files are read by the converter itself
+  if (strExt == ".smd" || strExt == ".vta") {
+    return ConvertSourceMesh(strFile, (strExt == ".vta"), aArguments);
+  }
+
+  // Invalid format
+  if (strExt != ".aaf" && strExt != ".asf" && strExt != ".as") {
+    CMessageException::Throw("Unrecognized file format (%s)", strExt.c_str());
+  }
+
+  // SE2+ and SE1 ASCII files are read by the converters themselves
+  CInputFile file;
+  {
+    TRACE_SCOPE("ReadFile");
+    file.Open(strFile);
+  }
+
+  // Threads for converting envelopes (all CPU cores by default)
+  s32 ctThreads = 0;
+
+  // Convert envelope placements in vectorized batches instead of using the utilities
+  bool bBatchEnvelopes = false;
+
+  for (size_t iArg = 0; iArg < aArguments.size(); ++iArg) {
+    if (aArguments[iArg] == "-threads" && iArg + 1 < aArguments.size()) {
+      ctThreads = atoi(aArguments[iArg + 1].c_str());
+      ctThreads = (ctThreads < 1 ? 1 : ctThreads);
+
+    } else if (aArguments[iArg] == "-fastenvelopes") {
+      bBatchEnvelopes = true;
+    }
+  }
+
+  // Files are already converted in parallel
+  if (_ctBatchJobThreads > 0) {
+    ctThreads = _ctBatchJobThreads;
+  }
+
+  // Converted file that's already up to date
+  const Str_t strOutput = strFile.RemoveExt() + (strExt == ".aaf" ? ".aa" : (strExt == ".asf" ? ".as" : ".asf"));
+  u64 iFingerprint = 0;
+
+  if (_bManifest) {
+    CFingerprint fp(strExt.c_str());
+    fp.AddData(file.GetData(), file.GetSize());
+    fp.AddInteger(strExt == ".aaf" && bBatchEnvelopes);
+    iFingerprint = fp.Get();
+
+    if (IsConversionUpToDate(strFile, iFingerprint)) {
+      Console() << "Converted file is up to date\n";
+      return false;
+    }
+  }
+
+  // SE2+ ASCII animation
+  if (strExt == ".aaf") {
+    ConvertAnimationSE2(file.GetData(), file.GetSize(), strFile, ctThreads, bBatchEnvelopes);
+
+  // SE2+ ASCII skeleton
+  } else if (strExt == ".asf") {
+    ConvertSkeletonSE2(file.GetData(), file.GetSize(), strFile);
+
+  // SE1 ASCII skeleton
+  } else {
+    ConvertSkeletonSE1(file.GetData(), file.GetSize(), strFile);
+  }
+
+  if (_bManifest) {
+    RecordConversion(strFile, iFingerprint, Strings_t(1, strOutput));
+  }
+
+  return true;
+};
+
+#if CONVERTER_MAIN
+
+// Set precision of numbers in output files
+static bool SetOutputPrecision(const Str_t &strPrecision) {
+  // Shortest representation that reads back as the same number
+  if (strPrecision == "shortest") {
+    _iFloatDigits = FLOAT_DIGITS_SHORTEST;
+    return true;
+  }
+
+  const s32 iDigits = atoi(strPrecision.c_str());
+
+  if (iDigits < 1 || iDigits > 17) {
+    return false;
+  }
+
+  _iFloatDigits = iDigits;
+  return true;
+};
 
 // Entry point
 int main(int iArgs, c8 *astrArgs[]) {
+  // Output precision is the same for all files
+  for (s32 iPrecisionArg = 1; iPrecisionArg < iArgs - 1; ++iPrecisionArg) {
+    if (Str_t(astrArgs[iPrecisionArg]) != "-precision") {
+      continue;
+    }
+
+    if (!SetOutputPrecision(astrArgs[iPrecisionArg + 1])) {
+      std::cout << "Error: Precision should be 1-17 significant digits or 'shortest'\n";
+      return 1;
+    }
+  }
+
+  // Record time spent in each conversion stage
+  for (s32 iTraceArg = 1; iTraceArg < iArgs - 1; ++iTraceArg) {
+    if (Str_t(astrArgs[iTraceArg]) == "-trace") {
+      StartTrace(astrArgs[iTraceArg + 1]);
+    }
+  }
+
+  // Count allocations and sizes of data structures in each conversion stage
+  for (s32 iMemoryArg = 1; iMemoryArg < iArgs - 1; ++iMemoryArg) {
+    if (Str_t(astrArgs[iMemoryArg]) == "-memstats") {
+      StartMemoryStats(astrArgs[iMemoryArg + 1]);
+    }
+  }
+
+  // Skip conversions that have already been done with the same inputs
+  for (s32 iManifestArg = 1; iManifestArg < iArgs - 1; ++iManifestArg) {
+    if (Str_t(astrArgs[iManifestArg]) == "-manifest") {
+      LoadManifest(astrArgs[iManifestArg + 1]);
+    }
+  }
+
+  // Convert multiple files without any user input
+  if (iArgs > 1 && Str_t(astrArgs[1]) == "-batch") {
+    Strings_t aBatchArgs;
+
+    for (s32 iArg = 2; iArg < iArgs; ++iArg) {
+      aBatchArgs.push_back(astrArgs[iArg]);
+    }
+
+    extern s32 ConvertBatch(const Strings_t &aArguments);
+    const s32 iResult = ConvertBatch(aBatchArgs);
+
+    SaveManifest();
+    FinishTrace();
+    FinishMemoryStats();
+    return iResult;
+  }
+
   // Display opened file
   if (iArgs > 1) {
     std::cout << astrArgs[1] << "\n\n";
@@ -39,66 +237,20 @@ int main(int iArgs, c8 *astrArgs[]) {
     return 0;
   }
 
-  // Read animation file
-  CPath strFile = astrArgs[1];
-  Str_t strASCII = ReadTextFile(strFile);
-
-  // Declare converters
-  extern void ConvertAnimationSE2(CTokenList &aTokens, const CPath &strFile);
-  extern void ConvertSkeletonSE2(CTokenList &aTokens, const CPath &strFile, Str_t strSkeleton);
-  extern void ConvertSkeletonSE1(CTokenList &aTokens, const CPath &strFile, Str_t strSkeleton);
-  extern void ConvertSourceMesh(const CPath &strFile, bool bVtxAnimation, Strings_t &aArguments);
-
   try {
-    Str_t strExt = strFile.GetFileExt();
-    CTokenList aTokens;
-
-    // Invalid format
-    if (strExt == "") {
-      throw CMessageException("Unknown file extension");
-    }
-
-    // SE2+ ASCII animation
-    if (strExt == ".aaf") {
-      // Tokenize ASCII file
-      TokenizeString(aTokens, strASCII);
-
-      // Convert animation
-      ConvertAnimationSE2(aTokens, strFile);
-
-    // SE2+ ASCII skeleton
-    } else if (strExt == ".asf") {
-      // Tokenize ASCII file
-      TokenizeString(aTokens, strASCII);
-
-      // Convert skeleton
-      ConvertSkeletonSE2(aTokens, strFile, strASCII);
-
-    // SE1 ASCII skeleton
-    } else if (strExt == ".as") {
-      // Tokenize ASCII file
-      TokenizeString(aTokens, strASCII);
-
-      // Convert skeleton
-      ConvertSkeletonSE1(aTokens, strFile, strASCII);
-
-    // Valve SMD model
-    } else if (strExt == ".smd") {
-      ConvertSourceMesh(strFile, false, aArguments);
-
-    // Valve SMD vertex animation
-    } else if (strExt == ".vta") {
-      ConvertSourceMesh(strFile, true, aArguments);
-    
-    // Invalid format
-    } else {
-      CMessageException::Throw("Unrecognized file format (%s)", strExt.c_str());
-    }
+    ConvertFile(astrArgs[1], aArguments);
 
   } catch (CException &ex) {
     std::cout << "Error: " << ex.What() << '\n';
   }
 
+  // Keep the trace of failed conversions as well
+  SaveManifest();
+  FinishTrace();
+  FinishMemoryStats();
+
   getchar();
   return 0;
 };
+
+#endif // CONVERTER_MAIN
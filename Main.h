@@ -47,3 +47,20 @@
 #include <iostream>
 
 using namespace dreamy;
+
+// Entry point of the converter (disabled by other executables that are built from its sources)
+#ifndef CONVERTER_MAIN
+#define CONVERTER_MAIN 1
+#endif
+
+// Batch conversion without any user input
+extern bool _bBatchMode;
+
+// Threads that each file in batch mode may use for its own conversion regardless of its options (0 for no limit)
+extern s32 _ctBatchJobThreads;
+
+// Console output for conversion messages (muted in batch mode)
+std::ostream &Console(void);
+
+// Convert one file using the converter for its format (returns false if converted files are already up to date)
+bool ConvertFile(const CPath &strFile, Strings_t &aArguments);
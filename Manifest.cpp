@@ -0,0 +1,368 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Main.h"
+#include "Manifest.h"
+
+#include "Common/FileSystem.h"
+#include "Common/InputFile.h"
+#include "Common/NumberFormat.h"
+#include "Common/OutputFile.h"
+#include "Common/Trace.h"
+
+// Manifest file format
+// Every line is a conversion: fingerprint, input file, then size, modification time and path of each output file (separated by tabs)
+#define MANIFEST_HEADER "SKAMANIFEST 1"
+
+// Changes together with converters to redo all conversions made by older versions
+#define MANIFEST_VERSION 1
+
+bool _bManifest = false;
+
+// Output file as it was after the conversion
+struct ManifestOutput {
+  Str_t strFile;
+  u64 iSize;
+  u64 iModified;
+};
+
+// Last conversion of an input file
+struct ManifestEntry {
+  u64 iFingerprint;
+  std::vector<ManifestOutput> aOutputs;
+};
+
+typedef std::map<Str_t, ManifestEntry> ManifestEntries_t;
+
+static Str_t _strManifest;
+static ManifestEntries_t _mapManifest;
+static bool _bManifestChanged = false;
+static CMutex _mxManifest;
+
+// Add 8 bytes to the hash
+static inline u64 MixFingerprint(u64 iHash, u64 iWord) {
+  iHash ^= iWord * U64_C(0x9E3779B97F4A7C15);
+  iHash = (iHash << 31) | (iHash >> 33);
+  return iHash * U64_C(0xBF58476D1CE4E5B9);
+};
+
+CFingerprint::CFingerprint(const c8 *strConverter) : _iHash(MANIFEST_VERSION) {
+  AddString(strConverter);
+  AddInteger((u64)(s64)_iFloatDigits);
+};
+
+void CFingerprint::AddData(const void *pData, size_t iSize) {
+  const u8 *pBytes = (const u8 *)pData;
+  size_t iOffset = 0;
+
+  for (; iOffset + 8 <= iSize; iOffset += 8) {
+    u64 iWord;
+    memcpy(&iWord, pBytes + iOffset, 8);
+    _iHash = MixFingerprint(_iHash, iWord);
+  }
+
+  // Pad the rest with zeros
+  u64 iLast = 0;
+  memcpy(&iLast, pBytes + iOffset, iSize - iOffset);
+
+  _iHash = MixFingerprint(_iHash, iLast);
+  _iHash = MixFingerprint(_iHash, (u64)iSize);
+};
+
+void CFingerprint::AddString(const Str_t &str) {
+  AddData(str.c_str(), str.size());
+};
+
+void CFingerprint::AddInteger(u64 iValue) {
+  _iHash = MixFingerprint(_iHash, iValue);
+};
+
+void CFingerprint::AddNumber(f64 fValue) {
+  u64 iBits;
+  memcpy(&iBits, &fValue, sizeof(iBits));
+  _iHash = MixFingerprint(_iHash, iBits);
+};
+
+void CFingerprint::AddFile(const Str_t &strFile) {
+  CInputFile file;
+
+  if (!file.TryOpen(strFile)) {
+    AddInteger(0);
+    return;
+  }
+
+  AddInteger(1);
+  AddData(file.GetData(), file.GetSize());
+};
+
+// Write number in hexadecimal
+static void AppendHex(Str_t &str, u64 iValue) {
+  static const c8 *strDigits = "0123456789abcdef";
+
+  for (s32 iShift = 60; iShift >= 0; iShift -= 4) {
+    str += strDigits[(iValue >> iShift) & 0xF];
+  }
+};
+
+// Read number in hexadecimal (returns false if there are other characters)
+static bool ParseHex(const Str_t &str, u64 &iValue) {
+  if (str.empty() || str.size() > 16) {
+    return false;
+  }
+
+  iValue = 0;
+
+  for (size_t iChar = 0; iChar < str.size(); ++iChar) {
+    const c8 ch = str[iChar];
+    u64 iDigit;
+
+    if (ch >= '0' && ch <= '9') {
+      iDigit = ch - '0';
+    } else if (ch >= 'a' && ch <= 'f') {
+      iDigit = ch - 'a' + 10;
+    } else {
+      return false;
+    }
+
+    iValue = (iValue << 4) | iDigit;
+  }
+
+  return true;
+};
+
+// Split line into values separated by tabs
+static void SplitManifestLine(const c8 *pchLine, const c8 *pchEnd, Strings_t &aValues) {
+  aValues.clear();
+
+  while (true) {
+    const c8 *pchTab = pchLine;
+
+    while (pchTab != pchEnd && *pchTab != '\t') {
+      ++pchTab;
+    }
+
+    aValues.push_back(Str_t(pchLine, pchTab));
+
+    if (pchTab == pchEnd) {
+      break;
+    }
+
+    pchLine = pchTab + 1;
+  }
+};
+
+// Parse one conversion from the manifest (returns false if it's malformed)
+static bool ParseManifestEntry(const Strings_t &aValues, Str_t &strInput, ManifestEntry &entry) {
+  if (aValues.size() < 2 || (aValues.size() - 2) % 3 != 0 || !ParseHex(aValues[0], entry.iFingerprint)) {
+    return false;
+  }
+
+  strInput = aValues[1];
+  entry.aOutputs.resize((aValues.size() - 2) / 3);
+
+  for (size_t iOutput = 0; iOutput < entry.aOutputs.size(); ++iOutput) {
+    ManifestOutput &output = entry.aOutputs[iOutput];
+    const size_t iValue = 2 + iOutput * 3;
+
+    if (!ParseHex(aValues[iValue], output.iSize) || !ParseHex(aValues[iValue + 1], output.iModified)) {
+      return false;
+    }
+
+    output.strFile = aValues[iValue + 2];
+  }
+
+  return true;
+};
+
+void LoadManifest(const Str_t &strFile) {
+  TRACE_SCOPE("LoadManifest");
+
+  CMutexLock lock(_mxManifest);
+
+  _bManifest = true;
+  _strManifest = strFile;
+  _mapManifest.clear();
+  _bManifestChanged = false;
+
+  // Existing files are only replaced if the conversion changes their contents
+  _bKeepUnchangedFiles = true;
+
+  // Nothing has been converted yet
+  CInputFile file;
+
+  if (!file.TryOpen(strFile)) {
+    return;
+  }
+
+  const c8 *pchData = file.GetData();
+  const c8 *pchEnd = pchData + file.GetSize();
+
+  Strings_t aValues;
+  bool bHeader = true;
+
+  while (pchData < pchEnd) {
+    const c8 *pchLine = pchData;
+
+    while (pchData < pchEnd && *pchData != '\n') {
+      ++pchData;
+    }
+
+    const c8 *pchLineEnd = pchData;
+    ++pchData;
+
+    if (pchLineEnd != pchLine && pchLineEnd[-1] == '\r') {
+      --pchLineEnd;
+    }
+
+    // Manifest from another version is ignored entirely
+    if (bHeader) {
+      if (Str_t(pchLine, pchLineEnd) != MANIFEST_HEADER) {
+        _bManifestChanged = true;
+        return;
+      }
+
+      bHeader = false;
+      continue;
+    }
+
+    if (pchLine == pchLineEnd) {
+      continue;
+    }
+
+    SplitManifestLine(pchLine, pchLineEnd, aValues);
+
+    Str_t strInput;
+    ManifestEntry entry;
+
+    // Broken conversions will simply be redone
+    if (ParseManifestEntry(aValues, strInput, entry)) {
+      _mapManifest[strInput] = entry;
+    } else {
+      _bManifestChanged = true;
+    }
+  }
+};
+
+void SaveManifest(void) {
+  CMutexLock lock(_mxManifest);
+
+  if (!_bManifest || !_bManifestChanged) {
+    return;
+  }
+
+  TRACE_SCOPE("SaveManifest");
+
+  // Replace the manifest only after it has been written completely
+  const Str_t strTemp = _strManifest + ".tmp";
+
+  try {
+    COutputFile file;
+    file.Open(strTemp);
+    file << MANIFEST_HEADER << '\n';
+
+    Str_t strLine;
+    ManifestEntries_t::const_iterator it;
+
+    for (it = _mapManifest.begin(); it != _mapManifest.end(); ++it) {
+      const ManifestEntry &entry = it->second;
+
+      strLine.clear();
+      AppendHex(strLine, entry.iFingerprint);
+      strLine += '\t';
+      strLine += it->first;
+
+      for (size_t iOutput = 0; iOutput < entry.aOutputs.size(); ++iOutput) {
+        const ManifestOutput &output = entry.aOutputs[iOutput];
+
+        strLine += '\t';
+        AppendHex(strLine, output.iSize);
+        strLine += '\t';
+        AppendHex(strLine, output.iModified);
+        strLine += '\t';
+        strLine += output.strFile;
+      }
+
+      file << strLine << '\n';
+    }
+
+    file.Close();
+
+  } catch (CException &ex) {
+    std::cout << "Cannot save manifest: " << ex.What() << '\n';
+    remove(strTemp.c_str());
+    return;
+  }
+
+  remove(_strManifest.c_str());
+  rename(strTemp.c_str(), _strManifest.c_str());
+
+  _bManifestChanged = false;
+};
+
+bool IsConversionUpToDate(const Str_t &strFile, u64 iFingerprint) {
+  CMutexLock lock(_mxManifest);
+
+  ManifestEntries_t::const_iterator it = _mapManifest.find(GetCanonicalPath(strFile));
+
+  if (it == _mapManifest.end() || it->second.iFingerprint != iFingerprint) {
+    return false;
+  }
+
+  // Output files should be exactly as they were left
+  const std::vector<ManifestOutput> &aOutputs = it->second.aOutputs;
+
+  for (size_t iOutput = 0; iOutput < aOutputs.size(); ++iOutput) {
+    const ManifestOutput &output = aOutputs[iOutput];
+    FileInfo info;
+
+    if (!GetFileInfo(output.strFile, info) || info.bDir || info.iSize != output.iSize || info.iModified != output.iModified) {
+      return false;
+    }
+  }
+
+  return true;
+};
+
+void RecordConversion(const Str_t &strFile, u64 iFingerprint, const Strings_t &aOutputs) {
+  ManifestEntry entry;
+  entry.iFingerprint = iFingerprint;
+
+  for (size_t iOutput = 0; iOutput < aOutputs.size(); ++iOutput) {
+    FileInfo info;
+
+    // Conversion without all of its outputs will be redone
+    if (!GetFileInfo(aOutputs[iOutput], info)) {
+      return;
+    }
+
+    ManifestOutput output;
+    output.strFile = GetCanonicalPath(aOutputs[iOutput]);
+    output.iSize = info.iSize;
+    output.iModified = info.iModified;
+    entry.aOutputs.push_back(output);
+  }
+
+  const Str_t strInput = GetCanonicalPath(strFile);
+
+  CMutexLock lock(_mxManifest);
+  _mapManifest[strInput] = entry;
+  _bManifestChanged = true;
+};
@@ -0,0 +1,68 @@
+/* Copyright (c) 2023 Dreamy Cecil
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MANIFEST_H
+#define _MANIFEST_H
+
+#include "Common/Platform.h"
+
+// Skipping of conversions that have been done with the same inputs (only when a manifest file is specified)
+extern bool _bManifest;
+
+// Load fingerprints of previous conversions from the file
+void LoadManifest(const Str_t &strFile);
+
+// Write fingerprints of all conversions back into the file if anything has changed
+void SaveManifest(void);
+
+// Hash of everything that affects the result of a conversion
+class CFingerprint {
+  private:
+    u64 _iHash;
+
+  public:
+    // Starts from the converter name and settings that are the same for every file
+    CFingerprint(const c8 *strConverter);
+
+    // Add raw bytes
+    void AddData(const void *pData, size_t iSize);
+
+    // Add text together with its length
+    void AddString(const Str_t &str);
+
+    void AddInteger(u64 iValue);
+    void AddNumber(f64 fValue);
+
+    // Add contents of the file (or the fact that it's missing)
+    void AddFile(const Str_t &strFile);
+
+    inline u64 Get(void) const {
+      return _iHash;
+    };
+};
+
+// Check if the file has already been converted with the same fingerprint and none of its outputs have been touched since
+bool IsConversionUpToDate(const Str_t &strFile, u64 iFingerprint);
+
+// Remember fingerprint of the converted file together with the files it has produced
+void RecordConversion(const Str_t &strFile, u64 iFingerprint, const Strings_t &aOutputs);
+
+#endif